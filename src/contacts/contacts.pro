@@ -47,6 +47,7 @@ PRIVATE_HEADERS += \
     qcontactdetail_p.h \
     qcontactfetchhint_p.h \
     qcontactfilter_p.h \
+    qcontactfilterprogram_p.h \
     qcontactmanager_p.h \
     qcontactrelationship_p.h \
     qcontactsortorder_p.h \
@@ -67,6 +68,7 @@ SOURCES += \
     qcontactdetail.cpp \
     qcontactfetchhint.cpp \
     qcontactfilter.cpp \
+    qcontactfilterprogram.cpp \
     qcontactid.cpp \
     qcontactmanager_p.cpp \
     qcontactmanager.cpp \
@@ -167,6 +167,7 @@ void QContact::clearDetails()
     contactType.setType(QContactType::TypeContact);
     contactType.d->m_access = QContactDetail::Irremovable;
     d->m_details.insert(0, contactType);
+    d->reindexDetails();
 }
 
 /*! Replace the contents of this QContact with \a other
@@ -312,13 +313,9 @@ QContactDetail QContact::detail(QContactDetail::DetailType type) const
     if (type == QContactDetail::TypeUndefined)
         return d.constData()->m_details.first();
 
-    // build the sub-list of matching details.
-    for (int i = 0; i < d.constData()->m_details.size(); i++) {
-        const QContactDetail& existing = d.constData()->m_details.at(i);
-        if (existing.d->m_type == type) {
-            return existing;
-        }
-    }
+    const QList<int> &positions = d.constData()->detailPositions(type);
+    if (!positions.isEmpty())
+        return d.constData()->m_details.at(positions.first());
 
     return QContactDetail();
 }
@@ -346,12 +343,10 @@ QList<QContactDetail> QContact::details(QContactDetail::DetailType type) const
     if (type == QContactDetail::TypeUndefined) {
         sublist = d.constData()->m_details;
     } else {
-        for (int i = 0; i < d->m_details.size(); i++) {
-            const QContactDetail& existing = d.constData()->m_details.at(i);
-            if (existing.d->m_type == type) {
-                sublist.append(existing);
-            }
-        }
+        const QList<int> &positions = d.constData()->detailPositions(type);
+        sublist.reserve(positions.size());
+        foreach (int position, positions)
+            sublist.append(d.constData()->m_details.at(position));
     }
 
     return sublist;
@@ -387,7 +382,7 @@ bool QContact::appendDetail(const QContactDetail &detail)
         d->m_details[0].d->m_access |= QContactDetail::Irremovable;
         return true;
     }
-    d->m_details.append(detail);
+    d->appendDetail(detail);
     return true;
 }
 
@@ -436,10 +431,9 @@ bool QContact::saveDetail(QContactDetail* detail)
 
     // try to find the "old version" of this field
     // ie, the one with the same type and id, but different value or attributes.
-    for (int i = 0; i < d.constData()->m_details.size(); i++) {
+    foreach (int i, d.constData()->detailPositions(detail->d->m_type)) {
         const QContactDetail& curr = d.constData()->m_details.at(i);
-        if (detail->d->m_type == curr.d->m_type &&
-                detail->d->m_detailId == curr.d->m_detailId) {
+        if (detail->d->m_detailId == curr.d->m_detailId) {
             // update the detail constraints of the supplied detail
             detail->d->m_access = curr.accessConstraints();
             // Found the old version.  Replace it with this one.
@@ -448,7 +442,7 @@ bool QContact::saveDetail(QContactDetail* detail)
         }
     }
     // this is a new detail!  add it to the contact.
-    d->m_details.append(*detail);
+    d->appendDetail(*detail);
     return true;
 }
 
@@ -509,6 +503,7 @@ bool QContact::removeDetail(QContactDetail* detail)
 
     // then remove the detail.
     d->m_details.removeAt(removeIndex);
+    d->reindexDetails();
     return true;
 }
 
@@ -578,6 +573,7 @@ QDataStream& operator>>(QDataStream& in, QContact& contact)
         QList<QContactDetail> details;
         QMap<QString, int> preferences;
         in >> id >> contact.d->m_details >> contact.d->m_preferences;
+        contact.d->reindexDetails();
         contact.setId(id);
     } else {
         in.setStatus(QDataStream::ReadCorruptData);
@@ -808,6 +804,7 @@ void QContactData::removeOnly(QContactDetail::DetailType type)
         else
             ++dit;
     }
+    reindexDetails();
 }
 
 void QContactData::removeOnly(const QSet<QContactDetail::DetailType>& types)
@@ -820,6 +817,21 @@ void QContactData::removeOnly(const QSet<QContactDetail::DetailType>& types)
         else
             ++dit;
     }
+    reindexDetails();
+}
+
+void QContactData::reindexDetails()
+{
+    m_detailPositions.clear();
+    for (int i = 0; i < m_details.size(); ++i)
+        m_detailPositions[m_details.at(i).type()].append(i);
+}
+
+const QList<int> &QContactData::detailPositions(QContactDetail::DetailType type) const
+{
+    static const QList<int> noPositions;
+    QHash<QContactDetail::DetailType, QList<int> >::const_iterator it = m_detailPositions.constFind(type);
+    return it != m_detailPositions.constEnd() ? it.value() : noPositions;
 }
 
 QT_END_NAMESPACE_CONTACTS
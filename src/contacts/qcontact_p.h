@@ -51,6 +51,7 @@
 // We mean it.
 //
 
+#include <QtCore/qhash.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qshareddata.h>
@@ -63,6 +64,46 @@
 
 QT_BEGIN_NAMESPACE_CONTACTS
 
+/*
+    The details of one type in a contact, without copying them.  The view
+    is only valid as long as the contact it came from is not modified.
+*/
+class QContactDetailsView
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator(const QList<QContactDetail> *details, QList<int>::const_iterator position)
+            : m_details(details), m_position(position) {}
+
+        const QContactDetail &operator*() const { return m_details->at(*m_position); }
+        const QContactDetail *operator->() const { return &m_details->at(*m_position); }
+        const_iterator &operator++() { ++m_position; return *this; }
+        bool operator==(const const_iterator &other) const { return m_position == other.m_position; }
+        bool operator!=(const const_iterator &other) const { return m_position != other.m_position; }
+
+    private:
+        const QList<QContactDetail> *m_details;
+        QList<int>::const_iterator m_position;
+    };
+
+    QContactDetailsView(const QList<QContactDetail> &details, const QList<int> &positions)
+        : m_details(&details), m_positions(&positions) {}
+
+    int size() const { return m_positions->size(); }
+    bool isEmpty() const { return m_positions->isEmpty(); }
+    const QContactDetail &at(int i) const { return m_details->at(m_positions->at(i)); }
+    const QContactDetail &first() const { return at(0); }
+
+    const_iterator begin() const { return const_iterator(m_details, m_positions->constBegin()); }
+    const_iterator end() const { return const_iterator(m_details, m_positions->constEnd()); }
+
+private:
+    const QList<QContactDetail> *m_details;
+    const QList<int> *m_positions;
+};
+
 class QContactData : public QSharedData
 {
 public:
@@ -76,6 +117,7 @@ public:
         m_id(other.m_id),
         m_collectionId(other.m_collectionId),
         m_details(other.m_details),
+        m_detailPositions(other.m_detailPositions),
         m_relationshipsCache(other.m_relationshipsCache),
         m_preferences(other.m_preferences)
     {
@@ -86,6 +128,7 @@ public:
     QContactId m_id;
     QContactCollectionId m_collectionId;
     QList<QContactDetail> m_details;
+    QHash<QContactDetail::DetailType, QList<int> > m_detailPositions; // indexes into m_details, by detail type
     QList<QContactRelationship> m_relationshipsCache;
     QMap<QString, int> m_preferences;
 
@@ -93,8 +136,24 @@ public:
     void removeOnly(QContactDetail::DetailType type);
     void removeOnly(const QSet<QContactDetail::DetailType>& types);
 
-    // Trampoline
+    // Detail index maintenance; anything which reorders or removes details must reindex
+    void appendDetail(const QContactDetail &detail)
+    {
+        m_details.append(detail);
+        m_detailPositions[detail.type()].append(m_details.size() - 1);
+    }
+    void reindexDetails();
+
+    // The indexes into m_details of the details with the given type, in order
+    const QList<int> &detailPositions(QContactDetail::DetailType type) const;
+    QContactDetailsView detailsView(QContactDetail::DetailType type) const
+    {
+        return QContactDetailsView(m_details, detailPositions(type));
+    }
+
+    // Trampolines
     static QSharedDataPointer<QContactData>& contactData(QContact& contact) {return contact.d;}
+    static const QContactData *contactData(const QContact &contact) {return contact.d.constData();}
 };
 
 QT_END_NAMESPACE_CONTACTS
@@ -62,6 +62,10 @@ QT_BEGIN_NAMESPACE_CONTACTS
 
 class QContactAction;
 class QContactActionFactory;
+class QContactFilter;
+
+// Checks that a filter of an action contains no action filter, see qcontactmanagerengine.cpp
+bool validateActionFilter(const QContactFilter& filter);
 
 // For now this is a very direct interface, not really designed for extensibility
 class QContactActionManagerPlugin {
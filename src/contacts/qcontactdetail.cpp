@@ -290,11 +290,9 @@ size_t qHash(const QContactDetail &key)
 {
     size_t hash = qHash(QString().setNum(key.type()))
                 + QT_PREPEND_NAMESPACE(qHash)(key.accessConstraints());
-    QMap<int, QVariant> values = key.values();
-    QMap<int, QVariant>::const_iterator it = values.constBegin(), end = values.constEnd();
-    for ( ; it != end; ++it) {
-        hash += QT_PREPEND_NAMESPACE(qHash)(it.key())
-              + QT_PREPEND_NAMESPACE(qHash)(it.value().toString());
+    for (int field = key.nextField(); field != -1; field = key.nextField(field)) {
+        hash += QT_PREPEND_NAMESPACE(qHash)(field)
+              + QT_PREPEND_NAMESPACE(qHash)(key.value(field).toString());
     }
     return hash;
 }
@@ -303,11 +301,8 @@ size_t qHash(const QContactDetail &key)
 QDebug operator<<(QDebug dbg, const QContactDetail& detail)
 {
     dbg.nospace() << "QContactDetail(detailType=" << detail.type() << ", key=" << detail.key();
-    QMap<int, QVariant> fields = detail.values();
-    QMap<int, QVariant>::const_iterator it;
-    for (it = fields.constBegin(); it != fields.constEnd(); ++it) {
-        dbg.nospace() << ", " << it.key() << '=' << it.value();
-    }
+    for (int field = detail.nextField(); field != -1; field = detail.nextField(field))
+        dbg.nospace() << ", " << field << '=' << detail.value(field);
     dbg.nospace() << ')';
     return dbg.maybeSpace();
 }
@@ -447,6 +442,24 @@ QMap<int, QVariant> QContactDetail::values() const
     return d->values();
 }
 
+/*!
+  Returns the first field after the given \a field which values() reports, or -1 if there is none.
+
+  The fields are returned in ascending order, so the values can be visited without building the map
+  returned by values():
+
+  \code
+  for (int field = detail.nextField(); field != -1; field = detail.nextField(field))
+      process(field, detail.value(field));
+  \endcode
+
+  \sa values(), value()
+ */
+int QContactDetail::nextField(int field) const
+{
+    return d->nextField(field);
+}
+
 /*!
   \enum QContactDetail::AccessConstraint
 
@@ -135,6 +135,7 @@ public:
 
     void setValues(const QMap<int, QVariant> &newValues);
     QMap<int, QVariant> values() const;
+    int nextField(int field = -1) const;
     QVariant value(int field) const;
     template <typename T> T value(int field) const {
         return value(field).value<T>();
@@ -59,11 +59,87 @@
 #include <QAtomicInt>
 #include <QSharedData>
 #include <QStringList>
+#include <QVarLengthArray>
 
 #include "qcontactdetail.h"
 
 QT_BEGIN_NAMESPACE_CONTACTS
 
+/*
+    The field values of a detail which are not stored in typed members,
+    kept sorted by field.  Details rarely carry more than a few of these,
+    so lookups are a short binary search and copying a detail does not
+    allocate.
+*/
+class QContactDetailFieldStore
+{
+public:
+    struct Entry {
+        int field;
+        QVariant value;
+    };
+
+    int size() const { return int(m_entries.size()); }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    const Entry &at(int index) const { return m_entries.at(index); }
+
+    const QVariant *find(int field) const
+    {
+        const int index = lowerBound(field);
+        return (index < size() && m_entries.at(index).field == field) ? &m_entries.at(index).value : nullptr;
+    }
+
+    bool contains(int field) const { return find(field) != nullptr; }
+
+    QVariant value(int field) const
+    {
+        const QVariant *found = find(field);
+        return found ? *found : QVariant();
+    }
+
+    void insert(int field, const QVariant &value)
+    {
+        const int index = lowerBound(field);
+        if (index < size() && m_entries.at(index).field == field)
+            m_entries[index].value = value;
+        else
+            m_entries.insert(index, Entry{field, value});
+    }
+
+    bool remove(int field)
+    {
+        const int index = lowerBound(field);
+        if (index == size() || m_entries.at(index).field != field)
+            return false;
+        m_entries.remove(index);
+        return true;
+    }
+
+    // returns the first stored field after the given field, or -1
+    int nextField(int field) const
+    {
+        const int index = lowerBound(field + 1);
+        return index < size() ? m_entries.at(index).field : -1;
+    }
+
+private:
+    int lowerBound(int field) const
+    {
+        int low = 0;
+        int high = size();
+        while (low < high) {
+            const int middle = (low + high) / 2;
+            if (m_entries.at(middle).field < field)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        return low;
+    }
+
+    QVarLengthArray<Entry, 4> m_entries;
+};
+
 class QContactDetailPrivate : public QSharedData
 {
 public:
@@ -80,7 +156,7 @@ public:
     int m_hasValueBitfield; // subclass types must set the hasValue bit for any field value which isn't stored in m_extraData.
 
     // extra field data
-    QMap<int, QVariant> m_extraData;
+    QContactDetailFieldStore m_extraData;
 
     QContactDetailPrivate()
         : m_type(QContactDetail::TypeUndefined)
@@ -119,31 +195,23 @@ public:
             return false;
         }
 
-        const QMap<int, QVariant> &thisValues(values());
-        const QMap<int, QVariant> &otherValues(other.values());
-        int thisSize = thisValues.contains(QContactDetail::FieldProvenance) ? thisValues.size() - 1 : thisValues.size();
-        int otherSize = otherValues.contains(QContactDetail::FieldProvenance) ? otherValues.size() - 1 : otherValues.size();
-        if (thisSize != otherSize)
-            return false;
-
-        QMap<int, QVariant>::const_iterator it = thisValues.constBegin(), end = thisValues.constEnd();
-        QMap<int, QVariant>::const_iterator otherIt;
-        for ( ; it != end; ++it) {
-            if (it.key() == QContactDetail::FieldProvenance)
-                continue;
-            otherIt = otherValues.constFind(it.key());
-            if (otherIt == otherValues.constEnd())
+        // walk both sets of fields in step, ignoring the provenance
+        int field = nextField(-1);
+        int otherField = other.nextField(-1);
+        forever {
+            if (field == QContactDetail::FieldProvenance)
+                field = nextField(field);
+            if (otherField == QContactDetail::FieldProvenance)
+                otherField = other.nextField(otherField);
+            if (field != otherField)
                 return false;
-            if (it.value().canConvert<QList<int> >()) {
-                // QList<int> values must be compared as QList<int> not as QVariant<QList<int> >...
-                if (it.value().value<QList<int> >() != otherIt.value().value<QList<int> >())
-                    return false;
-            } else if (it.value() != otherIt.value()) {
-                // Everything else can be compared directly by value.
+            if (field == -1)
+                return true;
+            if (!valuesEqual(value(field), other.value(otherField)))
                 return false;
-            }
+            field = nextField(field);
+            otherField = other.nextField(otherField);
         }
-        return true;
     }
     bool operator!=(const QContactDetailPrivate& other) const {return !(other == *this);}
 
@@ -163,6 +231,17 @@ public:
         return detail.d.constData();
     }
 
+    static bool valuesEqual(const QVariant &first, const QVariant &second)
+    {
+        const QMetaType intListType = QMetaType::fromType<QList<int> >();
+        if (first.metaType() == intListType || second.metaType() == intListType) {
+            // QList<int> values must be compared as QList<int> not as QVariant<QList<int> >...
+            return first.value<QList<int> >() == second.value<QList<int> >();
+        }
+        // Everything else can be compared directly by value.
+        return first == second;
+    }
+
     // built-in fields hasValue bitfield bit
     enum BuiltinFieldBitfieldBits {
         FieldContextBit = 0,
@@ -244,20 +323,26 @@ public:
         return m_hasValueBitfield == 0 && m_extraData.isEmpty();
     }
 
-    virtual QMap<int, QVariant> values() const {
-        QMap<int, QVariant> retn;
-        if (hasValueBitfieldBitSet(FieldContextBit)) {
-            retn.insert(QContactDetail::FieldContext, QVariant::fromValue<QList<int> >(m_contexts));
-        }
-        if (hasValueBitfieldBitSet(FieldProvenanceBit)) {
-            retn.insert(QContactDetail::FieldProvenance, QVariant::fromValue<QString>(m_provenance));
+    // returns the first field after the given field which values() reports, or -1
+    virtual int nextField(int field) const {
+        int next = m_extraData.nextField(field);
+        if (next > QContactDetail::FieldMaximumUserVisible)
+            next = -1; // neither this nor any later extra field is reported
+        if (field < QContactDetail::FieldContext && hasValueBitfieldBitSet(FieldContextBit)
+                && (next == -1 || next > QContactDetail::FieldContext)) {
+            next = QContactDetail::FieldContext;
         }
-        QMap<int, QVariant>::const_iterator it = m_extraData.constBegin(), end = m_extraData.constEnd();
-        for ( ; it != end; ++it) {
-            if (it.key() <= QContactDetail::FieldMaximumUserVisible) {
-                retn.insert(it.key(), it.value());
-            }
+        if (field < QContactDetail::FieldProvenance && hasValueBitfieldBitSet(FieldProvenanceBit)
+                && (next == -1 || next > QContactDetail::FieldProvenance)) {
+            next = QContactDetail::FieldProvenance;
         }
+        return next;
+    }
+
+    QMap<int, QVariant> values() const {
+        QMap<int, QVariant> retn;
+        for (int field = nextField(-1); field != -1; field = nextField(field))
+            retn.insert(field, value(field));
         return retn;
     }
 
@@ -509,15 +594,13 @@ public:
         return QContactDetailPrivate::hasValue(field);
     }
 
-    QMap<int, QVariant> values() const override
+    int nextField(int field) const override
     {
-        QMap<int, QVariant> retn = QContactDetailPrivate::values();
-        for (int i = 0; i < Subclass::FieldCount; ++i) {
-            if (hasValueBitfieldBitSet(i + BaseFieldOffset)) {
-                retn.insert(i, value(i));
-            }
+        for (int i = field + 1; i < Subclass::FieldCount; ++i) {
+            if (hasValueBitfieldBitSet(i + BaseFieldOffset))
+                return i;
         }
-        return retn;
+        return QContactDetailPrivate::nextField(qMax(field, int(Subclass::FieldCount) - 1));
     }
 
     QVariant value(int field) const override
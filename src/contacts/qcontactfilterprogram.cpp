@@ -0,0 +1,588 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtContacts module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+
+#include "qcontactfilterprogram_p.h"
+
+#include <algorithm>
+
+#include "qcontact_p.h"
+#include "qcontactactiondescriptor.h"
+#include "qcontactactionmanager_p.h"
+#include "qcontactdetails.h"
+#include "qcontactfilters.h"
+#include "qcontactmanagerengine.h"
+
+QT_BEGIN_NAMESPACE_CONTACTS
+
+/*
+    The phone number preprocessing of testFilter() - ignore any non-digits (doesn't perform
+    ITU-T collation).  Engines which index phone numbers use it to agree with the programs.
+*/
+QString QContactFilterProgram::phoneNumberDigits(const QString &input)
+{
+    QString digits;
+    digits.reserve(input.size());
+    for (int i = 0; i < input.size(); i++) {
+        QChar current = input.at(i).toLower();
+        // XXX NOTE: we ignore characters like '+', 'p', 'w', '*' and '#' which may be important.
+        if (current.isDigit())
+            digits.append(current);
+    }
+    return digits;
+}
+
+/* Maps a lower case string onto the ITU-T keypad */
+static QString keypadString(const QString &value)
+{
+    QString keypad;
+    keypad.reserve(value.size());
+    for (int i = 0; i < value.size(); i++) {
+        const QChar current = value.at(i);
+        if (current == QLatin1Char('a') || current == QLatin1Char('b') || current == QLatin1Char('c'))
+            keypad.append(QLatin1Char('2'));
+        else if (current == QLatin1Char('d') || current == QLatin1Char('e') || current == QLatin1Char('f'))
+            keypad.append(QLatin1Char('3'));
+        else if (current == QLatin1Char('g') || current == QLatin1Char('h') || current == QLatin1Char('i'))
+            keypad.append(QLatin1Char('4'));
+        else if (current == QLatin1Char('j') || current == QLatin1Char('k') || current == QLatin1Char('l'))
+            keypad.append(QLatin1Char('5'));
+        else if (current == QLatin1Char('m') || current == QLatin1Char('n') || current == QLatin1Char('o'))
+            keypad.append(QLatin1Char('6'));
+        else if (current == QLatin1Char('p') || current == QLatin1Char('q') || current == QLatin1Char('r') || current == QLatin1Char('s'))
+            keypad.append(QLatin1Char('7'));
+        else if (current == QLatin1Char('t') || current == QLatin1Char('u') || current == QLatin1Char('v'))
+            keypad.append(QLatin1Char('8'));
+        else if (current == QLatin1Char('w') || current == QLatin1Char('x') || current == QLatin1Char('y') || current == QLatin1Char('z'))
+            keypad.append(QLatin1Char('9'));
+        else
+            keypad.append(current);
+    }
+    return keypad;
+}
+
+/* The phone number and keypad match types; a match type which requires nothing always passes */
+static bool matchesByType(int matchType, const QString &value, const QString &input)
+{
+    switch (matchType) {
+    case QContactFilter::MatchExactly:
+        return value == input;
+    case QContactFilter::MatchContains:
+        return value.contains(input);
+    case QContactFilter::MatchStartsWith:
+        return value.startsWith(input);
+    case QContactFilter::MatchEndsWith:
+        return value.endsWith(input);
+    default:
+        return true;
+    }
+}
+
+/* String comparison against an operand which was already case folded for case insensitive matching */
+static inline int compareToOperand(const QString &value, const QString &operand, Qt::CaseSensitivity sensitivity)
+{
+    if (sensitivity == Qt::CaseSensitive)
+        return value.localeAwareCompare(operand);
+    return value.toCaseFolded().localeAwareCompare(operand);
+}
+
+/*
+    Constructs a program which matches every contact, like a default
+    constructed QContactFilter.
+*/
+QContactFilterProgram::QContactFilterProgram()
+{
+    m_root = addConstant(true);
+}
+
+/*
+    Compiles \a filter into a program.
+*/
+QContactFilterProgram::QContactFilterProgram(const QContactFilter &filter)
+{
+    m_root = compile(filter);
+}
+
+/*
+    Returns true if \a contact matches the compiled filter.
+*/
+bool QContactFilterProgram::matches(const QContact &contact) const
+{
+    return evaluate(m_root, contact);
+}
+
+/*
+    Returns true if the compiled filter matches any contact without looking at it.
+*/
+bool QContactFilterProgram::matchesAll() const
+{
+    return m_nodes.at(m_root).operation == MatchAll;
+}
+
+/*
+    Returns true if the compiled filter cannot match any contact.
+*/
+bool QContactFilterProgram::matchesNone() const
+{
+    return m_nodes.at(m_root).operation == MatchNone;
+}
+
+int QContactFilterProgram::addNode(const Node &node)
+{
+    m_nodes.append(node);
+    return m_nodes.size() - 1;
+}
+
+int QContactFilterProgram::addConstant(bool value)
+{
+    Node node;
+    node.operation = value ? MatchAll : MatchNone;
+    return addNode(node);
+}
+
+int QContactFilterProgram::compile(const QContactFilter &filter)
+{
+    switch (filter.type()) {
+    case QContactFilter::InvalidFilter:
+        return addConstant(false);
+
+    case QContactFilter::DefaultFilter:
+        return addConstant(true);
+
+    case QContactFilter::IdFilter:
+        {
+            const QContactIdFilter idf(filter);
+            Node node;
+            node.operation = MatchIds;
+            const QList<QContactId> ids = idf.ids();
+            node.ids = QSet<QContactId>(ids.constBegin(), ids.constEnd());
+            if (node.ids.isEmpty())
+                return addConstant(false);
+            node.cost = 1;
+            return addNode(node);
+        }
+
+    case QContactFilter::ContactDetailFilter:
+        return compileDetailFilter(filter);
+
+    case QContactFilter::ContactDetailRangeFilter:
+        return compileRangeFilter(filter);
+
+    case QContactFilter::RelationshipFilter:
+        {
+            const QContactRelationshipFilter rf(filter);
+            Node node;
+            node.operation = MatchRelationship;
+            node.relatedId = rf.relatedContactId();
+            node.role = rf.relatedContactRole();
+            node.relationshipType = rf.relationshipType();
+            node.cost = 9;
+            return addNode(node);
+        }
+
+    case QContactFilter::ChangeLogFilter:
+        {
+            const QContactChangeLogFilter ccf(filter);
+            // You can't emulate a removed..
+            if (ccf.eventType() != QContactChangeLogFilter::EventAdded
+                    && ccf.eventType() != QContactChangeLogFilter::EventChanged) {
+                return addConstant(false);
+            }
+            Node node;
+            node.operation = MatchChangeLog;
+            node.eventType = ccf.eventType();
+            node.since = ccf.since();
+            node.cost = 3;
+            return addNode(node);
+        }
+
+    case QContactFilter::ActionFilter:
+        {
+            // Resolve the actions once, and do a union filter on their filter objects.
+            // A descriptor with an invalid filter ends the union, as testFilter() gives
+            // up at that point.
+            const QContactActionFilter af(filter);
+            const QList<QContactActionDescriptor> descriptors = QContactActionManager::instance()->actionDescriptors(af.actionName());
+            QList<QContactFilter> terms;
+            for (int j = 0; j < descriptors.count(); j++) {
+                const QContactFilter d = descriptors.at(j).contactFilter();
+                if (!validateActionFilter(d))
+                    break;
+                terms.append(d);
+            }
+            return compileComposite(MatchUnion, terms);
+        }
+
+    case QContactFilter::IntersectionFilter:
+        return compileComposite(MatchIntersection, QContactIntersectionFilter(filter).filters());
+
+    case QContactFilter::UnionFilter:
+        return compileComposite(MatchUnion, QContactUnionFilter(filter).filters());
+
+    case QContactFilter::CollectionFilter:
+        {
+            const QContactCollectionFilter cf(filter);
+            Node node;
+            node.operation = MatchCollections;
+            node.collectionIds = cf.collectionIds();
+            if (node.collectionIds.isEmpty())
+                return addConstant(false);
+            node.cost = 1;
+            return addNode(node);
+        }
+    }
+
+    return addConstant(false);
+}
+
+int QContactFilterProgram::compileDetailFilter(const QContactFilter &filter)
+{
+    const QContactDetailFilter cdf(filter);
+    if (cdf.detailType() == QContactDetail::TypeUndefined)
+        return addConstant(false);
+
+    Node node;
+    node.detailType = cdf.detailType();
+    node.field = cdf.detailField();
+    node.visibleField = node.field <= QContactDetail::FieldMaximumUserVisible;
+
+    /* See if we need to check the values */
+    if (node.field == -1) {
+        node.operation = MatchDetailPresence;
+        node.cost = 2;
+        return addNode(node);
+    }
+
+    if (!cdf.value().isValid()) {
+        node.operation = MatchFieldPresence;
+        node.cost = 3;
+        return addNode(node);
+    }
+
+    const QContactFilter::MatchFlags flags = cdf.matchFlags();
+    node.matchType = flags & 7;
+    node.caseSensitivity = (flags & QContactFilter::MatchCaseSensitive) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    if (flags & QContactFilter::MatchPhoneNumber) {
+        node.operation = MatchPhoneNumber;
+        node.needle = phoneNumberDigits(cdf.value().toString());
+        node.rawNeedle = node.needle.right(7);
+        node.cost = 8;
+    } else if (flags & QContactFilter::MatchKeypadCollation) {
+        node.operation = MatchKeypad;
+        node.needle = cdf.value().toString();
+        node.cost = 8;
+    } else if (flags & (QContactFilter::MatchEndsWith | QContactFilter::MatchStartsWith | QContactFilter::MatchContains | QContactFilter::MatchFixedString)) {
+        node.operation = MatchString;
+        node.rawNeedle = cdf.value().toString();
+        node.needle = node.caseSensitivity == Qt::CaseSensitive ? node.rawNeedle : node.rawNeedle.toCaseFolded();
+        node.cost = 6;
+    } else {
+        node.operation = MatchVariant;
+        node.value = cdf.value();
+        node.cost = 4;
+    }
+    return addNode(node);
+}
+
+int QContactFilterProgram::compileRangeFilter(const QContactFilter &filter)
+{
+    /* The only supported flags are: MatchExactly, MatchFixedString, MatchCaseSensitive */
+    const QContactDetailRangeFilter cdf(filter);
+    if (cdf.detailType() == QContactDetail::TypeUndefined)
+        return addConstant(false); /* we do not know which field to check */
+
+    Node node;
+    node.detailType = cdf.detailType();
+    node.field = cdf.detailField();
+    node.visibleField = node.field <= QContactDetail::FieldMaximumUserVisible;
+
+    if (node.field == -1) {
+        node.operation = MatchDetailPresence;
+        node.cost = 2;
+        return addNode(node);
+    }
+
+    if (!cdf.minValue().isValid() && !cdf.maxValue().isValid()) {
+        node.operation = MatchRangeFieldPresence;
+        node.cost = 3;
+        return addNode(node);
+    }
+
+    /* open or closed interval testing support */
+    node.minComp = cdf.rangeFlags() & QContactDetailRangeFilter::ExcludeLower ? 1 : 0;
+    node.maxComp = cdf.rangeFlags() & QContactDetailRangeFilter::IncludeUpper ? 1 : 0;
+    node.caseSensitivity = (cdf.matchFlags() & QContactFilter::MatchCaseSensitive) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    if (cdf.matchFlags() & QContactFilter::MatchFixedString) {
+        node.operation = MatchStringRange;
+        node.minString = cdf.minValue().toString();
+        node.maxString = cdf.maxValue().toString();
+        node.testMin = !node.minString.isEmpty();
+        node.testMax = !node.maxString.isEmpty();
+        if (node.caseSensitivity == Qt::CaseInsensitive) {
+            node.minString = node.minString.toCaseFolded();
+            node.maxString = node.maxString.toCaseFolded();
+        }
+        node.cost = 6;
+    } else {
+        node.operation = MatchVariantRange;
+        node.value = cdf.minValue();
+        node.maxValue = cdf.maxValue();
+        node.testMin = node.value.isValid();
+        node.testMax = node.maxValue.isValid();
+        node.cost = 5;
+    }
+    return addNode(node);
+}
+
+int QContactFilterProgram::compileComposite(Operation operation, const QList<QContactFilter> &terms)
+{
+    const bool intersection = (operation == MatchIntersection);
+    if (terms.isEmpty())
+        return addConstant(false);
+
+    QList<int> children;
+    int cost = 0;
+    foreach (const QContactFilter &term, terms) {
+        const int index = compile(term);
+        const Node &child = m_nodes.at(index);
+
+        /* Fold away the terms which cannot change the result, and stop at one which decides it */
+        if (child.operation == (intersection ? MatchNone : MatchAll))
+            return addConstant(!intersection);
+        if (child.operation == (intersection ? MatchAll : MatchNone))
+            continue;
+
+        cost += child.cost;
+        if (child.operation == operation)
+            children.append(child.children);
+        else
+            children.append(index);
+    }
+
+    if (children.isEmpty())
+        return addConstant(intersection);
+    if (children.size() == 1)
+        return children.first();
+
+    /* Evaluation has no side effects, so the cheapest and most selective terms can go first */
+    std::stable_sort(children.begin(), children.end(), [this](int left, int right) {
+        return m_nodes.at(left).cost < m_nodes.at(right).cost;
+    });
+
+    Node node;
+    node.operation = operation;
+    node.children = children;
+    node.cost = cost;
+    return addNode(node);
+}
+
+bool QContactFilterProgram::evaluate(int index, const QContact &contact) const
+{
+    const Node &node = m_nodes.at(index);
+    switch (node.operation) {
+    case MatchNone:
+        return false;
+
+    case MatchAll:
+        return true;
+
+    case MatchIds:
+        return node.ids.contains(contact.id());
+
+    case MatchCollections:
+        return node.collectionIds.contains(contact.collectionId());
+
+    case MatchIntersection:
+        foreach (int child, node.children) {
+            if (!evaluate(child, contact))
+                return false;
+        }
+        return true;
+
+    case MatchUnion:
+        foreach (int child, node.children) {
+            if (evaluate(child, contact))
+                return true;
+        }
+        return false;
+
+    case MatchRelationship:
+        {
+            // matches any contact that plays the specified role in a relationship
+            // of the specified type with the specified other participant.
+            const QContactId contactId = contact.id();
+            if (node.relatedId == contactId)
+                return false;
+
+            foreach (const QContactRelationship &rel, contact.relationships()) {
+                if (!node.relationshipType.isEmpty() && rel.relationshipType() != node.relationshipType)
+                    continue;
+                if (node.role == QContactRelationship::Second) { // this is the role of the related contact; ie, to match, contact must be the first in the relationship.
+                    if (rel.first() == contactId && (node.relatedId.isNull() || node.relatedId == rel.second()))
+                        return true;
+                } else if (node.role == QContactRelationship::First) { // this is the role of the related contact; ie, to match, contact must be the second in the relationship.
+                    if (rel.second() == contactId && (node.relatedId.isNull() || node.relatedId == rel.first()))
+                        return true;
+                } else { // QContactRelationship::Either
+                    if (node.relatedId.isNull() || node.relatedId == rel.first() || node.relatedId == rel.second())
+                        return true;
+                }
+            }
+            return false;
+        }
+
+    case MatchChangeLog:
+        {
+            const QContactTimestamp ts = contact.detail(QContactTimestamp::Type);
+
+            // See if timestamps are even supported
+            if (ts.isEmpty())
+                return false;
+            if (node.eventType == QContactChangeLogFilter::EventAdded)
+                return node.since <= ts.created();
+            return node.since <= ts.lastModified();
+        }
+
+    default:
+        return evaluateDetails(node, contact);
+    }
+}
+
+bool QContactFilterProgram::evaluateDetails(const Node &node, const QContact &contact) const
+{
+    /* See if this contact has one of these details in it */
+    const QContactDetailsView details = QContactData::contactData(contact)->detailsView(node.detailType);
+    if (details.isEmpty())
+        return false; /* can't match */
+
+    switch (node.operation) {
+    case MatchDetailPresence:
+        return true;
+
+    case MatchFieldPresence:
+    case MatchRangeFieldPresence:
+        for (const QContactDetail &detail : details) {
+            /* Fields which values() does not report never count as present */
+            const bool present = node.visibleField && detail.hasValue(node.field);
+            /* Detail filters also require the field to have a non-empty value */
+            if (present && (node.operation == MatchRangeFieldPresence || !detail.value(node.field).isNull()))
+                return true;
+        }
+        return false;
+
+    case MatchPhoneNumber:
+        for (const QContactDetail &detail : details) {
+            const QString digits = phoneNumberDigits(detail.value(node.field).toString());
+            if (matchesByType(node.matchType, digits, node.needle))
+                return true; // this detail meets all of the criteria which were required, and hence must match.
+
+            // fallback case: default MatchPhoneNumber compares the rightmost 7 digits, ignoring other matchflags.
+            if (digits.right(7) == node.rawNeedle)
+                return true;
+        }
+        return false;
+
+    case MatchKeypad:
+        for (const QContactDetail &detail : details) {
+            const QString keypad = keypadString(detail.value(node.field).toString().toLower());
+            if (matchesByType(node.matchType, keypad, node.needle))
+                return true;
+        }
+        return false;
+
+    case MatchString:
+        for (const QContactDetail &detail : details) {
+            const QString var = detail.value(node.field).toString();
+            if (node.matchType == QContactFilter::MatchStartsWith && var.startsWith(node.rawNeedle, node.caseSensitivity))
+                return true;
+            if (node.matchType == QContactFilter::MatchEndsWith && var.endsWith(node.rawNeedle, node.caseSensitivity))
+                return true;
+            if (node.matchType == QContactFilter::MatchContains && var.contains(node.rawNeedle, node.caseSensitivity))
+                return true;
+            if (compareToOperand(var, node.needle, node.caseSensitivity) == 0)
+                return true;
+        }
+        return false;
+
+    case MatchVariant:
+        for (const QContactDetail &detail : details) {
+            const QVariant var = detail.value(node.field);
+            if (!var.isNull() && QContactManagerEngine::compareVariant(var, node.value, node.caseSensitivity) == 0)
+                return true;
+        }
+        return false;
+
+    case MatchStringRange:
+        for (const QContactDetail &detail : details) {
+            // The detail has to have a field of this type in order to be compared.
+            const QVariant value = detail.value(node.field);
+            if (!value.isValid())
+                continue;
+            // fold the value once for both bounds
+            const QString var = node.caseSensitivity == Qt::CaseSensitive ? value.toString() : value.toString().toCaseFolded();
+            if (node.testMin && var.localeAwareCompare(node.minString) < node.minComp)
+                continue;
+            if (node.testMax && var.localeAwareCompare(node.maxString) >= node.maxComp)
+                continue;
+            return true;
+        }
+        return false;
+
+    case MatchVariantRange:
+        for (const QContactDetail &detail : details) {
+            const QVariant var = detail.value(node.field);
+
+            // The detail has to have a field of this type in order to be compared.
+            if (!var.isValid())
+                continue;
+            if (node.testMin && QContactManagerEngine::compareVariant(var, node.value, node.caseSensitivity) < node.minComp)
+                continue;
+            if (node.testMax && QContactManagerEngine::compareVariant(var, node.maxValue, node.caseSensitivity) >= node.maxComp)
+                continue;
+            return true;
+        }
+        return false;
+
+    default:
+        break;
+    }
+    return false;
+}
+
+QT_END_NAMESPACE_CONTACTS
@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtContacts module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+
+#ifndef QCONTACTFILTERPROGRAM_P_H
+#define QCONTACTFILTERPROGRAM_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+
+#include <QtContacts/qcontact.h>
+#include <QtContacts/qcontactcollectionid.h>
+#include <QtContacts/qcontactdetail.h>
+#include <QtContacts/qcontactfilter.h>
+#include <QtContacts/qcontactid.h>
+#include <QtContacts/qcontactrelationship.h>
+#include <QtContacts/qcontactchangelogfilter.h>
+
+QT_BEGIN_NAMESPACE_CONTACTS
+
+/*
+    A QContactFilter compiled into a flat evaluation plan.
+
+    The filter tree is walked once: wrapper classes are unpacked, the
+    operands are normalised (phone number digits, case folded needles,
+    action descriptors are resolved) and trivially true or false branches
+    are folded away.  The terms of intersections and unions are ordered so
+    that the cheap and most selective tests run first.  matches() gives
+    exactly the same result as QContactManagerEngine::testFilter() for
+    the original filter, so a program can be built once per query and then
+    evaluated against every contact.
+*/
+class Q_CONTACTS_EXPORT QContactFilterProgram
+{
+public:
+    QContactFilterProgram();
+    explicit QContactFilterProgram(const QContactFilter &filter);
+
+    bool matches(const QContact &contact) const;
+
+    bool matchesAll() const;
+    bool matchesNone() const;
+
+    static QString phoneNumberDigits(const QString &input);
+
+private:
+    enum Operation {
+        MatchNone,
+        MatchAll,
+        MatchIds,
+        MatchCollections,
+        MatchDetailPresence,
+        MatchFieldPresence,
+        MatchPhoneNumber,
+        MatchKeypad,
+        MatchString,
+        MatchVariant,
+        MatchRangeFieldPresence,
+        MatchStringRange,
+        MatchVariantRange,
+        MatchRelationship,
+        MatchChangeLog,
+        MatchIntersection,
+        MatchUnion
+    };
+
+    struct Node {
+        Node() : operation(MatchNone), detailType(QContactDetail::TypeUndefined), field(-1),
+                 visibleField(false), matchType(0), caseSensitivity(Qt::CaseInsensitive),
+                 minComp(0), maxComp(0), testMin(false), testMax(false),
+                 role(QContactRelationship::Either), eventType(QContactChangeLogFilter::EventAdded),
+                 cost(0) {}
+
+        Operation operation;
+
+        // detail and range tests
+        QContactDetail::DetailType detailType;
+        int field;
+        bool visibleField;
+        int matchType;
+        Qt::CaseSensitivity caseSensitivity;
+        QString needle;       // normalised string operand (phone digits, keypad input, case folded string)
+        QString rawNeedle;    // string operand as given, or the last seven digits of a phone number
+        QVariant value;       // variant operand, or the minimum of a range
+        QVariant maxValue;
+        QString minString;
+        QString maxString;
+        int minComp;
+        int maxComp;
+        bool testMin;
+        bool testMax;
+
+        // id, collection, relationship and change log tests
+        QSet<QContactId> ids;
+        QSet<QContactCollectionId> collectionIds;
+        QContactId relatedId;
+        QContactRelationship::Role role;
+        QString relationshipType;
+        QDateTime since;
+        QContactChangeLogFilter::EventType eventType;
+
+        // intersections and unions
+        QList<int> children;
+
+        int cost;
+    };
+
+    int compile(const QContactFilter &filter);
+    int compileDetailFilter(const QContactFilter &filter);
+    int compileRangeFilter(const QContactFilter &filter);
+    int compileComposite(Operation operation, const QList<QContactFilter> &terms);
+    int addConstant(bool value);
+    int addNode(const Node &node);
+
+    bool evaluate(int index, const QContact &contact) const;
+    bool evaluateDetails(const Node &node, const QContact &contact) const;
+
+    QList<Node> m_nodes;
+    int m_root;
+};
+
+QT_END_NAMESPACE_CONTACTS
+
+#endif // QCONTACTFILTERPROGRAM_P_H
@@ -39,6 +39,9 @@
 
 #include "qcontactmanagerengine.h"
 
+#include <vector>
+
+#include <QtCore/qcollator.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qpointer.h>
 #include <QtCore/qset.h>
@@ -56,8 +59,6 @@
 
 QT_BEGIN_NAMESPACE_CONTACTS
 
-static bool validateActionFilter(const QContactFilter& filter);
-
 /*!
   \class QContactManagerEngine
   \brief The QContactManagerEngine class provides the interface for
@@ -1288,8 +1289,11 @@ bool QContactManagerEngine::testFilter(const QContactFilter &filter, const QCont
                     for(int j=0; j < details.count(); j++) {
                         const QContactDetail& detail = details.at(j);
 
-                        /* Check that the field is present and has a non-empty value */
-                        if (detail.values().contains(cdf.detailField()) && !detail.value(cdf.detailField()).isNull())
+                        /* Check that the field is present and has a non-empty value.  Fields which
+                           values() does not report never count as present. */
+                        if (cdf.detailField() <= QContactDetail::FieldMaximumUserVisible
+                                && detail.hasValue(cdf.detailField())
+                                && !detail.value(cdf.detailField()).isNull())
                             return true;
                     }
                     return false;
@@ -1449,7 +1453,8 @@ bool QContactManagerEngine::testFilter(const QContactFilter &filter, const QCont
                 if (!cdf.minValue().isValid() && !cdf.maxValue().isValid()) {
                     for(int j=0; j < details.count(); j++) {
                         const QContactDetail& detail = details.at(j);
-                        if (detail.values().contains(cdf.detailField()))
+                        if (cdf.detailField() <= QContactDetail::FieldMaximumUserVisible
+                                && detail.hasValue(cdf.detailField()))
                             return true;
                     }
                     return false;
@@ -1694,8 +1699,8 @@ int QContactManagerEngine::compareContact(const QContact& a, const QContact& b,
         const QContactDetail::DetailType detailType = sortOrder.detailType();
         const int detailField = sortOrder.detailField();
 
-        const QList<QContactDetail> aDetails = a.details(detailType);
-        const QList<QContactDetail> bDetails = b.details(detailType);
+        const QContactDetailsView aDetails = QContactData::contactData(a)->detailsView(detailType);
+        const QContactDetailsView bDetails = QContactData::contactData(b)->detailsView(detailType);
         if (aDetails.isEmpty() && bDetails.isEmpty())
             continue; // use next sort criteria.
 
@@ -1777,16 +1782,276 @@ void QContactManagerEngine::addSorted(QList<QContact>* sorted, const QContact& t
     }
 }
 
+/* The values of one sort order, extracted once per contact so that sorting
+ * doesn't have to look up details and unbox variants in every comparison.
+ * compareAt() gives the same results as compareContact() for a single sort order. */
+class ContactSortColumn
+{
+public:
+    enum KeyType {
+        PresenceKey,    // detail presence test (no field)
+        SignedKey,      // Int, LongLong, Bool, UInt, Date and Time values
+        UnsignedKey,    // ULongLong values
+        DoubleKey,
+        DateTimeKey,
+        StringKey,      // collation sort keys of strings
+        VariantKey      // values of mixed or other types, compared with compareVariant()
+    };
+
+    ContactSortColumn(const QList<QContact> &contacts, const QContactSortOrder &sortOrder, QCollator *collator)
+        : m_sortOrder(sortOrder)
+        , m_keyType(VariantKey)
+        , m_blanksFirst(sortOrder.blankPolicy() == QContactSortOrder::BlanksFirst)
+        , m_direction(sortOrder.direction() == Qt::AscendingOrder ? 1 : -1)
+    {
+        const QContactDetail::DetailType detailType = sortOrder.detailType();
+        const int detailField = sortOrder.detailField();
+        const int count = contacts.size();
+
+        if (detailField == -1) {
+            m_keyType = PresenceKey;
+            m_detailCounts.reserve(count);
+            foreach (const QContact &contact, contacts)
+                m_detailCounts.append(QContactData::contactData(contact)->detailPositions(detailType).size());
+            return;
+        }
+
+        // obtain the values which this sort order concerns; empty strings are treated as null.
+        m_values.reserve(count);
+        m_blanks.reserve(count);
+        int valueType = QMetaType::UnknownType;
+        bool uniformType = true;
+        foreach (const QContact &contact, contacts) {
+            const QContactDetailsView details = QContactData::contactData(contact)->detailsView(detailType);
+            const QVariant value = details.isEmpty() ? QVariant() : details.first().value(detailField);
+            const bool blank = (value.metaType().id() == QMetaType::QString && value.toString().isEmpty()) || value.isNull();
+            m_values.append(value);
+            m_blanks.append(blank);
+            if (blank)
+                continue;
+            if (valueType == QMetaType::UnknownType)
+                valueType = value.metaType().id();
+            else if (valueType != value.metaType().id())
+                uniformType = false;
+        }
+
+        // compareVariant() compares according to the type of the first value, so typed keys
+        // can only be used when every value has the same type.
+        if (!uniformType)
+            return;
+
+        switch (valueType) {
+        case QMetaType::Int:
+        case QMetaType::LongLong:
+        case QMetaType::Bool:
+        case QMetaType::UInt:
+        case QMetaType::QDate:
+        case QMetaType::QTime:
+            m_keyType = SignedKey;
+            m_signedKeys.reserve(count);
+            for (int i = 0; i < count; ++i)
+                m_signedKeys.append(m_blanks.at(i) ? 0 : signedKey(m_values.at(i), valueType));
+            break;
+        case QMetaType::ULongLong:
+            m_keyType = UnsignedKey;
+            m_unsignedKeys.reserve(count);
+            for (int i = 0; i < count; ++i)
+                m_unsignedKeys.append(m_values.at(i).toULongLong());
+            break;
+        case QMetaType::Double:
+            m_keyType = DoubleKey;
+            m_doubleKeys.reserve(count);
+            for (int i = 0; i < count; ++i)
+                m_doubleKeys.append(m_values.at(i).toDouble());
+            break;
+        case QMetaType::QDateTime:
+            m_keyType = DateTimeKey;
+            m_dateTimeKeys.reserve(count);
+            for (int i = 0; i < count; ++i)
+                m_dateTimeKeys.append(m_values.at(i).toDateTime());
+            break;
+        case QMetaType::Char:
+        case QMetaType::QChar:
+        case QMetaType::QString:
+            m_keyType = StringKey;
+            m_stringKeys.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                const QString value = m_values.at(i).toString();
+                m_stringKeys.push_back(collator->sortKey(sortOrder.caseSensitivity() == Qt::CaseSensitive ? value : value.toCaseFolded()));
+            }
+            break;
+        default:
+            return; // keep the variants
+        }
+        m_values.clear();
+    }
+
+    /* Returns the comparison of the contacts at \a a and \a b, and sets \a decided if the
+     * remaining sort orders must not be consulted (as compareContact() does). */
+    int compareAt(int a, int b, bool *decided) const
+    {
+        *decided = true;
+        if (m_keyType == PresenceKey) {
+            const int aCount = m_detailCounts.at(a);
+            const int bCount = m_detailCounts.at(b);
+            if (aCount == bCount) {
+                *decided = false;
+                return 0;
+            }
+            if (aCount == 0)
+                return m_blanksFirst ? -1 : 1;
+            if (bCount == 0)
+                return m_blanksFirst ? 1 : -1;
+            return 0;
+        }
+
+        const bool aIsNull = m_blanks.at(a);
+        const bool bIsNull = m_blanks.at(b);
+        if (aIsNull && bIsNull) {
+            *decided = false;
+            return 0;
+        }
+        if (aIsNull)
+            return m_blanksFirst ? -1 : 1;
+        if (bIsNull)
+            return m_blanksFirst ? 1 : -1;
+
+        int comparison = 0;
+        switch (m_keyType) {
+        case SignedKey:
+            comparison = threeWay(m_signedKeys.at(a), m_signedKeys.at(b));
+            break;
+        case UnsignedKey:
+            comparison = threeWay(m_unsignedKeys.at(a), m_unsignedKeys.at(b));
+            break;
+        case DoubleKey:
+            comparison = threeWay(m_doubleKeys.at(a), m_doubleKeys.at(b));
+            break;
+        case DateTimeKey:
+            comparison = threeWay(m_dateTimeKeys.at(a), m_dateTimeKeys.at(b));
+            break;
+        case StringKey:
+            comparison = m_stringKeys[a].compare(m_stringKeys[b]);
+            break;
+        default:
+            comparison = QContactManagerEngine::compareVariant(m_values.at(a), m_values.at(b), m_sortOrder.caseSensitivity());
+            break;
+        }
+
+        comparison *= m_direction;
+        *decided = comparison != 0;
+        return comparison;
+    }
+
+private:
+    static qint64 signedKey(const QVariant &value, int valueType)
+    {
+        switch (valueType) {
+        case QMetaType::QDate:
+            return value.toDate().toJulianDay();
+        case QMetaType::QTime:
+            {
+                // an invalid time sorts before midnight, as with QTime comparison
+                const QTime time = value.toTime();
+                return time.isValid() ? time.msecsSinceStartOfDay() : -1;
+            }
+        case QMetaType::Bool:
+        case QMetaType::UInt:
+            return value.toUInt();
+        default:
+            return value.toLongLong();
+        }
+    }
+
+    template <typename T>
+    static int threeWay(const T &a, const T &b)
+    {
+        return (a < b) ? -1 : ((a == b) ? 0 : 1);
+    }
+
+    QContactSortOrder m_sortOrder;
+    KeyType m_keyType;
+    bool m_blanksFirst;
+    int m_direction;
+
+    QList<int> m_detailCounts;
+    QList<bool> m_blanks;
+    QList<QVariant> m_values;
+    QList<qint64> m_signedKeys;
+    QList<quint64> m_unsignedKeys;
+    QList<double> m_doubleKeys;
+    QList<QDateTime> m_dateTimeKeys;
+    std::vector<QCollatorSortKey> m_stringKeys;
+};
+
+/* A functor that returns true iff the contact at index a is less than the one at index b,
+ * according to the sort columns passed in to the ctor. */
+class ContactSortColumnsLessThan {
+    public:
+        ContactSortColumnsLessThan(const QList<ContactSortColumn> *columns) : mColumns(columns) {}
+        bool operator()(int a, int b) const
+        {
+            bool decided = false;
+            for (int i = 0; i < mColumns->size(); ++i) {
+                const int comparison = mColumns->at(i).compareAt(a, b, &decided);
+                if (decided)
+                    return comparison < 0;
+            }
+            return false;
+        }
+    private:
+        const QList<ContactSortColumn> *mColumns;
+};
+
+/*!
+  Sorts the given list of \a contacts in place according to the provided \a sortOrders list.
+
+  The result is the same as inserting each contact with addSorted() or sorting with compareContact(),
+  and contacts which are equal according to all sort orders keep their relative order.  However, the
+  values each sort order concerns are extracted only once per contact, and strings are compared through
+  precomputed collation keys, so this should be preferred over repeated calls to addSorted() when sorting
+  many contacts.
+
+  \note The collation keys are those of a QCollator for the default QLocale, whereas compareContact()
+  compares strings with QString::localeAwareCompare().  Where localeAwareCompare() collates with the
+  platform's collation for the system locale instead (eg. on builds without ICU, or after
+  QLocale::setDefault() was called), strings which the two collate differently sort differently.
+ */
+void QContactManagerEngine::sortContactsInPlace(QList<QContact> *contacts, const QList<QContactSortOrder> &sortOrders)
+{
+    if (contacts->size() < 2)
+        return;
+
+    QCollator collator;
+    QList<ContactSortColumn> columns;
+    foreach (const QContactSortOrder &sortOrder, sortOrders) {
+        if (!sortOrder.isValid())
+            break;
+        columns.append(ContactSortColumn(*contacts, sortOrder, &collator));
+    }
+    if (columns.isEmpty())
+        return;
+
+    QList<int> order;
+    order.reserve(contacts->size());
+    for (int i = 0; i < contacts->size(); ++i)
+        order.append(i);
+    std::stable_sort(order.begin(), order.end(), ContactSortColumnsLessThan(&columns));
+
+    QList<QContact> sorted;
+    sorted.reserve(contacts->size());
+    foreach (int index, order)
+        sorted.append(contacts->at(index));
+    *contacts = sorted;
+}
+
 /*! Sorts the given list of contacts \a cs according to the provided \a sortOrders
 */
 QList<QContactId> QContactManagerEngine::sortContacts(const QList<QContact>& cs, const QList<QContactSortOrder>& sortOrders)
 {
     QList<QContactId> sortedIds;
     QList<QContact> sortedContacts = cs;
-    if (!sortOrders.isEmpty()) {
-        ContactLessThan lessThan(&sortOrders);
-        std::stable_sort(sortedContacts.begin(), sortedContacts.end(), lessThan);
-    }
+    sortContactsInPlace(&sortedContacts, sortOrders);
 
     foreach(const QContact& c, sortedContacts) {
         sortedIds.append(c.id());
@@ -170,6 +170,7 @@ public:
     static int compareVariant(const QVariant &first, const QVariant &second, Qt::CaseSensitivity sensitivity);
     static bool testFilter(const QContactFilter& filter, const QContact &contact);
     static QList<QContactId> sortContacts(const QList<QContact> &contacts, const QList<QContactSortOrder> &sortOrders);
+    static void sortContactsInPlace(QList<QContact> *contacts, const QList<QContactSortOrder> &sortOrders);
 
     static QContactFilter canonicalizedFilter(const QContactFilter &filter);
 
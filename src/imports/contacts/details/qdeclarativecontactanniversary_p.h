@@ -125,6 +125,7 @@ public:
     {
         if (!readOnly() && v != subType()) {
             detail().setValue(QContactAnniversary::FieldSubType, v);
+            emit valueChanged();
         }
     }
 
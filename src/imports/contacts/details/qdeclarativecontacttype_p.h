@@ -92,6 +92,7 @@ public:
             default:
                 detail().setValue(QContactType::FieldType, Unspecified);
             }
+            emit valueChanged();
         }
     }
 
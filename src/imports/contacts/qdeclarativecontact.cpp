@@ -111,8 +111,11 @@ static void list_property_clear(QQmlListProperty<T> *)
 QDeclarativeContact::QDeclarativeContact(QObject *parent)
     :QObject(parent)
     , m_modified(false)
+    , m_contactValid(false)
+    , m_detailsCreated(true)
 {
     connect(this, SIGNAL(contactChanged()), SLOT(setModified()));
+    connect(this, SIGNAL(contactChanged()), SLOT(invalidateContact()));
 }
 
 QDeclarativeContact::~QDeclarativeContact()
@@ -129,14 +132,10 @@ void QDeclarativeContact::setContact(const QContact& contact)
     m_details.clear();
     m_preferredDetails.clear();
 
-    QList<QContactDetail> details(contact.details());
-    foreach (const QContactDetail &detail, details) {
-        QDeclarativeContactDetail *contactDetail = QDeclarativeContactDetailFactory::createContactDetail(static_cast<QDeclarativeContactDetail::DetailType>(detail.type()));
-        contactDetail->setParent(this);
-        contactDetail->setDetail(detail);
-        connect(contactDetail, SIGNAL(detailChanged()), this, SIGNAL(contactChanged()));
-        m_details.append(contactDetail);
-    }
+    // the detail objects are only created once they are accessed
+    m_contact = contact;
+    m_contactValid = true;
+    m_detailsCreated = false;
 
     QMap<QString, QContactDetail> prefDetails(contact.preferredDetails());
     QMap<QString, QContactDetail>::const_iterator  it = prefDetails.begin();
@@ -151,6 +150,9 @@ void QDeclarativeContact::setContact(const QContact& contact)
 
 QContact QDeclarativeContact::contact() const
 {
+    if (!m_detailsCreated || m_contactValid)
+        return m_contact;
+
     QContact contact;
     contact.setId(m_id);
     contact.setCollectionId(m_collectionId);
@@ -163,9 +165,32 @@ QContact QDeclarativeContact::contact() const
         contact.setPreferredDetail(it.key(), it.value().value<QDeclarativeContactDetail *>()->detail());
         it++;
     }
+    m_contact = contact;
+    m_contactValid = true;
     return contact;
 }
 
+/*!
+    \internal
+
+    Creates the detail objects for the contact set with setContact().
+ */
+void QDeclarativeContact::createDetails()
+{
+    if (m_detailsCreated)
+        return;
+    m_detailsCreated = true;
+
+    QList<QContactDetail> details(m_contact.details());
+    foreach (const QContactDetail &detail, details) {
+        QDeclarativeContactDetail *contactDetail = QDeclarativeContactDetailFactory::createContactDetail(static_cast<QDeclarativeContactDetail::DetailType>(detail.type()));
+        contactDetail->setParent(this);
+        contactDetail->setDetail(detail);
+        connect(contactDetail, SIGNAL(detailChanged()), this, SIGNAL(contactChanged()));
+        m_details.append(contactDetail);
+    }
+}
+
 /*!
     \qmlproperty bool Contact::modified
 
@@ -182,6 +207,15 @@ void QDeclarativeContact::setModified()
     m_modified = true;
 }
 
+/*!
+    \internal
+ */
+void QDeclarativeContact::invalidateContact()
+{
+    if (m_detailsCreated)
+        m_contactValid = false;
+}
+
 /*!
     \qmlproperty enumeration Contact::type
 
@@ -195,6 +229,9 @@ void QDeclarativeContact::setModified()
 */
 QDeclarativeContactType::ContactType QDeclarativeContact::type() const
 {
+    if (!m_detailsCreated)
+        return static_cast<QDeclarativeContactType::ContactType>(m_contact.type());
+
     foreach (QDeclarativeContactDetail *detail, m_details) {
         if (QDeclarativeContactDetail::Type == detail->detailType())
            return static_cast<QDeclarativeContactType *>(detail)->type();
@@ -213,6 +250,7 @@ bool QDeclarativeContact::removeDetail(QDeclarativeContactDetail* detail)
     if (detail) {
         if (!detail->removable())
             return false;
+        createDetails();
         int key = detail->detail().key();
         int i = 0;
         foreach (QDeclarativeContactDetail *contactDetail, m_details) {
@@ -252,7 +290,11 @@ void QDeclarativeContact::removePreferredDetail(QDeclarativeContactDetail* detai
 */
 bool QDeclarativeContact::addDetail(QDeclarativeContactDetail* detail)
 {
-    if (!detail || m_details.contains(detail))
+    if (!detail)
+        return false;
+
+    createDetails();
+    if (m_details.contains(detail))
         return false;
 
     QDeclarativeContactDetail *contactDetail = QDeclarativeContactDetailFactory::createContactDetail(detail->detailType());
@@ -279,6 +321,7 @@ bool QDeclarativeContact::addDetail(QDeclarativeContactDetail* detail)
  */
 bool QDeclarativeContact::setPreferredDetail(const QString& actionName, QDeclarativeContactDetail* detail)
 {
+   createDetails();
    if (actionName.isEmpty() || !detail || !m_details.contains(detail))
         return false;
 
@@ -326,6 +369,8 @@ QDeclarativeContactDetail* QDeclarativeContact::preferredDetail(const QString& a
     if (id == -1)
         return 0;
 
+    const_cast<QDeclarativeContact *>(this)->createDetails();
+
     foreach (QDeclarativeContactDetail* detail, m_details) {
         if (detail->detail().key() == id)
             return detail;
@@ -371,6 +416,7 @@ void QDeclarativeContact::setCollectionId(const QString &collectionId)
     // instead of the intended collectionId-string
     if (newCollectionId.toString() == collectionId && m_collectionId.toString() != collectionId) {
         m_collectionId = newCollectionId;
+        m_contact.setCollectionId(newCollectionId);
         m_modified = true;
         emit contactChanged();
     }
@@ -383,6 +429,7 @@ void QDeclarativeContact::setCollectionId(const QString &collectionId)
 */
 QQmlListProperty<QDeclarativeContactDetail> QDeclarativeContact::contactDetails()
 {
+    createDetails();
     return QQmlListProperty<QDeclarativeContactDetail>(this, 0,
                                                                      &QDeclarativeContact::_q_detail_append,
                                                                      &QDeclarativeContact::_q_detail_count,
@@ -418,6 +465,7 @@ QString QDeclarativeContact::manager() const
 */
 QDeclarativeContactDetail* QDeclarativeContact::detail(int type)
 {
+    createDetails();
     foreach (QDeclarativeContactDetail *detail, m_details) {
         if (type == detail->detailType()) {
             return detail;
@@ -434,6 +482,7 @@ QDeclarativeContactDetail* QDeclarativeContact::detail(int type)
 QVariantList QDeclarativeContact::details(int type)
 {
     QVariantList list;
+    createDetails();
     foreach (QDeclarativeContactDetail *detail, m_details) {
         if (type == detail->detailType()) {
             list.append(QVariant::fromValue((QObject*)detail));
@@ -449,8 +498,12 @@ QVariantList QDeclarativeContact::details(int type)
 */
 void QDeclarativeContact::clearDetails()
 {
-    if (m_details.isEmpty())
+    if (!m_detailsCreated) {
+        // no need to create the detail objects just to delete them
+        m_detailsCreated = true;
+    } else if (m_details.isEmpty()) {
         return;
+    }
 
     foreach (QDeclarativeContactDetail *detail, m_details)
         delete detail;
@@ -861,7 +914,9 @@ void QDeclarativeContact::_q_detail_append(QQmlListProperty<QDeclarativeContactD
     QDeclarativeContact *object = qobject_cast<QDeclarativeContact *>(property->object);
     if (object)
     {
+        object->createDetails();
         object->m_details.append(value);
+        object->m_contactValid = false;
         value->connect(value, SIGNAL(valueChanged()), SIGNAL(detailChanged()), Qt::UniqueConnection);
         value->connect(value, SIGNAL(detailChanged()), object, SIGNAL(contactChanged()), Qt::UniqueConnection);
     }
@@ -889,6 +944,8 @@ void QDeclarativeContact::_q_detail_clear(QQmlListProperty<QDeclarativeContactDe
         foreach (QDeclarativeContactDetail *obj, object->m_details)
             delete obj;
         object->m_details.clear();
+        object->m_detailsCreated = true;
+        object->m_contactValid = false;
     }
 }
 
@@ -184,12 +184,14 @@ Q_SIGNALS:
 
 private slots:
     void setModified();
+    void invalidateContact();
 
 private:
     Q_DISABLE_COPY(QDeclarativeContact)
 
     template<typename T> T* getDetail(const QDeclarativeContactDetail::DetailType &type)
     {
+        createDetails();
         foreach (QDeclarativeContactDetail *detail, m_details) {
             if (type == detail->detailType())
             {
@@ -197,7 +199,7 @@ private:
                 return tempDetail;
             }
         }
-        T* detail = new T;
+        T* detail = new T(this);
         if (detail) {
             m_details.append(detail);
             emit contactChanged();
@@ -207,6 +209,13 @@ private:
     }
 
     void removePreferredDetail(QDeclarativeContactDetail *detail);
+    void createDetails();
+
+    // until the detail objects are created m_contact is the authoritative copy
+    // of the contact, afterwards it caches the contact built from them
+    mutable QContact m_contact;
+    mutable bool m_contactValid;
+    bool m_detailsCreated;
 
     // call-back functions for list property
     static void _q_detail_append(QQmlListProperty<QDeclarativeContactDetail> *property, QDeclarativeContactDetail *value);
@@ -100,7 +100,10 @@ QList<int> QDeclarativeContactDetail::contexts() const
 }
 void QDeclarativeContactDetail::setContexts(const QList<int>& contexts)
 {
-    m_detail.setContexts(contexts);
+    if (m_detail.contexts() != contexts) {
+        m_detail.setContexts(contexts);
+        emit detailChanged();
+    }
 }
 
 /*!
@@ -136,7 +139,10 @@ QString QDeclarativeContactDetail::detailUri() const
 }
 void QDeclarativeContactDetail::setDetailUri(const QString& detailUri)
 {
-    m_detail.setDetailUri(detailUri);
+    if (m_detail.detailUri() != detailUri) {
+        m_detail.setDetailUri(detailUri);
+        emit detailChanged();
+    }
 }
 
 /*!
@@ -150,7 +156,10 @@ QStringList QDeclarativeContactDetail::linkedDetailUris() const
 }
 void QDeclarativeContactDetail::setLinkedDetailUris(const QStringList& linkedDetailUris)
 {
-    m_detail.setLinkedDetailUris(linkedDetailUris);
+    if (m_detail.linkedDetailUris() != linkedDetailUris) {
+        m_detail.setLinkedDetailUris(linkedDetailUris);
+        emit detailChanged();
+    }
 }
 
 /*!
@@ -205,7 +214,10 @@ QDeclarativeContactDetail::DetailType QDeclarativeContactDetail::detailType() co
 */
 QList<int> QDeclarativeContactDetail::fields() const
 {
-    return m_detail.values().keys();
+    QList<int> fields;
+    for (int field = m_detail.nextField(); field != -1; field = m_detail.nextField(field))
+        fields.append(field);
+    return fields;
 }
 
 QVariant QDeclarativeContactDetail::value(int field) const
@@ -43,6 +43,7 @@
 #include <QtCore/qhash.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qset.h>
 #include <QtCore/qurl.h>
 #include <QtCore/qmimedatabase.h>
 #include <QtCore/qmimetype.h>
@@ -73,6 +74,9 @@ QTVERSIT_USE_NAMESPACE
 
 QT_BEGIN_NAMESPACE
 
+// The number of pages of contacts kept in memory in the paged mode
+#define CONTACT_MODEL_CACHED_PAGES 4
+
 /*!
     \qmltype ContactModel
     \instantiates QDeclarativeContactModel
@@ -178,7 +182,11 @@ public:
         m_autoUpdate(true),
         m_componentCompleted(false),
         m_progressiveLoading(true),
-        m_updatePendingFlag(QDeclarativeContactModelPrivate::NonePending)
+        m_updatePendingFlag(QDeclarativeContactModelPrivate::NonePending),
+        m_contactRowsValid(0),
+        m_pageSize(0),
+        m_pagedUseCount(0),
+        m_pagedCacheSize(0)
     {
     }
     ~QDeclarativeContactModelPrivate()
@@ -219,6 +227,41 @@ public:
     QList<QDeclarativeContactCollection*> m_collections;
     bool m_progressiveLoading;
     int m_updatePendingFlag;
+
+    // The row of each contact, up to date for the rows before m_contactRowsValid
+    QHash<QContactId, int> m_contactRows;
+    int m_contactRowsValid;
+    // The details of each contact compared by m_sortKeyOrders
+    QHash<QContactId, QContact> m_sortKeys;
+    QList<QContactSortOrder> m_sortKeyOrders;
+
+    void invalidateContactRows(int row)
+    {
+        m_contactRowsValid = qMin(m_contactRowsValid, row);
+    }
+
+    void clearContactRows()
+    {
+        m_contactRows.clear();
+        m_contactRowsValid = 0;
+        m_sortKeys.clear();
+    }
+
+    // The paged mode, see pageSize
+    int m_pageSize;
+    QList<QContactId> m_pagedIds; // The contact of each row
+    QHash<QContactId, int> m_pagedRows;
+    QHash<QContactId, QDeclarativeContact*> m_pagedContacts; // The rows which have been fetched
+    QHash<QContactId, quint64> m_pagedLastUse; // The fetched rows, with the time they were last used
+    quint64 m_pagedUseCount; // The time of the last use of a fetched row
+    QSet<QContactId> m_pagedPendingIds; // The rows queued or being fetched
+    QList<QContactId> m_pagedQueuedIds; // The rows to fetch in the next request
+    QSet<QContactId> m_pagedForgottenIds; // The rows forgotten when the last page was fetched
+    int m_pagedCacheSize; // The rows the views have been seen to use at once
+    QPointer<QContactIdFetchRequest> m_idFetchRequest;
+    QPointer<QContactFetchByIdRequest> m_exportFetchRequest;
+    QUrl m_exportFetchUrl;
+    QString m_exportFetchProfile;
 };
 
 QDeclarativeContactModel::QDeclarativeContactModel(QObject *parent) :
@@ -229,6 +272,7 @@ QDeclarativeContactModel::QDeclarativeContactModel(QObject *parent) :
     connect(this, SIGNAL(filterChanged()), SLOT(doContactUpdate()));
     connect(this, SIGNAL(fetchHintChanged()), SLOT(doContactUpdate()));
     connect(this, SIGNAL(sortOrdersChanged()), SLOT(doContactUpdate()));
+    connect(this, SIGNAL(pageSizeChanged()), SLOT(doContactUpdate()));
 
     //import vcard
     connect(&d->m_reader, SIGNAL(stateChanged(QVersitReader::State)), this, SLOT(startImport(QVersitReader::State)));
@@ -374,6 +418,11 @@ void QDeclarativeContactModel::cancelUpdate()
         req->deleteLater();
     }
     d->m_pendingRequests.clear();;
+    if (d->m_idFetchRequest) {
+        d->m_idFetchRequest->cancel();
+        d->m_idFetchRequest->deleteLater();
+        d->m_idFetchRequest = 0;
+    }
     d->m_updatePendingFlag = QDeclarativeContactModelPrivate::NonePending;
 }
 
@@ -547,46 +596,111 @@ void QDeclarativeContactModel::exportContacts(const QUrl& url, const QStringList
 {
     // Writer is capable of handling only one request at the time.
     ExportError exportError = ExportNotReadyError;
-    if (d->m_writer.state() != QVersitWriter::ActiveState) {
+    if (d->m_writer.state() != QVersitWriter::ActiveState && !d->m_exportFetchRequest) {
         QString profile = profiles.isEmpty()? QString() : profiles.at(0);
         //only one profile string supported now.
-        QVersitContactExporter exporter(profile);
-        exporter.setResourceHandler(&d->m_resourceHandler);
 
-        QList<QContact> contacts;
-        if (declarativeContacts.isEmpty()) {
-            foreach (QDeclarativeContact* dc, d->m_contacts) {
-                contacts.append(dc->contact());
+        if (declarativeContacts.isEmpty() && d->m_pageSize > 0) {
+            // Most of the rows have not been fetched in the paged mode, fetch them all first
+            QContactFetchByIdRequest *fetchRequest = new QContactFetchByIdRequest(this);
+            connect(fetchRequest, SIGNAL(stateChanged(QContactAbstractRequest::State)),
+                    this, SLOT(onExportFetchRequestStateChanged(QContactAbstractRequest::State)));
+            fetchRequest->setManager(d->m_manager);
+            fetchRequest->setIds(d->m_pagedIds);
+            fetchRequest->setFetchHint(d->m_fetchHint ? d->m_fetchHint->fetchHint() : QContactFetchHint());
+            if (fetchRequest->start()) {
+                d->m_exportFetchRequest = fetchRequest;
+                d->m_exportFetchUrl = url;
+                d->m_exportFetchProfile = profile;
+                return;
             }
-
+            checkError(fetchRequest);
+            fetchRequest->deleteLater();
+            exportError = ExportUnspecifiedError;
         } else {
-            foreach (const QVariant &contactVariant, declarativeContacts) {
-                QObject *rawObject = contactVariant.value<QObject*>();
-                QDeclarativeContact *dc = qobject_cast<QDeclarativeContact*>(rawObject);
-                if (dc) {
+            QList<QContact> contacts;
+            if (declarativeContacts.isEmpty()) {
+                foreach (QDeclarativeContact* dc, d->m_contacts) {
                     contacts.append(dc->contact());
                 }
+
+            } else {
+                foreach (const QVariant &contactVariant, declarativeContacts) {
+                    QObject *rawObject = contactVariant.value<QObject*>();
+                    QDeclarativeContact *dc = qobject_cast<QDeclarativeContact*>(rawObject);
+                    if (dc) {
+                        contacts.append(dc->contact());
+                    }
+                }
             }
-        }
 
-        exporter.exportContacts(contacts, QVersitDocument::VCard30Type);
-        QList<QVersitDocument> documents = exporter.documents();
-        QFile* file = new QFile(urlToLocalFileName(url));
-        bool ok = file->open(QIODevice::WriteOnly);
-        if (ok) {
-            d->m_writer.setDevice(file);
-            if (d->m_writer.startWriting(documents)) {
-                d->m_lastExportUrl = url;
+            exportError = writeContacts(contacts, url, profile);
+            if (exportError == ExportNoError)
                 return;
-            }
-            exportError = QDeclarativeContactModel::ExportError(d->m_writer.error());
-        } else {
-            exportError = ExportIOError;
         }
     }
     emit exportCompleted(exportError, url);
 }
 
+/*!
+    \internal
+
+    Starts writing the given \a contacts to the file of the given \a url by the given \a profile.
+ */
+QDeclarativeContactModel::ExportError QDeclarativeContactModel::writeContacts(const QList<QContact> &contacts, const QUrl &url, const QString &profile)
+{
+    QVersitContactExporter exporter(profile);
+    exporter.setResourceHandler(&d->m_resourceHandler);
+    exporter.exportContacts(contacts, QVersitDocument::VCard30Type);
+    QList<QVersitDocument> documents = exporter.documents();
+    QFile* file = new QFile(urlToLocalFileName(url));
+    bool ok = file->open(QIODevice::WriteOnly);
+    if (ok) {
+        d->m_writer.setDevice(file);
+        if (d->m_writer.startWriting(documents)) {
+            d->m_lastExportUrl = url;
+            return ExportNoError;
+        }
+        delete file;
+        d->m_writer.setDevice(0);
+        return QDeclarativeContactModel::ExportError(d->m_writer.error());
+    }
+    delete file;
+    return ExportIOError;
+}
+
+/*!
+    \internal
+ */
+void QDeclarativeContactModel::onExportFetchRequestStateChanged(QContactAbstractRequest::State state)
+{
+    if (state != QContactAbstractRequest::FinishedState)
+        return;
+
+    QContactFetchByIdRequest *request = qobject_cast<QContactFetchByIdRequest *>(sender());
+    Q_ASSERT(request);
+    request->deleteLater();
+    if (request != d->m_exportFetchRequest)
+        return;
+    d->m_exportFetchRequest = 0;
+
+    // the contacts removed since the export started are left out
+    ExportError exportError = ExportUnspecifiedError;
+    if (request->error() == QContactManager::NoError || request->error() == QContactManager::DoesNotExistError) {
+        QList<QContact> contacts;
+        foreach (const QContact &contact, request->contacts()) {
+            if (!contact.id().isNull())
+                contacts.append(contact);
+        }
+        exportError = writeContacts(contacts, d->m_exportFetchUrl, d->m_exportFetchProfile);
+        if (exportError == ExportNoError)
+            return;
+    } else {
+        checkError(request);
+    }
+    emit exportCompleted(exportError, d->m_exportFetchUrl);
+}
+
 void QDeclarativeContactModel::contactsExported(QVersitWriter::State state)
 {
     if (state == QVersitWriter::FinishedState || state == QVersitWriter::CanceledState) {
@@ -606,6 +720,8 @@ void QDeclarativeContactModel::onFetchedContactDestroyed(QObject *obj)
 int QDeclarativeContactModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
+    if (d->m_pageSize > 0)
+        return d->m_pagedIds.count();
     return d->m_contacts.count();
 }
 
@@ -658,6 +774,54 @@ void QDeclarativeContactModel::setFetchHint(QDeclarativeContactFetchHint* fetchH
     }
 }
 
+/*!
+  \qmlproperty int ContactModel::pageSize
+
+  This property holds the number of contacts fetched at a time in the paged mode of the model,
+  or 0 if the model fetches all of its contacts at once.  The default value is 0.
+
+  In the paged mode, the model first fetches only the ids of the matching contacts, in the order
+  set by \l sortOrders, so that the number of rows is known straight away.  The contacts are then
+  fetched a page at a time as the view asks for their rows, and only the most recently used pages
+  are kept in memory, or at least as many rows as the view shows at once.  The \c contact role of
+  a row is null until the row has been fetched.
+
+  The \l contacts property is empty in the paged mode.
+  */
+int QDeclarativeContactModel::pageSize() const
+{
+    return d->m_pageSize;
+}
+
+void QDeclarativeContactModel::setPageSize(int pageSize)
+{
+    pageSize = qMax(0, pageSize);
+    if (pageSize == d->m_pageSize)
+        return;
+
+    if ((pageSize > 0) != (d->m_pageSize > 0)) {
+        // The rows of one mode mean nothing to the other
+        foreach (QContactFetchRequest *req, d->m_pendingRequests) {
+            req->cancel();
+            req->deleteLater();
+        }
+        d->m_pendingRequests.clear();
+        d->m_pendingContacts.clear();
+        beginResetModel();
+        qDeleteAll(d->m_contacts);
+        d->m_contacts.clear();
+        d->m_contactMap.clear();
+        d->clearContactRows();
+        clearPagedContacts();
+        d->m_pageSize = pageSize;
+        endResetModel();
+        emit contactsChanged();
+    } else {
+        d->m_pageSize = pageSize;
+    }
+    emit pageSizeChanged();
+}
+
 /*!
   \qmlproperty list<Contact> ContactModel::contacts
 
@@ -947,12 +1111,18 @@ void QDeclarativeContactModel::clearContacts()
     qDeleteAll(d->m_contacts);
     d->m_contacts.clear();
     d->m_contactMap.clear();
+    d->clearContactRows();
     qDeleteAll(d->m_contactFetchedMap.values());
     d->m_contactFetchedMap.clear();
 }
 
 void QDeclarativeContactModel::fetchAgain()
 {
+    if (d->m_pageSize > 0) {
+        fetchPagedIds();
+        return;
+    }
+
     QList<QContactSortOrder> sortOrders;
     foreach (QDeclarativeContactSortOrder* so, d->m_sortOrders) {
         sortOrders.append(so->sortOrder());
@@ -1007,6 +1177,7 @@ void QDeclarativeContactModel::requestUpdated()
                 if (d->m_contactMap.contains(c.id())) {
                     QDeclarativeContact* dc = d->m_contactMap.value(c.id());
                     dc->setContact(c);
+                    d->m_sortKeys.remove(c.id());
                 } else {
                     QDeclarativeContact* dc = new QDeclarativeContact(this);
                     if (dc) {
@@ -1020,6 +1191,7 @@ void QDeclarativeContactModel::requestUpdated()
             if (dcs.count() > 0) {
                 beginInsertRows(QModelIndex(), d->m_contacts.count(), d->m_contacts.count() + dcs.count() - 1);
                 // At this point we need to relay on the backend and assume that the partial results are following the fetch sorting property
+                d->invalidateContactRows(d->m_contacts.count());
                 d->m_contacts += dcs;
                 endInsertRows();
 
@@ -1045,15 +1217,17 @@ void QDeclarativeContactModel::fetchRequestStateChanged(QContactAbstractRequest:
         // if we were not processing contacts as soon as they arrive, we need to process them here.
         if (!d->m_progressiveLoading) {
             // start by removing the contacts that don't belong to this result set anymore
-            for (int i = d->m_contacts.count()-1; i >= 0; --i) {
-                QDeclarativeContact *contact = d->m_contacts[i];
-                if (!d->m_pendingContacts.contains(contact->contact())) {
-                    beginRemoveRows(QModelIndex(), i, i);
-                    d->m_contacts.removeAt(i);
-                    d->m_contactMap.remove(contact->contact().id());
-                    endRemoveRows();
-                }
+            QHash<QContactId, QContact> pendingContacts;
+            foreach (const QContact &c, d->m_pendingContacts)
+                pendingContacts.insert(c.id(), c);
+            QList<int> removedRows;
+            for (int i = 0; i < d->m_contacts.count(); ++i) {
+                const QContact c = d->m_contacts.at(i)->contact();
+                QHash<QContactId, QContact>::const_iterator it = pendingContacts.constFind(c.id());
+                if (it == pendingContacts.constEnd() || it.value() != c)
+                    removedRows.append(i);
             }
+            takeContactRows(removedRows);
 
             // now insert new contacts and move existing ones to their final positions
             int count = d->m_pendingContacts.count();
@@ -1065,6 +1239,7 @@ void QDeclarativeContactModel::fetchRequestStateChanged(QContactAbstractRequest:
                     beginInsertRows(QModelIndex(), i, i);
                     d->m_contacts.insert(i, dc);
                     d->m_contactMap.insert(c.id(),dc);
+                    d->invalidateContactRows(i);
                     endInsertRows();
                 } else {
                     QDeclarativeContact *contact = d->m_contactMap[c.id()];
@@ -1076,6 +1251,7 @@ void QDeclarativeContactModel::fetchRequestStateChanged(QContactAbstractRequest:
                     if (oldIdx != newIdx) {
                         beginMoveRows(QModelIndex(), oldIdx, oldIdx, QModelIndex(), newIdx);
                         d->m_contacts.move(oldIdx, newIdx);
+                        d->invalidateContactRows(qMin(oldIdx, newIdx));
                         endMoveRows();
                     }
                 }
@@ -1192,6 +1368,12 @@ void QDeclarativeContactModel::updateError(QContactManager::Error error)
 
 void QDeclarativeContactModel::onContactsAdded(const QList<QContactId>& ids)
 {
+    if (d->m_pageSize > 0) {
+        // The new contacts may belong anywhere in the order
+        if (d->m_autoUpdate && !ids.isEmpty())
+            fetchPagedIds();
+        return;
+    }
     if (d->m_autoUpdate && !ids.isEmpty()) {
         QContactFetchRequest *fetchRequest = createContactFetchRequest(ids);
         connect(fetchRequest,SIGNAL(stateChanged(QContactAbstractRequest::State)),
@@ -1243,38 +1425,49 @@ void QDeclarativeContactModel::onContactsRemoved(const QList<QContactId> &ids)
     if (!d->m_autoUpdate)
         return;
 
-    bool emitSignal = false;
+    QList<int> removedRows;
     foreach (const QContactId &id, ids) {
         // delete the contact from fetched map if necessary
         QDeclarativeContact* contact = d->m_contactFetchedMap.take(id);
         if (contact)
             contact->deleteLater();
 
-        if (d->m_contactMap.contains(id)) {
-            int row = 0;
-            //TODO:need a fast lookup
-            for (; row < d->m_contacts.count(); row++) {
-                if (d->m_contacts.at(row)->contactId() == id.toString())
-                    break;
-            }
+        if (d->m_pageSize > 0)
+            continue;
 
-            if (row < d->m_contacts.count()) {
-                beginRemoveRows(QModelIndex(), row, row);
-                contact = d->m_contacts.takeAt(row);
-                contact->deleteLater();
-                d->m_contactMap.remove(id);
-                endRemoveRows();
-                emitSignal = true;
-            }
-        }
+        const int row = contactRow(id);
+        if (row >= 0)
+            removedRows.append(row);
     }
-    if (emitSignal)
+    if (!removedRows.isEmpty()) {
+        foreach (QDeclarativeContact *contact, takeContactRows(removedRows))
+            contact->deleteLater();
         emit contactsChanged();
+    }
+
+    if (d->m_pageSize > 0) {
+        QSet<QContactId> removedIds(ids.constBegin(), ids.constEnd());
+        QList<QContactId> remainingIds;
+        foreach (const QContactId &id, d->m_pagedIds) {
+            if (!removedIds.contains(id))
+                remainingIds.append(id);
+        }
+        setPagedIds(remainingIds);
+    }
 }
 
 void QDeclarativeContactModel::onContactsChanged(const QList<QContactId> &ids)
 {
-    if (d->m_autoUpdate && !ids.isEmpty()) {
+    if (d->m_pageSize > 0 && d->m_autoUpdate && !ids.isEmpty()) {
+        // The changes may move the contacts, or take them in or out of the filter
+        fetchPagedIds();
+        QList<QContactId> fetchedIds;
+        foreach (const QContactId &id, ids) {
+            if (d->m_pagedContacts.contains(id))
+                fetchedIds.append(id);
+        }
+        queuePagedContacts(fetchedIds);
+    } else if (d->m_autoUpdate && !ids.isEmpty()) {
         QContactFetchRequest *fetchRequest = createContactFetchRequest(ids);
         connect(fetchRequest, SIGNAL(stateChanged(QContactAbstractRequest::State)),
                 this, SLOT(onContactsChangedFetchRequestStateChanged(QContactAbstractRequest::State)));
@@ -1317,13 +1510,22 @@ QContactFetchRequest *QDeclarativeContactModel::createContactFetchRequest(const
 
 QVariant QDeclarativeContactModel::data(const QModelIndex &index, int role) const
 {
-    //Check if QList itme's index is valid before access it, index should be between 0 and count - 1
-    if (index.row() < 0 || index.row() >= d->m_contacts.count()) {
-        return QVariant();
-    }
+    QDeclarativeContact* dc = 0;
+    if (d->m_pageSize > 0) {
+        if (index.row() < 0 || index.row() >= d->m_pagedIds.count())
+            return QVariant();
+        dc = pagedContact(index.row());
+        if (!dc) // Not fetched yet
+            return QVariant();
+    } else {
+        //Check if QList itme's index is valid before access it, index should be between 0 and count - 1
+        if (index.row() < 0 || index.row() >= d->m_contacts.count()) {
+            return QVariant();
+        }
 
-    QDeclarativeContact* dc = d->m_contacts.value(index.row());
-    Q_ASSERT(dc);
+        dc = d->m_contacts.value(index.row());
+        Q_ASSERT(dc);
+    }
     QContact c = dc->contact();
 
     switch(role) {
@@ -1426,9 +1628,9 @@ void QDeclarativeContactModel::onContactsAddedFetchRequestStateChanged(QContactA
 
     checkError(request);
 
-    if (request->error() == QContactManager::NoError) {
+    if (request->error() == QContactManager::NoError && d->m_pageSize == 0) {
         QList<QContact> fetchedContacts(request->contacts());
-        bool contactsAdded = false;
+        QList<QDeclarativeContact*> addedContacts;
         foreach (const QContact &c,fetchedContacts) {
             if (d->m_contactMap.contains(c.id())) {
                 qWarning() <<Q_FUNC_INFO <<"contact to be added already exists in the model";
@@ -1436,29 +1638,17 @@ void QDeclarativeContactModel::onContactsAddedFetchRequestStateChanged(QContactA
             }
             QDeclarativeContact* dc = new QDeclarativeContact(this);
             dc->setContact(c);
-            int index = contactIndex(dc);
-            beginInsertRows(QModelIndex(), index, index);
-            d->m_contacts.insert(index, dc);
-            d->m_contactMap.insert(c.id(), dc);
-            if (!contactsAdded)
-                contactsAdded = true;
-            endInsertRows();
+            addedContacts.append(dc);
         }
-        if (contactsAdded)
+        if (!addedContacts.isEmpty()) {
+            insertContacts(addedContacts);
             emit contactsChanged();
+        }
     }
     request->deleteLater();
 }
 
 
-static bool contactListDoesNotContainContactWithId(const QList<QContact> &contactList, const QContactId &contactId) {
-    foreach (const QContact &contact, contactList) {
-        if (contact.id() == contactId)
-            return false;
-    }
-    return true;
-}
-
 /*!
     \internal
 
@@ -1474,7 +1664,9 @@ void QDeclarativeContactModel::onContactsChangedFetchRequestStateChanged(QContac
 
     checkError(request);
     bool contactsUpdated = false;
-    if (request->error() == QContactManager::NoError || request->error() == QContactManager::DoesNotExistError) {
+    if (d->m_pageSize > 0) {
+        // Started before the model switched to the paged mode
+    } else if (request->error() == QContactManager::NoError || request->error() == QContactManager::DoesNotExistError) {
         QList<QContact> fetchedContacts(request->contacts());
         QList<QContactId> requestedContactIds;
         //read requested contacts ids from the filter
@@ -1488,63 +1680,67 @@ void QDeclarativeContactModel::onContactsChangedFetchRequestStateChanged(QContac
         }
         //handle updated contacts which needs removal from model
         //all contacts requested but not received are removed
+        QSet<QContactId> fetchedContactIds;
+        foreach (const QContact &fetchedContact, fetchedContacts)
+            fetchedContactIds.insert(fetchedContact.id());
+        QList<int> removedRows;
         foreach (const QContactId &id, requestedContactIds) {
-            if (contactListDoesNotContainContactWithId(fetchedContacts, id)) {
-                for (int i=0;i<d->m_contacts.size();++i) {
-                    if (d->m_contacts.at(i)->contactId() == id.toString()) {
-                        beginRemoveRows(QModelIndex(), i, i);
-                        // Remove and delete contact object
-                        QDeclarativeContact* dc = d->m_contacts.takeAt(i);
-                        dc->deleteLater();
-                        d->m_contactMap.remove(id);
-                        endRemoveRows();
-                        contactsUpdated = true;
-                    }
-                }
-            }
+            const int row = fetchedContactIds.contains(id) ? -1 : contactRow(id);
+            if (row >= 0)
+                removedRows.append(row);
+        }
+        if (!removedRows.isEmpty()) {
+            // Remove and delete contact objects
+            foreach (QDeclarativeContact *dc, takeContactRows(removedRows))
+                dc->deleteLater();
+            contactsUpdated = true;
         }
+
+        updateSortKeyOrders();
+        QList<QDeclarativeContact*> addedContacts;
+        QList<int> updatedRows;
         foreach (const QContact &fetchedContact, fetchedContacts) {
-            QString contactIdString(fetchedContact.id().toString());
-            bool fetchedContactFound = false;
-            for (int i = 0; i < d->m_contacts.size(); ++i) {
+            const int row = contactRow(fetchedContact.id());
+            if (row >= 0) {
                 //handle updated contacts which should be updated in the model
-                if (d->m_contacts.at(i)->contactId() == contactIdString) {
-                    QDeclarativeContact* dc = d->m_contacts.at(i);
-                    dc->setContact(fetchedContact);
-
-                    // Since the contact can change the position due the sort order we need take care of it
-                    // First we need to remove it from previous position and notify the model about that
-                    beginRemoveRows(QModelIndex(), i, i);
-                    d->m_contactMap.remove(fetchedContact.id());
-                    d->m_contacts.removeAt(i);
-                    endRemoveRows();
-
-                    // Calculate the new position
-                    int index = contactIndex(dc);
-                    // Notify the model about the new item position
-                    beginInsertRows(QModelIndex(), index, index);
-                    d->m_contacts.insert(index, dc);
-                    d->m_contactMap.insert(fetchedContact.id(),dc);
-                    if (!contactsUpdated)
-                        contactsUpdated = true;
-                    endInsertRows();
-
-                    fetchedContactFound = true;
-                    break;
-                }
-            }
-            //handle updated contacts which needs to be added in the model
-            if (!fetchedContactFound) {
+                d->m_contacts.at(row)->setContact(fetchedContact);
+                d->m_sortKeys.remove(fetchedContact.id());
+                updatedRows.append(row);
+            } else {
+                //handle updated contacts which needs to be added in the model
                 QDeclarativeContact* dc = new QDeclarativeContact(this);
                 dc->setContact(fetchedContact);
-                int index = contactIndex(dc);
-                beginInsertRows(QModelIndex(), index, index);
-                d->m_contacts.insert(index, dc);
-                d->m_contactMap.insert(fetchedContact.id(),dc);
-                contactsUpdated = true;
-                endInsertRows();
+                addedContacts.append(dc);
+            }
+        }
+
+        // Since the contacts can change their position due the sort order we need take care of it.
+        // The rows which are still in order are kept, so that the rows which are not updated stay
+        // sorted, and the others are taken out and inserted again at their new positions.
+        std::sort(updatedRows.begin(), updatedRows.end());
+        const QSet<int> updated(updatedRows.constBegin(), updatedRows.constEnd());
+        QSet<int> moved;
+        foreach (int row, updatedRows) {
+            const QContact sortKey = contactSortKey(d->m_contacts.at(row));
+            int previous = row - 1;
+            while (previous >= 0 && moved.contains(previous))
+                --previous;
+            int next = row + 1;
+            while (next < d->m_contacts.count() && updated.contains(next))
+                ++next;
+            if ((previous >= 0 && QContactManagerEngine::compareContact(contactSortKey(d->m_contacts.at(previous)), sortKey, d->m_sortKeyOrders) > 0)
+                    || (next < d->m_contacts.count() && QContactManagerEngine::compareContact(sortKey, contactSortKey(d->m_contacts.at(next)), d->m_sortKeyOrders) > 0)) {
+                moved.insert(row);
+            } else {
+                emit dataChanged(index(row), index(row));
             }
         }
+        if (!moved.isEmpty())
+            addedContacts += takeContactRows(QList<int>(moved.constBegin(), moved.constEnd()));
+        if (!addedContacts.isEmpty())
+            insertContacts(addedContacts);
+        if (!updatedRows.isEmpty() || !addedContacts.isEmpty())
+            contactsUpdated = true;
     }
 
     if (contactsUpdated)
@@ -1553,25 +1749,492 @@ void QDeclarativeContactModel::onContactsChangedFetchRequestStateChanged(QContac
     request->deleteLater();
 }
 
-int QDeclarativeContactModel::contactIndex(const QDeclarativeContact* contact)
-{
-    if (d->m_sortOrders.count() > 0) {
-        QList<QContactSortOrder> mSortOrders;
-        foreach (QDeclarativeContactSortOrder *sortOrder, d->m_sortOrders)
-            mSortOrders.append(sortOrder->sortOrder());
-        for (int i = 0; i < d->m_contacts.size(); i++) {
-            // check to see if the new contact should be inserted here
-            int comparison = QContactManagerEngine::compareContact(d->m_contacts.at(i)->contact(),
-                                                                   contact->contact(),
-                                                                   mSortOrders);
-            //if the contacts are equal or cannot be compared
-            //we return the current position.The default case is if the new contact
-            //should appear before the compared contact in m_contacts
-            if (comparison >= 0)
-                return i;
+/*!
+    \internal
+
+    Returns the row where a contact with the given \a sortKey should be inserted.
+    updateSortKeyOrders() must have been called before.
+ */
+int QDeclarativeContactModel::contactIndex(const QContact &sortKey)
+{
+    if (d->m_sortKeyOrders.isEmpty())
+        return d->m_contacts.size();
+
+    // binary search for the first row which is not before the new contact, so that
+    // the new contact goes before the contacts which are equal or cannot be compared
+    int first = 0;
+    int count = d->m_contacts.size();
+    while (count > 0) {
+        const int step = count / 2;
+        const int middle = first + step;
+        if (QContactManagerEngine::compareContact(contactSortKey(d->m_contacts.at(middle)), sortKey, d->m_sortKeyOrders) < 0) {
+            first = middle + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+/*!
+    \internal
+
+    Returns a contact holding only the details of the given \a contact which the sort orders
+    compare, so that comparing the contacts doesn't need to search all their details.
+ */
+QContact QDeclarativeContactModel::contactSortKey(const QDeclarativeContact *contact)
+{
+    const QContact c = contact->contact();
+    QHash<QContactId, QContact>::const_iterator it = d->m_sortKeys.constFind(c.id());
+    if (it != d->m_sortKeys.constEnd())
+        return it.value();
+
+    QContact sortKey;
+    QSet<QContactDetail::DetailType> detailTypes;
+    foreach (const QContactSortOrder &sortOrder, d->m_sortKeyOrders) {
+        if (detailTypes.contains(sortOrder.detailType()))
+            continue;
+        detailTypes.insert(sortOrder.detailType());
+        foreach (QContactDetail detail, c.details(sortOrder.detailType()))
+            sortKey.saveDetail(&detail);
+    }
+    d->m_sortKeys.insert(c.id(), sortKey);
+    return sortKey;
+}
+
+/*!
+    \internal
+
+    Updates the sort orders the sort keys are made for, dropping the sort keys if they changed.
+ */
+void QDeclarativeContactModel::updateSortKeyOrders()
+{
+    QList<QContactSortOrder> sortOrders;
+    foreach (QDeclarativeContactSortOrder *sortOrder, d->m_sortOrders)
+        sortOrders.append(sortOrder->sortOrder());
+    if (sortOrders != d->m_sortKeyOrders) {
+        d->m_sortKeys.clear();
+        d->m_sortKeyOrders = sortOrders;
+    }
+}
+
+/*!
+    \internal
+
+    Returns the row of the contact with the given \a id, or -1 if it is not in the model.
+ */
+int QDeclarativeContactModel::contactRow(const QContactId &id)
+{
+    const int row = d->m_contactRows.value(id, -1);
+    if (row >= 0 && row < d->m_contactRowsValid)
+        return row;
+
+    // index the rows which have changed since the last lookup
+    for (; d->m_contactRowsValid < d->m_contacts.count(); ++d->m_contactRowsValid)
+        d->m_contactRows.insert(d->m_contacts.at(d->m_contactRowsValid)->contact().id(), d->m_contactRowsValid);
+    return d->m_contactRows.value(id, -1);
+}
+
+/*!
+    \internal
+
+    Inserts the given \a contacts at their positions in the sort order, a range of rows at a time.
+ */
+void QDeclarativeContactModel::insertContacts(const QList<QDeclarativeContact*> &contacts)
+{
+    updateSortKeyOrders();
+
+    QList<QDeclarativeContact*> sortedContacts(contacts);
+    if (!d->m_sortKeyOrders.isEmpty()) {
+        std::stable_sort(sortedContacts.begin(), sortedContacts.end(),
+                         [this](QDeclarativeContact *a, QDeclarativeContact *b) {
+            return QContactManagerEngine::compareContact(contactSortKey(a), contactSortKey(b), d->m_sortKeyOrders) < 0;
+        });
+    }
+
+    // the rows the sorted contacts go to only grow, so that the contacts
+    // going between the same existing rows are inserted together
+    QList<int> indexes;
+    foreach (QDeclarativeContact *dc, sortedContacts)
+        indexes.append(contactIndex(contactSortKey(dc)));
+
+    int inserted = 0;
+    for (int first = 0; first < sortedContacts.count(); ) {
+        int last = first;
+        while (last + 1 < sortedContacts.count() && indexes.at(last + 1) == indexes.at(first))
+            ++last;
+        const int row = indexes.at(first) + inserted;
+        beginInsertRows(QModelIndex(), row, row + last - first);
+        for (int i = first; i <= last; ++i) {
+            QDeclarativeContact *dc = sortedContacts.at(i);
+            d->m_contacts.insert(row + i - first, dc);
+            d->m_contactMap.insert(dc->contact().id(), dc);
+        }
+        d->invalidateContactRows(row);
+        endInsertRows();
+        inserted += last - first + 1;
+        first = last + 1;
+    }
+}
+
+/*!
+    \internal
+
+    Removes the given \a rows from the model, a range of rows at a time, and returns their contacts.
+ */
+QList<QDeclarativeContact*> QDeclarativeContactModel::takeContactRows(QList<int> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    QList<QDeclarativeContact*> contacts;
+    for (int last = rows.count() - 1; last >= 0; ) {
+        int first = last;
+        while (first > 0 && rows.at(first - 1) == rows.at(first) - 1)
+            --first;
+        const int firstRow = rows.at(first);
+        const int lastRow = rows.at(last);
+        beginRemoveRows(QModelIndex(), firstRow, lastRow);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            QDeclarativeContact *dc = d->m_contacts.at(row);
+            const QContactId id = dc->contact().id();
+            d->m_contactMap.remove(id);
+            d->m_contactRows.remove(id);
+            d->m_sortKeys.remove(id);
+            contacts.append(dc);
+        }
+        d->m_contacts.erase(d->m_contacts.begin() + firstRow, d->m_contacts.begin() + lastRow + 1);
+        d->invalidateContactRows(firstRow);
+        endRemoveRows();
+        last = first - 1;
+    }
+    return contacts;
+}
+
+/*!
+    \internal
+
+    Starts fetching the ids of the rows of the paged mode.
+ */
+void QDeclarativeContactModel::fetchPagedIds()
+{
+    QList<QContactSortOrder> sortOrders;
+    foreach (QDeclarativeContactSortOrder* so, d->m_sortOrders) {
+        sortOrders.append(so->sortOrder());
+    }
+    QContactIdFetchRequest* idRequest = new QContactIdFetchRequest(this);
+    idRequest->setManager(d->m_manager);
+    idRequest->setSorting(sortOrders);
+    idRequest->setFilter(d->m_filter ? d->m_filter->filter() : QContactFilter());
+    connect(idRequest, SIGNAL(stateChanged(QContactAbstractRequest::State)),
+            this, SLOT(onPagedIdFetchRequestStateChanged(QContactAbstractRequest::State)));
+
+    // only the latest ids are wanted, and none of the contacts of the other mode
+    if (d->m_idFetchRequest) {
+        d->m_idFetchRequest->cancel();
+        d->m_idFetchRequest->deleteLater();
+    }
+    foreach (QContactFetchRequest *req, d->m_pendingRequests) {
+        req->cancel();
+        req->deleteLater();
+    }
+    d->m_pendingContacts.clear();
+    d->m_pendingRequests.clear();
+
+    d->m_idFetchRequest = idRequest;
+    idRequest->start();
+}
+
+/*!
+    \internal
+ */
+void QDeclarativeContactModel::onPagedIdFetchRequestStateChanged(QContactAbstractRequest::State state)
+{
+    if (state != QContactAbstractRequest::FinishedState)
+        return;
+
+    QContactIdFetchRequest *request = qobject_cast<QContactIdFetchRequest *>(sender());
+    Q_ASSERT(request);
+
+    if (request == d->m_idFetchRequest) {
+        d->m_updatePendingFlag &= ~QDeclarativeContactModelPrivate::UpdatingContactsPending;
+        d->m_idFetchRequest = 0;
+        checkError(request);
+        if (request->error() == QContactManager::NoError && d->m_pageSize > 0)
+            setPagedIds(request->ids());
+    }
+    request->deleteLater();
+}
+
+/*!
+    \internal
+
+    Updates the rows of the paged mode to be the contacts with the given \a ids, with as few
+    changes as possible so that the rows which stay keep their delegates.
+ */
+void QDeclarativeContactModel::setPagedIds(const QList<QContactId> &ids)
+{
+    const QSet<QContactId> newIds(ids.constBegin(), ids.constEnd());
+    bool changed = false;
+
+    // remove the rows which are gone, a range at a time
+    for (int last = d->m_pagedIds.count() - 1; last >= 0; ) {
+        if (newIds.contains(d->m_pagedIds.at(last))) {
+            --last;
+            continue;
+        }
+        int first = last;
+        while (first > 0 && !newIds.contains(d->m_pagedIds.at(first - 1)))
+            --first;
+        beginRemoveRows(QModelIndex(), first, last);
+        for (int row = first; row <= last; ++row) {
+            const QContactId &id = d->m_pagedIds.at(row);
+            QDeclarativeContact *dc = d->m_pagedContacts.take(id);
+            if (dc) {
+                d->m_pagedLastUse.remove(id);
+                dc->deleteLater();
+            }
+        }
+        d->m_pagedIds.erase(d->m_pagedIds.begin() + first, d->m_pagedIds.begin() + last + 1);
+        endRemoveRows();
+        changed = true;
+        last = first - 1;
+    }
+
+    // move the remaining rows if their order has changed
+    const QSet<QContactId> oldIds(d->m_pagedIds.constBegin(), d->m_pagedIds.constEnd());
+    QList<QContactId> orderedIds;
+    foreach (const QContactId &id, ids) {
+        if (oldIds.contains(id))
+            orderedIds.append(id);
+    }
+    if (orderedIds != d->m_pagedIds) {
+        emit layoutAboutToBeChanged();
+        QHash<QContactId, int> newRows;
+        for (int row = 0; row < orderedIds.count(); ++row)
+            newRows.insert(orderedIds.at(row), row);
+        const QModelIndexList oldIndexes = persistentIndexList();
+        QModelIndexList newIndexes;
+        foreach (const QModelIndex &oldIndex, oldIndexes)
+            newIndexes.append(index(newRows.value(d->m_pagedIds.at(oldIndex.row())), 0));
+        d->m_pagedIds = orderedIds;
+        changePersistentIndexList(oldIndexes, newIndexes);
+        emit layoutChanged();
+        changed = true;
+    }
+
+    // and insert the new rows, a range at a time
+    for (int first = 0; first < ids.count(); ) {
+        if (oldIds.contains(ids.at(first))) {
+            ++first;
+            continue;
+        }
+        int last = first;
+        while (last + 1 < ids.count() && !oldIds.contains(ids.at(last + 1)))
+            ++last;
+        beginInsertRows(QModelIndex(), first, last);
+        for (int row = first; row <= last; ++row)
+            d->m_pagedIds.insert(row, ids.at(row));
+        endInsertRows();
+        changed = true;
+        first = last + 1;
+    }
+
+    if (changed) {
+        d->m_pagedRows.clear();
+        for (int row = 0; row < d->m_pagedIds.count(); ++row)
+            d->m_pagedRows.insert(d->m_pagedIds.at(row), row);
+        emit contactsChanged();
+    }
+}
+
+/*!
+    \internal
+
+    Returns the contact of the given \a row of the paged mode, or 0 if it hasn't been fetched yet,
+    in which case the page of the row is queued for fetching.
+ */
+QDeclarativeContact* QDeclarativeContactModel::pagedContact(int row) const
+{
+    const QContactId &id = d->m_pagedIds.at(row);
+    const int page = row / d->m_pageSize;
+    QDeclarativeContact *dc = d->m_pagedContacts.value(id);
+    if (dc) {
+        d->m_pagedLastUse[id] = ++d->m_pagedUseCount;
+    } else {
+        // a row asked for again as soon as it was forgotten is still shown, so the views use more
+        // rows than are cached; grow the cache rather than fetch and forget the rows in turn
+        if (d->m_pagedForgottenIds.remove(id))
+            d->m_pagedCacheSize = qMax(d->m_pagedCacheSize, int(d->m_pagedLastUse.count())) + 1;
+        fetchPage(page);
+    }
+
+    // prefetch the neighbouring page that the view is getting closer to
+    const int offset = row % d->m_pageSize;
+    if (offset >= d->m_pageSize / 2)
+        fetchPage(page + 1);
+    else if (offset < d->m_pageSize / 4)
+        fetchPage(page - 1);
+    return dc;
+}
+
+/*!
+    \internal
+
+    Queues the rows of the given \a page which are neither fetched nor being fetched.
+ */
+void QDeclarativeContactModel::fetchPage(int page) const
+{
+    const int first = page * d->m_pageSize;
+    if (page < 0 || first >= d->m_pagedIds.count())
+        return;
+
+    const int end = qMin(first + d->m_pageSize, int(d->m_pagedIds.count()));
+    QList<QContactId> ids;
+    for (int row = first; row < end; ++row) {
+        const QContactId &id = d->m_pagedIds.at(row);
+        if (!d->m_pagedContacts.contains(id) && !d->m_pagedPendingIds.contains(id))
+            ids.append(id);
+    }
+    queuePagedContacts(ids);
+}
+
+/*!
+    \internal
+
+    Queues the contacts with the given \a ids to be fetched together once control returns to the
+    event loop.  They are not fetched straight away, as data() can't emit dataChanged().
+ */
+void QDeclarativeContactModel::queuePagedContacts(const QList<QContactId> &ids) const
+{
+    if (ids.isEmpty())
+        return;
+
+    if (d->m_pagedQueuedIds.isEmpty()) {
+        QMetaObject::invokeMethod(const_cast<QDeclarativeContactModel*>(this),
+                                  "fetchQueuedPagedContacts", Qt::QueuedConnection);
+    }
+    foreach (const QContactId &id, ids) {
+        d->m_pagedPendingIds.insert(id);
+        d->m_pagedQueuedIds.append(id);
+    }
+}
+
+/*!
+    \internal
+ */
+void QDeclarativeContactModel::fetchQueuedPagedContacts()
+{
+    if (d->m_pagedQueuedIds.isEmpty())
+        return;
+
+    QContactFetchByIdRequest *fetchRequest = new QContactFetchByIdRequest(this);
+    connect(fetchRequest, SIGNAL(stateChanged(QContactAbstractRequest::State)),
+            this, SLOT(onPageFetchRequestStateChanged(QContactAbstractRequest::State)));
+    fetchRequest->setManager(d->m_manager);
+    fetchRequest->setIds(d->m_pagedQueuedIds);
+    fetchRequest->setFetchHint(d->m_fetchHint ? d->m_fetchHint->fetchHint() : QContactFetchHint());
+    d->m_pagedQueuedIds.clear();
+    if (!fetchRequest->start()) {
+        foreach (const QContactId &id, fetchRequest->contactIds())
+            d->m_pagedPendingIds.remove(id);
+        checkError(fetchRequest);
+        fetchRequest->deleteLater();
+    }
+}
+
+/*!
+    \internal
+ */
+void QDeclarativeContactModel::onPageFetchRequestStateChanged(QContactAbstractRequest::State state)
+{
+    if (state != QContactAbstractRequest::FinishedState)
+        return;
+
+    QContactFetchByIdRequest *request = qobject_cast<QContactFetchByIdRequest *>(sender());
+    Q_ASSERT(request);
+
+    // the contacts removed since their page was queued are not an error
+    if (request->error() != QContactManager::DoesNotExistError)
+        checkError(request);
+
+    foreach (const QContactId &id, request->contactIds())
+        d->m_pagedPendingIds.remove(id);
+
+    QList<int> rows;
+    const quint64 requestUse = d->m_pagedUseCount + 1;
+    foreach (const QContact &contact, request->contacts()) {
+        const int row = d->m_pagedRows.value(contact.id(), -1);
+        if (contact.id().isNull() || row < 0 || d->m_pageSize == 0)
+            continue;
+        QDeclarativeContact *dc = d->m_pagedContacts.value(contact.id());
+        if (!dc) {
+            dc = new QDeclarativeContact(this);
+            d->m_pagedContacts.insert(contact.id(), dc);
         }
+        d->m_pagedLastUse.insert(contact.id(), ++d->m_pagedUseCount);
+        dc->setContact(contact);
+        rows.append(row);
+    }
+
+    // forget the least recently used rows, but never the ones just fetched; the forgotten rows
+    // are notified as well, so that the views don't keep using their deleted contacts
+    const int maxCount = qMax(d->m_pageSize * CONTACT_MODEL_CACHED_PAGES, d->m_pagedCacheSize);
+    d->m_pagedForgottenIds.clear();
+    if (d->m_pagedLastUse.count() > maxCount) {
+        QList<QPair<quint64, QContactId> > uses;
+        for (QHash<QContactId, quint64>::const_iterator it = d->m_pagedLastUse.constBegin(); it != d->m_pagedLastUse.constEnd(); ++it) {
+            if (it.value() < requestUse)
+                uses.append(qMakePair(it.value(), it.key()));
+        }
+        const int count = qMin(int(d->m_pagedLastUse.count()) - maxCount, int(uses.count()));
+        std::partial_sort(uses.begin(), uses.begin() + count, uses.end(),
+                          [](const QPair<quint64, QContactId> &a, const QPair<quint64, QContactId> &b) {
+                              return a.first < b.first;
+                          });
+        for (int i = 0; i < count; ++i) {
+            const QContactId &id = uses.at(i).second;
+            d->m_pagedLastUse.remove(id);
+            d->m_pagedContacts.take(id)->deleteLater();
+            d->m_pagedForgottenIds.insert(id);
+            const int row = d->m_pagedRows.value(id, -1);
+            if (row >= 0)
+                rows.append(row);
+        }
+    }
+
+    // notify the fetched and the forgotten rows, a range at a time
+    std::sort(rows.begin(), rows.end());
+    for (int i = 0; i < rows.count(); ) {
+        int j = i;
+        while (j + 1 < rows.count() && rows.at(j + 1) == rows.at(j) + 1)
+            ++j;
+        emit dataChanged(index(rows.at(i), 0), index(rows.at(j), 0));
+        i = j + 1;
+    }
+    request->deleteLater();
+}
+
+/*!
+    \internal
+ */
+void QDeclarativeContactModel::clearPagedContacts()
+{
+    if (d->m_idFetchRequest) {
+        d->m_idFetchRequest->cancel();
+        d->m_idFetchRequest->deleteLater();
+        d->m_idFetchRequest = 0;
     }
-    return d->m_contacts.size();
+    qDeleteAll(d->m_pagedContacts);
+    d->m_pagedContacts.clear();
+    d->m_pagedIds.clear();
+    d->m_pagedRows.clear();
+    d->m_pagedLastUse.clear();
+    d->m_pagedPendingIds.clear();
+    d->m_pagedQueuedIds.clear();
+    d->m_pagedForgottenIds.clear();
+    d->m_pagedCacheSize = 0;
 }
 
 QT_END_NAMESPACE
@@ -74,6 +74,7 @@ class QDeclarativeContactModel : public QAbstractListModel, public QQmlParserSta
     Q_PROPERTY(QQmlListProperty<QDeclarativeContact> contacts READ contacts NOTIFY contactsChanged)
     Q_PROPERTY(QQmlListProperty<QDeclarativeContactCollection> collections READ collections NOTIFY collectionsChanged)
     Q_PROPERTY(QQmlListProperty<QDeclarativeContactSortOrder> sortOrders READ sortOrders NOTIFY sortOrdersChanged)
+    Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
     Q_ENUMS(ExportError)
     Q_ENUMS(ImportError)
     Q_INTERFACES(QQmlParserStatus)
@@ -118,6 +119,9 @@ public:
     QDeclarativeContactFetchHint* fetchHint() const;
     void setFetchHint(QDeclarativeContactFetchHint* fetchHint);
 
+    int pageSize() const;
+    void setPageSize(int pageSize);
+
     // From QQmlParserStatus
     virtual void classBegin() {}
     virtual void componentComplete();
@@ -165,6 +169,7 @@ signals:
     void collectionsChanged();
     void sortOrdersChanged();
     void autoUpdateChanged();
+    void pageSizeChanged();
     void exportCompleted(ExportError error, QUrl url);
     void importCompleted(ImportError error, QUrl url, const QStringList &ids);
     void contactsFetched(int requestId, const QVariantList &fetchedContacts);
@@ -199,13 +204,33 @@ private slots:
     // handle fetch request from fetchContacts()
     void onFetchContactsRequestStateChanged(QContactAbstractRequest::State state);
 
+    // handle the requests of the paged mode
+    void fetchPagedIds();
+    void fetchQueuedPagedContacts();
+    void onPagedIdFetchRequestStateChanged(QContactAbstractRequest::State state);
+    void onPageFetchRequestStateChanged(QContactAbstractRequest::State state);
+
+    // handle fetch request from exportContacts() in the paged mode
+    void onExportFetchRequestStateChanged(QContactAbstractRequest::State state);
+
     void collectionsFetched();
 
 private:
     QContactFetchRequest *createContactFetchRequest(const QList<QContactId> &ids);
     void checkError(const QContactAbstractRequest *request);
     void updateError(QContactManager::Error error);
-    int contactIndex(const QDeclarativeContact* contact);
+    int contactIndex(const QContact &sortKey);
+    QContact contactSortKey(const QDeclarativeContact *contact);
+    void updateSortKeyOrders();
+    int contactRow(const QContactId &id);
+    void insertContacts(const QList<QDeclarativeContact*> &contacts);
+    QList<QDeclarativeContact*> takeContactRows(QList<int> rows);
+    QDeclarativeContact* pagedContact(int row) const;
+    void fetchPage(int page) const;
+    void queuePagedContacts(const QList<QContactId> &ids) const;
+    void setPagedIds(const QList<QContactId> &ids);
+    void clearPagedContacts();
+    ExportError writeContacts(const QList<QContact> &contacts, const QUrl &url, const QString &profile);
 
 private:
     QScopedPointer<QDeclarativeContactModelPrivate> d;
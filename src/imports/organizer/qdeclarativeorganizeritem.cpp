@@ -409,6 +409,20 @@ QOrganizerItem QDeclarativeOrganizerItem::item() const
     return item;
 }
 
+/*!
+    \internal
+
+    Returns the first detail of the given \a type, without copying the other details like item() does.
+ */
+QOrganizerItemDetail QDeclarativeOrganizerItem::itemDetail(int type) const
+{
+    foreach (QDeclarativeOrganizerItemDetail *detail, m_details) {
+        if (type == detail->type())
+            return detail->detail();
+    }
+    return QOrganizerItemDetail();
+}
+
 /*!
     \internal
  */
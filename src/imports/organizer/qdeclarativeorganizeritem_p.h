@@ -113,6 +113,7 @@ public:
     // non-QML APIs, used by model only
     void setItem(const QOrganizerItem &item);
     QOrganizerItem item() const;
+    QOrganizerItemDetail itemDetail(int type) const;
 
     bool generatedOccurrence() const;
 
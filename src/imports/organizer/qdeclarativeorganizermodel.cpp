@@ -50,6 +50,7 @@
 #include <QtOrganizer/qorganizeritemdetails.h>
 #include <QtOrganizer/qorganizeritemrequests.h>
 #include <QtOrganizer/qorganizermanager.h>
+#include <QtOrganizer/qorganizermanagerengine.h>
 
 #include <QtVersitOrganizer/qversitorganizerimporter.h>
 #include <QtVersitOrganizer/qversitorganizerexporter.h>
@@ -101,6 +102,8 @@ public:
         m_writer(0),
         m_startPeriod(QDateTime::currentDateTime()),
         m_endPeriod(QDateTime::currentDateTime()),
+        m_prefetchPeriods(0),
+        m_runningFetchStale(false),
         m_error(QOrganizerManager::NoError),
         m_autoUpdate(true),
         m_updatePendingFlag(QDeclarativeOrganizerModelPrivate::NonePending),
@@ -119,6 +122,8 @@ public:
 
     QList<QDeclarativeOrganizerItem*> m_items;
     QHash<QString, QDeclarativeOrganizerItem *> m_itemIdHash;
+    // The items last set to the declarative items by applyItems(), by item key
+    QHash<QString, QOrganizerItem> m_itemSnapshots;
     QOrganizerManager* m_manager;
     QDeclarativeOrganizerItemFetchHint* m_fetchHint;
     QList<QOrganizerItemSortOrder> m_sortOrders;
@@ -133,6 +138,18 @@ public:
     QVersitWriter *m_writer;
     QDateTime m_startPeriod;
     QDateTime m_endPeriod;
+    int m_prefetchPeriods;
+    // Whether the store has changed after the running item fetch requests were started
+    bool m_runningFetchStale;
+    // The items fetched for the period from m_fetchedStart to m_fetchedEnd, which covers the
+    // model period and the prefetched periods around it, and the parameters they were fetched with
+    QList<QOrganizerItem> m_fetchedItems;
+    QDateTime m_fetchedStart;
+    QDateTime m_fetchedEnd;
+    QOrganizerItemFilter m_fetchedFilter;
+    QList<QOrganizerItemSortOrder> m_fetchedSortOrders;
+    QOrganizerItemFetchHint m_fetchedFetchHint;
+    QList<QOrganizerItemFetchRequest *> m_periodFetchRequests;
     QList<QDeclarativeOrganizerCollection*> m_collections;
 
     QTimer m_updateTimer;
@@ -216,6 +233,7 @@ QDeclarativeOrganizerModel::QDeclarativeOrganizerModel(QObject *parent) :
     connect(this, &QDeclarativeOrganizerModel::sortOrdersChanged, &d_ptr->m_updateItemsTimer, static_cast<void (QTimer::*)(void)>(&QTimer::start));
     connect(this, &QDeclarativeOrganizerModel::startPeriodChanged, &d_ptr->m_updateItemsTimer, static_cast<void (QTimer::*)(void)>(&QTimer::start));
     connect(this, &QDeclarativeOrganizerModel::endPeriodChanged, &d_ptr->m_updateItemsTimer, static_cast<void (QTimer::*)(void)>(&QTimer::start));
+    connect(this, &QDeclarativeOrganizerModel::prefetchPeriodsChanged, &d_ptr->m_updateItemsTimer, static_cast<void (QTimer::*)(void)>(&QTimer::start));
 }
 
 QDeclarativeOrganizerModel::~QDeclarativeOrganizerModel()
@@ -325,6 +343,9 @@ void QDeclarativeOrganizerModel::update()
     if (!d->m_componentCompleted || d->m_updatePendingFlag)
         return;
 
+    // fetch the whole period again, not only the parts which have not been fetched yet
+    clearFetchedPeriod();
+
     // Disallow possible duplicate request triggering
     d->m_updatePendingFlag = (QDeclarativeOrganizerModelPrivate::UpdatingItemsPending | QDeclarativeOrganizerModelPrivate::UpdatingCollectionsPending);
     d->m_fetchCollectionsTimer.setProperty(MANUALLY_TRIGGERED_PROPERTY, QVariant::fromValue<bool>(true));
@@ -334,6 +355,8 @@ void QDeclarativeOrganizerModel::update()
 void QDeclarativeOrganizerModel::doUpdate()
 {
     Q_D(QDeclarativeOrganizerModel);
+    // the store has changed, so the fetched items cannot be reused
+    clearFetchedPeriod();
     if (d->m_autoUpdate)
         update();
 }
@@ -398,6 +421,14 @@ void QDeclarativeOrganizerModel::cancelUpdate()
         d->m_fetchRequest = 0;
         d->m_updatePendingFlag = QDeclarativeOrganizerModelPrivate::NonePending;
     }
+    if (!d->m_periodFetchRequests.isEmpty()) {
+        foreach (QOrganizerItemFetchRequest *request, d->m_periodFetchRequests) {
+            request->cancel();
+            request->deleteLater();
+        }
+        d->m_periodFetchRequests.clear();
+        d->m_updatePendingFlag = QDeclarativeOrganizerModelPrivate::NonePending;
+    }
 }
 /*!
   \qmlproperty date OrganizerModel::startPeriod
@@ -439,6 +470,40 @@ void QDeclarativeOrganizerModel::setEndPeriod(const QDateTime& end)
     }
 }
 
+/*!
+  \qmlproperty int OrganizerModel::prefetchPeriods
+
+  This property holds how many periods of the length of the model period, from \l startPeriod to
+  \l endPeriod, the organizer model fetches in advance before and after the model period.
+
+  When the model period is moved, the organizer model fetches only the parts of the new period
+  which have not been fetched yet, and drops the items which are no longer in or around it. With
+  prefetched periods, moving the model period e.g. a week or a month at a time in a calendar view
+  shows the items of the new period without waiting for the backend.
+  The default value is 0, which fetches only the model period.
+
+  \note The prefetched periods are fetched with the same requests as the model period. A backend
+  which limits the number of occurrences it generates for a recurring item in a single fetch, like
+  the memory backend which generates at most 50 occurrences of an item per request, counts the
+  occurrences in the prefetched periods against that limit as well, so frequently recurring items
+  may miss their later occurrences in the model period. Keep the number of prefetched periods
+  small with such a backend.
+  */
+int QDeclarativeOrganizerModel::prefetchPeriods() const
+{
+    Q_D(const QDeclarativeOrganizerModel);
+    return d->m_prefetchPeriods;
+}
+void QDeclarativeOrganizerModel::setPrefetchPeriods(int periods)
+{
+    Q_D(QDeclarativeOrganizerModel);
+    periods = qMax(0, periods);
+    if (periods != d->m_prefetchPeriods) {
+        d->m_prefetchPeriods = periods;
+        emit prefetchPeriodsChanged();
+    }
+}
+
 /*!
   \qmlproperty enumeration OrganizerModel::ImportError
 
@@ -581,6 +646,7 @@ void QDeclarativeOrganizerModel::setManager(const QString& managerName)
 
     if (d->m_manager) {
         cancelUpdate();
+        clearFetchedPeriod();
         d->m_updatePendingFlag = QDeclarativeOrganizerModelPrivate::NonePending;
         delete d->m_manager;
     }
@@ -1163,23 +1229,103 @@ QStringList QDeclarativeOrganizerModel::itemIds(const QDateTime &start, const QD
     return ids;
 }
 
+/*
+  Returns whether the given fetched item belongs to the period from start to end, like the item fetch
+  requests select them: a generated occurrence has to start in the period, and every item with an
+  id, including a persisted exception occurrence, has to overlap with the period.
+  */
+static bool isItemInPeriod(const QOrganizerItem &item, const QDateTime &start, const QDateTime &end)
+{
+    if (!item.id().isNull())
+        return QOrganizerManagerEngine::isItemBetweenDates(item, start, end);
+
+    QDateTime itemStart;
+    if (item.type() == QOrganizerItemType::TypeEventOccurrence) {
+        QOrganizerEventTime eventTime = item.detail(QOrganizerItemDetail::TypeEventTime);
+        itemStart = eventTime.startDateTime();
+    } else if (item.type() == QOrganizerItemType::TypeTodoOccurrence) {
+        QOrganizerTodoTime todoTime = item.detail(QOrganizerItemDetail::TypeTodoTime);
+        itemStart = todoTime.startDateTime();
+    } else {
+        return QOrganizerManagerEngine::isItemBetweenDates(item, start, end);
+    }
+
+    return itemStart.isNull() || (itemStart >= start && itemStart <= end);
+}
+
+/*
+  Sorts the given items like the item fetch requests sort them, by start time if no sort order is given.
+  */
+static void sortFetchedItems(QList<QOrganizerItem> *items, const QList<QOrganizerItemSortOrder> &sortOrders)
+{
+    if (sortOrders.isEmpty())
+        std::stable_sort(items->begin(), items->end(), QOrganizerManagerEngine::itemLessThan);
+    else
+        QOrganizerManagerEngine::sortItemsInPlace(items, sortOrders);
+}
+
 void QDeclarativeOrganizerModel::fetchAgain()
 {
     Q_D(QDeclarativeOrganizerModel);
     cancelUpdate();
 
+    const QOrganizerItemFilter filter = d->m_filter ? d->m_filter->filter() : QOrganizerItemFilter();
+    const QOrganizerItemFetchHint fetchHint = d->m_fetchHint ? d->m_fetchHint->fetchHint() : QOrganizerItemFetchHint();
+
+    // the period to have fetched: the model period and the prefetched periods around it
+    QDateTime fetchStart = d->m_startPeriod;
+    QDateTime fetchEnd = d->m_endPeriod;
+    const bool bounded = fetchStart.isValid() && fetchEnd.isValid() && fetchStart <= fetchEnd;
+    if (bounded && d->m_prefetchPeriods > 0) {
+        const qint64 prefetch = fetchStart.msecsTo(fetchEnd) * d->m_prefetchPeriods;
+        fetchStart = fetchStart.addMSecs(-prefetch);
+        fetchEnd = fetchEnd.addMSecs(prefetch);
+    }
+
+    if (bounded && d->m_fetchedStart.isValid()
+            && fetchStart <= d->m_fetchedEnd && fetchEnd >= d->m_fetchedStart
+            && filter == d->m_fetchedFilter && d->m_sortOrders == d->m_fetchedSortOrders
+            && fetchHint == d->m_fetchedFetchHint) {
+        // the period overlaps with the fetched one: drop the items which are no longer
+        // in the period and fetch only the parts of the period which have not been fetched yet
+        const QDateTime keptStart = qMax(fetchStart, d->m_fetchedStart);
+        const QDateTime keptEnd = qMin(fetchEnd, d->m_fetchedEnd);
+        if (keptStart != d->m_fetchedStart || keptEnd != d->m_fetchedEnd) {
+            QList<QOrganizerItem> keptItems;
+            foreach (const QOrganizerItem &item, d->m_fetchedItems) {
+                if (isItemInPeriod(item, keptStart, keptEnd))
+                    keptItems.append(item);
+            }
+            d->m_fetchedItems = keptItems;
+            d->m_fetchedStart = keptStart;
+            d->m_fetchedEnd = keptEnd;
+        }
+
+        d->m_runningFetchStale = false;
+        if (fetchStart < keptStart)
+            createPeriodFetchRequest(fetchStart, keptStart);
+        if (fetchEnd > keptEnd)
+            createPeriodFetchRequest(keptEnd, fetchEnd);
+        if (d->m_periodFetchRequests.isEmpty()) {
+            d->m_updatePendingFlag &= ~QDeclarativeOrganizerModelPrivate::UpdatingItemsPending;
+            applyFetchedItems();
+        } else {
+            // started only once all are created, as requests may finish already when started
+            foreach (QOrganizerItemFetchRequest *request, d->m_periodFetchRequests)
+                request->start();
+        }
+        return;
+    }
+
+    clearFetchedPeriod();
+    d->m_runningFetchStale = false;
     d->m_fetchRequest  = new QOrganizerItemFetchRequest(this);
     d->m_fetchRequest->setManager(d->m_manager);
     d->m_fetchRequest->setSorting(d->m_sortOrders);
-    d->m_fetchRequest->setStartDate(d->m_startPeriod);
-    d->m_fetchRequest->setEndDate(d->m_endPeriod);
-
-    if (d->m_filter){
-        d->m_fetchRequest->setFilter(d->m_filter->filter());
-    } else {
-        d->m_fetchRequest->setFilter(QOrganizerItemFilter());
-    }
-    d->m_fetchRequest->setFetchHint(d->m_fetchHint ? d->m_fetchHint->fetchHint() : QOrganizerItemFetchHint());
+    d->m_fetchRequest->setStartDate(fetchStart);
+    d->m_fetchRequest->setEndDate(fetchEnd);
+    d->m_fetchRequest->setFilter(filter);
+    d->m_fetchRequest->setFetchHint(fetchHint);
 
     connect(d->m_fetchRequest, SIGNAL(stateChanged(QOrganizerAbstractRequest::State)), this, SLOT(requestUpdated()));
     d->m_fetchRequest->start();
@@ -1211,60 +1357,323 @@ void QDeclarativeOrganizerModel::requestUpdated()
         return;
     }
 
+    if (ifr->error() == QOrganizerManager::NoError && !d->m_runningFetchStale
+            && ifr->startDate().isValid() && ifr->endDate().isValid()) {
+        // keep the items, so that moving the period later only fetches the parts not fetched yet
+        d->m_fetchedItems = items;
+        d->m_fetchedStart = ifr->startDate();
+        d->m_fetchedEnd = ifr->endDate();
+        d->m_fetchedFilter = ifr->filter();
+        d->m_fetchedSortOrders = ifr->sorting();
+        d->m_fetchedFetchHint = ifr->fetchHint();
+        applyFetchedItems();
+        return;
+    }
+
     if (!items.isEmpty() || !d->m_items.isEmpty() || d->m_initialUpdate) {
-        // full update: first go through new items and check if they
-        // existed earlier. if they did, use the existing declarative wrapper.
-        // otherwise create new declarative item.
-        // for occurrences new declarative item is always created.
-        QList<QDeclarativeOrganizerItem *> newList;
-        QHash<QString, QDeclarativeOrganizerItem *> newItemIdHash;
-        QHash<QString, QDeclarativeOrganizerItem *>::iterator iterator;
-        QOrganizerItem item;
-        QString idString;
-        QDeclarativeOrganizerItem *declarativeItem;
         d->m_initialUpdate = false;
+        applyItems(items);
+        d->m_modelChangedTimer.start();
+    }
+}
 
-        int i;
-        for (i = 0; i < items.size(); i++) {
-            item = items[i];
-            idString = item.id().toString();
-            if (item.id().isNull()) {
-                // this is occurrence
-                declarativeItem = createItem(item);
+/*
+  Returns the key identifying an item in the model: the item id, or for generated occurrences,
+  which have no id, the parent id and the original date of the occurrence.
+  */
+static QString itemKey(const QString &id, const QOrganizerItemParent &parent)
+{
+    if (!id.isEmpty())
+        return id;
+    return parent.parentId().toString() + QLatin1Char('/') + parent.originalDate().toString(Qt::ISODate);
+}
+
+static QString itemKey(const QOrganizerItem &item)
+{
+    return itemKey(item.id().toString(), item.detail(QOrganizerItemDetail::TypeParent));
+}
+
+static QString itemKey(const QDeclarativeOrganizerItem *item)
+{
+    return itemKey(item->itemId(), item->itemDetail(QOrganizerItemDetail::TypeParent));
+}
+
+/*
+  Returns for each of the given values whether it is part of a longest increasing subsequence of them.
+  */
+static QList<bool> longestIncreasingSubsequence(const QList<int> &values)
+{
+    QList<int> tails; // the index of the smallest last value of a subsequence of each length
+    QList<int> previous(values.size(), -1);
+    for (int i = 0; i < values.size(); ++i) {
+        int first = 0;
+        int count = tails.size();
+        while (count > 0) {
+            const int step = count / 2;
+            const int middle = first + step;
+            if (values.at(tails.at(middle)) < values.at(i)) {
+                first = middle + 1;
+                count -= step + 1;
             } else {
-                iterator = d->m_itemIdHash.find(idString);
-                if (iterator != d->m_itemIdHash.end()) {
-                    declarativeItem = iterator.value();
-                    declarativeItem->setItem(item);
-                } else {
-                    declarativeItem = createItem(item);
-                }
-                newItemIdHash.insert(idString, declarativeItem);
+                count = step;
             }
-            newList.append(declarativeItem);
         }
+        if (first > 0)
+            previous[i] = tails.at(first - 1);
+        if (first == tails.size())
+            tails.append(i);
+        else
+            tails[first] = i;
+    }
 
-        // go through old items and delete items, which are not part of the
-        // new item set. delete also all old occurrences.
-        for (i = 0; i < d->m_items.size(); i++) {
-            // FIXME: avoid unnecessary usage of item getter which copies all details...
-            if (d->m_items[i]->item().id().isNull()) {
-                d->m_items[i]->deleteLater();
-            } else {
-                iterator = newItemIdHash.find(d->m_items[i]->itemId());
-                if (iterator == newItemIdHash.end())
-                    d->m_items[i]->deleteLater();
+    QList<bool> result(values.size(), false);
+    for (int i = tails.isEmpty() ? -1 : tails.last(); i >= 0; i = previous.at(i))
+        result[i] = true;
+    return result;
+}
+
+/*
+  Updates the model to contain the given items, in the given order. The declarative items of the
+  items which were already in the model, including generated occurrences, are reused, and the rows
+  are changed with as few removes, moves and inserts as possible, so that views keep the delegates
+  of the items which stay in the model.
+  */
+void QDeclarativeOrganizerModel::applyItems(const QList<QOrganizerItem> &items)
+{
+    Q_D(QDeclarativeOrganizerModel);
+
+    QStringList keys;
+    QHash<QString, int> newRows;
+    foreach (const QOrganizerItem &item, items) {
+        const QString key = itemKey(item);
+        if (!newRows.contains(key))
+            newRows.insert(key, keys.size());
+        keys.append(key);
+    }
+
+    // find the new row of each old item, the items appearing twice are only kept once
+    QList<int> targets;
+    QSet<int> keptRows;
+    foreach (QDeclarativeOrganizerItem *declarativeItem, d->m_items) {
+        int target = newRows.value(itemKey(declarativeItem), -1);
+        if (keptRows.contains(target))
+            target = -1;
+        else if (target >= 0)
+            keptRows.insert(target);
+        targets.append(target);
+    }
+
+    // remove the items which are gone, a range at a time
+    for (int last = d->m_items.size() - 1; last >= 0; ) {
+        if (targets.at(last) >= 0) {
+            --last;
+            continue;
+        }
+        int first = last;
+        while (first > 0 && targets.at(first - 1) < 0)
+            --first;
+        beginRemoveRows(QModelIndex(), first, last);
+        for (int row = first; row <= last; ++row)
+            d->m_items.at(row)->deleteLater();
+        d->m_items.erase(d->m_items.begin() + first, d->m_items.begin() + last + 1);
+        targets.erase(targets.begin() + first, targets.begin() + last + 1);
+        endRemoveRows();
+        last = first - 1;
+    }
+
+    // move the items which are not part of the longest run already in the new order
+    // to follow the item preceding them in the new order
+    const QList<bool> inOrder = longestIncreasingSubsequence(targets);
+    QSet<int> inOrderTargets;
+    for (int row = 0; row < targets.size(); ++row) {
+        if (inOrder.at(row))
+            inOrderTargets.insert(targets.at(row));
+    }
+    QList<int> sortedTargets(targets);
+    std::sort(sortedTargets.begin(), sortedTargets.end());
+    for (int i = 0; i < sortedTargets.size(); ++i) {
+        if (inOrderTargets.contains(sortedTargets.at(i)))
+            continue;
+        const int from = targets.indexOf(sortedTargets.at(i));
+        const int destination = i > 0 ? targets.indexOf(sortedTargets.at(i - 1)) + 1 : 0;
+        if (destination == from || destination == from + 1)
+            continue;
+        const int to = from < destination ? destination - 1 : destination;
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), destination);
+        d->m_items.move(from, to);
+        targets.move(from, to);
+        endMoveRows();
+    }
+
+    // insert the new items, a range at a time
+    for (int first = 0; first < items.size(); ) {
+        if (keptRows.contains(first)) {
+            ++first;
+            continue;
+        }
+        int last = first;
+        while (last + 1 < items.size() && !keptRows.contains(last + 1))
+            ++last;
+        beginInsertRows(QModelIndex(), first, last);
+        for (int row = first; row <= last; ++row)
+            d->m_items.insert(row, createItem(items.at(row)));
+        endInsertRows();
+        first = last + 1;
+    }
+
+    // update the kept items which have changed
+    QHash<QString, QOrganizerItem> snapshots;
+    d->m_itemIdHash.clear();
+    for (int row = 0; row < items.size(); ++row) {
+        QDeclarativeOrganizerItem *declarativeItem = d->m_items.at(row);
+        const QOrganizerItem &item = items.at(row);
+        if (keptRows.contains(row)) {
+            QHash<QString, QOrganizerItem>::const_iterator snapshot = d->m_itemSnapshots.constFind(keys.at(row));
+            if (declarativeItem->modified() || snapshot == d->m_itemSnapshots.constEnd() || snapshot.value() != item) {
+                declarativeItem->setItem(item);
+                const QModelIndex idx = index(row, 0);
+                emit dataChanged(idx, idx);
             }
         }
-        beginResetModel();
-        d->m_items = newList;
-        endResetModel();
+        snapshots.insert(keys.at(row), item);
+        if (!item.id().isNull())
+            d->m_itemIdHash.insert(declarativeItem->itemId(), declarativeItem);
+    }
+    d->m_itemSnapshots = snapshots;
+}
+
+/*
+  Updates the model to contain the fetched items which are in the model period.
+  */
+void QDeclarativeOrganizerModel::applyFetchedItems()
+{
+    Q_D(QDeclarativeOrganizerModel);
+    QList<QOrganizerItem> items;
+    if (d->m_fetchedStart == d->m_startPeriod && d->m_fetchedEnd == d->m_endPeriod) {
+        items = d->m_fetchedItems;
+    } else {
+        foreach (const QOrganizerItem &item, d->m_fetchedItems) {
+            if (isItemInPeriod(item, d->m_startPeriod, d->m_endPeriod))
+                items.append(item);
+        }
+    }
 
-        d->m_itemIdHash = newItemIdHash;
+    if (!items.isEmpty() || !d->m_items.isEmpty() || d->m_initialUpdate) {
+        d->m_initialUpdate = false;
+        applyItems(items);
         d->m_modelChangedTimer.start();
     }
 }
 
+/*
+  Creates a request fetching the items from start to end with the parameters of the fetched items.
+  */
+void QDeclarativeOrganizerModel::createPeriodFetchRequest(const QDateTime &start, const QDateTime &end)
+{
+    Q_D(QDeclarativeOrganizerModel);
+    QOrganizerItemFetchRequest *request = new QOrganizerItemFetchRequest(this);
+    request->setManager(d->m_manager);
+    request->setSorting(d->m_fetchedSortOrders);
+    request->setStartDate(start);
+    request->setEndDate(end);
+    request->setFilter(d->m_fetchedFilter);
+    request->setFetchHint(d->m_fetchedFetchHint);
+    connect(request, SIGNAL(stateChanged(QOrganizerAbstractRequest::State)),
+            this, SLOT(onPeriodFetchRequestStateChanged(QOrganizerAbstractRequest::State)));
+    d->m_periodFetchRequests.append(request);
+}
+
+/*
+  Forgets the fetched items, e.g. when the store has changed, so that the next update fetches
+  the whole period.
+  */
+void QDeclarativeOrganizerModel::clearFetchedPeriod()
+{
+    Q_D(QDeclarativeOrganizerModel);
+    d->m_fetchedItems.clear();
+    d->m_fetchedStart = QDateTime();
+    d->m_fetchedEnd = QDateTime();
+    d->m_runningFetchStale = true;
+}
+
+/*
+  Adds the items of the parts of the period which had not been fetched yet to the fetched items,
+  once all the requests created by fetchAgain() have finished, and updates the model with them.
+  */
+void QDeclarativeOrganizerModel::onPeriodFetchRequestStateChanged(QOrganizerAbstractRequest::State state)
+{
+    Q_D(QDeclarativeOrganizerModel);
+    if (state != QOrganizerAbstractRequest::FinishedState)
+        return;
+
+    QOrganizerItemFetchRequest *request = qobject_cast<QOrganizerItemFetchRequest *>(sender());
+    Q_ASSERT(request);
+    checkError(request);
+    if (!d->m_periodFetchRequests.contains(request))
+        return;
+    foreach (QOrganizerItemFetchRequest *periodRequest, d->m_periodFetchRequests) {
+        if (!periodRequest->isFinished())
+            return;
+    }
+
+    const QList<QOrganizerItemFetchRequest *> requests = d->m_periodFetchRequests;
+    d->m_periodFetchRequests.clear();
+    d->m_updatePendingFlag &= ~QDeclarativeOrganizerModelPrivate::UpdatingItemsPending;
+
+    bool failed = d->m_runningFetchStale;
+    QDateTime fetchedStart = d->m_fetchedStart;
+    QDateTime fetchedEnd = d->m_fetchedEnd;
+    QList<QOrganizerItem> itemsBefore;
+    QList<QOrganizerItem> itemsAfter;
+    foreach (QOrganizerItemFetchRequest *periodRequest, requests) {
+        if (periodRequest->error() != QOrganizerManager::NoError) {
+            failed = true;
+        } else if (periodRequest->endDate() <= d->m_fetchedStart) {
+            itemsBefore = periodRequest->items();
+            fetchedStart = periodRequest->startDate();
+        } else {
+            itemsAfter = periodRequest->items();
+            fetchedEnd = periodRequest->endDate();
+        }
+        periodRequest->deleteLater();
+    }
+
+    if (failed) {
+        // fetch the whole period instead
+        clearFetchedPeriod();
+        d->m_updatePendingFlag |= QDeclarativeOrganizerModelPrivate::UpdatingItemsPending;
+        QMetaObject::invokeMethod(this, "fetchAgain", Qt::QueuedConnection);
+        return;
+    }
+
+    // the items overlapping with the period fetched earlier are fetched again, keep them once
+    QSet<QString> keys;
+    foreach (const QOrganizerItem &item, d->m_fetchedItems)
+        keys.insert(itemKey(item));
+    QList<QOrganizerItem> items;
+    foreach (const QOrganizerItem &item, itemsBefore) {
+        const QString key = itemKey(item);
+        if (!keys.contains(key)) {
+            keys.insert(key);
+            items.append(item);
+        }
+    }
+    items += d->m_fetchedItems;
+    foreach (const QOrganizerItem &item, itemsAfter) {
+        const QString key = itemKey(item);
+        if (!keys.contains(key)) {
+            keys.insert(key);
+            items.append(item);
+        }
+    }
+    sortFetchedItems(&items, d->m_fetchedSortOrders);
+
+    d->m_fetchedItems = items;
+    d->m_fetchedStart = fetchedStart;
+    d->m_fetchedEnd = fetchedEnd;
+    applyFetchedItems();
+}
+
 /*!
   \qmlmethod OrganizerModel::saveItem(OrganizerItem item)
 
@@ -1421,6 +1830,8 @@ void QDeclarativeOrganizerModel::removeItemsFromModel(const QList<QString> &item
 void QDeclarativeOrganizerModel::onItemsModified(const QList<QPair<QOrganizerItemId, QOrganizerManager::Operation> > &itemIds)
 {
     Q_D(QDeclarativeOrganizerModel);
+    // the fetched items are no longer up to date
+    clearFetchedPeriod();
     if (!d->m_autoUpdate)
         return;
 
@@ -1607,8 +2018,11 @@ void QDeclarativeOrganizerModel::onItemsModifiedFetchRequestStateChanged(QOrgani
             }
         }
 
-        if (emitSignal)
+        if (emitSignal) {
+            // the declarative items no longer match what applyItems() last set to them
+            d->m_itemSnapshots.clear();
             d->m_modelChangedTimer.start();
+        }
     }
     d->m_notifiedItems.remove(request);
     request->deleteLater();
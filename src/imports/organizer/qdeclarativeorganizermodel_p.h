@@ -72,6 +72,7 @@ class QDeclarativeOrganizerModel : public QAbstractListModel, public QQmlParserS
     Q_PROPERTY(bool autoUpdate READ autoUpdate WRITE setAutoUpdate NOTIFY autoUpdateChanged)
     Q_PROPERTY(QDateTime startPeriod READ startPeriod WRITE setStartPeriod NOTIFY startPeriodChanged)
     Q_PROPERTY(QDateTime endPeriod READ endPeriod WRITE setEndPeriod NOTIFY endPeriodChanged)
+    Q_PROPERTY(int prefetchPeriods READ prefetchPeriods WRITE setPrefetchPeriods NOTIFY prefetchPeriodsChanged)
     Q_PROPERTY(QDeclarativeOrganizerItemFilter* filter READ filter WRITE setFilter NOTIFY filterChanged)
     Q_PROPERTY(QDeclarativeOrganizerItemFetchHint* fetchHint READ fetchHint WRITE setFetchHint NOTIFY fetchHintChanged)
     Q_PROPERTY(QQmlListProperty<QDeclarativeOrganizerItemSortOrder> sortOrders READ sortOrders NOTIFY sortOrdersChanged)
@@ -123,6 +124,9 @@ public:
     QDateTime endPeriod() const;
     void setEndPeriod(const QDateTime& end);
 
+    int prefetchPeriods() const;
+    void setPrefetchPeriods(int periods);
+
     // From QQmlParserStatus
     virtual void classBegin() {}
     virtual void componentComplete();
@@ -182,6 +186,7 @@ signals:
     void errorChanged();
     void startPeriodChanged();
     void endPeriodChanged();
+    void prefetchPeriodsChanged();
     void autoUpdateChanged();
     void collectionsChanged();
     void itemsFetched(int requestId, const QVariantList &fetchedItems);
@@ -200,6 +205,9 @@ private slots:
     void fetchAgain();
     void requestUpdated();
 
+    // handle the fetch requests of the parts of the period not fetched yet
+    void onPeriodFetchRequestStateChanged(QOrganizerAbstractRequest::State state);
+
     // handle request from saveItem(), removeItem(), saveCollection(), and removeCollection()
     void onRequestStateChanged(QOrganizerAbstractRequest::State newState);
 
@@ -222,6 +230,10 @@ private:
     void removeItemsFromModel(const QList<QString>& ids);
     bool itemHasRecurrence(const QOrganizerItem& oi) const;
     QDeclarativeOrganizerItem* createItem(const QOrganizerItem& item);
+    void applyItems(const QList<QOrganizerItem> &items);
+    void applyFetchedItems();
+    void createPeriodFetchRequest(const QDateTime &start, const QDateTime &end);
+    void clearFetchedPeriod();
     void checkError(const QOrganizerAbstractRequest *request);
 
     static int  item_count(QQmlListProperty<QDeclarativeOrganizerItem> *p);
@@ -39,6 +39,7 @@ PRIVATE_HEADERS += \
     qorganizeritem_p.h \
     qorganizeritemdetail_p.h \
     qorganizeritemfilter_p.h \
+    qorganizeritemfilterprogram_p.h \
     qorganizeritemfetchhint_p.h \
     qorganizermanager_p.h \
     qorganizerrecurrencerule_p.h \
@@ -54,6 +55,7 @@ SOURCES += \
     qorganizeritemdetail.cpp \
     qorganizeritemfetchhint.cpp \
     qorganizeritemfilter.cpp \
+    qorganizeritemfilterprogram.cpp \
     qorganizeritemid.cpp \
     qorganizeritemobserver.cpp \
     qorganizermanager.cpp \
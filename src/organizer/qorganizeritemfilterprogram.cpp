@@ -0,0 +1,422 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtOrganizer module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+
+#include "qorganizeritemfilterprogram_p.h"
+
+#include <algorithm>
+
+#include "qorganizeritemfilters.h"
+#include "qorganizermanagerengine.h"
+
+QT_BEGIN_NAMESPACE_ORGANIZER
+
+/*
+    Constructs a program which matches every item, like a default
+    constructed QOrganizerItemFilter.
+*/
+QOrganizerItemFilterProgram::QOrganizerItemFilterProgram()
+{
+    m_root = addConstant(true);
+}
+
+/*
+    Compiles \a filter into a program.
+*/
+QOrganizerItemFilterProgram::QOrganizerItemFilterProgram(const QOrganizerItemFilter &filter)
+{
+    m_root = compile(filter);
+}
+
+/*
+    Returns true if \a item matches the compiled filter.
+*/
+bool QOrganizerItemFilterProgram::matches(const QOrganizerItem &item) const
+{
+    return evaluate(m_root, item);
+}
+
+/*
+    Returns true if the compiled filter matches any item without looking at it.
+*/
+bool QOrganizerItemFilterProgram::matchesAll() const
+{
+    return m_nodes.at(m_root).operation == MatchAll;
+}
+
+/*
+    Returns true if the compiled filter cannot match any item.
+*/
+bool QOrganizerItemFilterProgram::matchesNone() const
+{
+    return m_nodes.at(m_root).operation == MatchNone;
+}
+
+int QOrganizerItemFilterProgram::addNode(const Node &node)
+{
+    m_nodes.append(node);
+    return m_nodes.size() - 1;
+}
+
+int QOrganizerItemFilterProgram::addConstant(bool value)
+{
+    Node node;
+    node.operation = value ? MatchAll : MatchNone;
+    return addNode(node);
+}
+
+int QOrganizerItemFilterProgram::compile(const QOrganizerItemFilter &filter)
+{
+    switch (filter.type()) {
+    case QOrganizerItemFilter::InvalidFilter:
+        return addConstant(false);
+
+    case QOrganizerItemFilter::DefaultFilter:
+        return addConstant(true);
+
+    case QOrganizerItemFilter::IdFilter:
+        {
+            const QOrganizerItemIdFilter idf(filter);
+            Node node;
+            node.operation = MatchIds;
+            const QList<QOrganizerItemId> ids = idf.ids();
+            node.ids = QSet<QOrganizerItemId>(ids.constBegin(), ids.constEnd());
+            if (node.ids.isEmpty())
+                return addConstant(false);
+            node.cost = 1;
+            return addNode(node);
+        }
+
+    case QOrganizerItemFilter::DetailFilter:
+        {
+            const QOrganizerItemDetailFilter cdf(filter);
+            Node node;
+            node.detail = cdf.detail();
+            if (node.detail.isEmpty() || node.detail.type() == QOrganizerItemDetail::TypeUndefined)
+                return addConstant(false);
+            node.operation = MatchDetail;
+            node.detailType = node.detail.type();
+            node.cost = 4;
+            return addNode(node);
+        }
+
+    case QOrganizerItemFilter::DetailFieldFilter:
+        return compileFieldFilter(filter);
+
+    case QOrganizerItemFilter::DetailRangeFilter:
+        return compileRangeFilter(filter);
+
+    case QOrganizerItemFilter::IntersectionFilter:
+        return compileComposite(MatchIntersection, QOrganizerItemIntersectionFilter(filter).filters());
+
+    case QOrganizerItemFilter::UnionFilter:
+        return compileComposite(MatchUnion, QOrganizerItemUnionFilter(filter).filters());
+
+    case QOrganizerItemFilter::CollectionFilter:
+        {
+            const QOrganizerItemCollectionFilter cf(filter);
+            Node node;
+            node.operation = MatchCollections;
+            node.collectionIds = cf.collectionIds();
+            if (node.collectionIds.isEmpty())
+                return addConstant(false);
+            node.cost = 1;
+            return addNode(node);
+        }
+    }
+
+    return addConstant(false);
+}
+
+int QOrganizerItemFilterProgram::compileFieldFilter(const QOrganizerItemFilter &filter)
+{
+    const QOrganizerItemDetailFieldFilter cdf(filter);
+    if (cdf.detailType() == QOrganizerItemDetail::TypeUndefined)
+        return addConstant(false);
+
+    Node node;
+    node.detailType = cdf.detailType();
+    node.field = cdf.detailField();
+
+    /* See if we need to check the values */
+    if (node.field == -1) {
+        node.operation = MatchDetailPresence;
+        node.cost = 2;
+        return addNode(node);
+    }
+
+    if (!cdf.value().isValid()) {
+        node.operation = MatchFieldPresence;
+        node.cost = 3;
+        return addNode(node);
+    }
+
+    node.matchType = cdf.matchFlags() & 7;
+    node.caseSensitivity = (cdf.matchFlags() & QOrganizerItemFilter::MatchCaseSensitive) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    if (cdf.matchFlags() & (QOrganizerItemFilter::MatchEndsWith | QOrganizerItemFilter::MatchStartsWith | QOrganizerItemFilter::MatchContains | QOrganizerItemFilter::MatchFixedString)) {
+        node.operation = MatchString;
+        node.needle = cdf.value().toString();
+        node.cost = 6;
+    } else {
+        node.operation = MatchVariant;
+        node.value = cdf.value();
+        node.cost = 4;
+    }
+    return addNode(node);
+}
+
+int QOrganizerItemFilterProgram::compileRangeFilter(const QOrganizerItemFilter &filter)
+{
+    const QOrganizerItemDetailRangeFilter cdf(filter);
+    if (cdf.detailType() == QOrganizerItemDetail::TypeUndefined)
+        return addConstant(false); /* we do not know which field to check */
+
+    Node node;
+    node.detailType = cdf.detailType();
+    node.field = cdf.detailField();
+
+    if (node.field == -1) {
+        node.operation = MatchDetailPresence;
+        node.cost = 2;
+        return addNode(node);
+    }
+
+    if (!cdf.minValue().isValid() && !cdf.maxValue().isValid()) {
+        node.operation = MatchRangeFieldPresence;
+        node.cost = 3;
+        return addNode(node);
+    }
+
+    /* open or closed interval testing support */
+    node.minComp = cdf.rangeFlags() & QOrganizerItemDetailRangeFilter::ExcludeLower ? 1 : 0;
+    node.maxComp = cdf.rangeFlags() & QOrganizerItemDetailRangeFilter::IncludeUpper ? 1 : 0;
+    node.testMin = cdf.minValue().isValid();
+    node.testMax = cdf.maxValue().isValid();
+    node.matchType = cdf.matchFlags() & 7;
+    node.caseSensitivity = (cdf.matchFlags() & QOrganizerItemFilter::MatchCaseSensitive) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    if (cdf.matchFlags() & (QOrganizerItemFilter::MatchEndsWith | QOrganizerItemFilter::MatchStartsWith | QOrganizerItemFilter::MatchContains | QOrganizerItemFilter::MatchFixedString)) {
+        /* Min/Max and contains do not make sense */
+        if (node.matchType == QOrganizerItemFilter::MatchContains)
+            return addConstant(false);
+        node.operation = MatchStringRange;
+        node.minString = cdf.minValue().toString();
+        node.maxString = cdf.maxValue().toString();
+        node.cost = 6;
+    } else {
+        node.operation = MatchVariantRange;
+        node.value = cdf.minValue();
+        node.maxValue = cdf.maxValue();
+        node.cost = 5;
+    }
+    return addNode(node);
+}
+
+int QOrganizerItemFilterProgram::compileComposite(Operation operation, const QList<QOrganizerItemFilter> &terms)
+{
+    const bool intersection = (operation == MatchIntersection);
+    if (terms.isEmpty())
+        return addConstant(false);
+
+    QList<int> children;
+    int cost = 0;
+    foreach (const QOrganizerItemFilter &term, terms) {
+        const int index = compile(term);
+        const Node &child = m_nodes.at(index);
+
+        /* Fold away the terms which cannot change the result, and stop at one which decides it */
+        if (child.operation == (intersection ? MatchNone : MatchAll))
+            return addConstant(!intersection);
+        if (child.operation == (intersection ? MatchAll : MatchNone))
+            continue;
+
+        cost += child.cost;
+        if (child.operation == operation)
+            children.append(child.children);
+        else
+            children.append(index);
+    }
+
+    if (children.isEmpty())
+        return addConstant(intersection);
+    if (children.size() == 1)
+        return children.first();
+
+    /* Evaluation has no side effects, so the cheapest and most selective terms can go first */
+    std::stable_sort(children.begin(), children.end(), [this](int left, int right) {
+        return m_nodes.at(left).cost < m_nodes.at(right).cost;
+    });
+
+    Node node;
+    node.operation = operation;
+    node.children = children;
+    node.cost = cost;
+    return addNode(node);
+}
+
+bool QOrganizerItemFilterProgram::evaluate(int index, const QOrganizerItem &item) const
+{
+    const Node &node = m_nodes.at(index);
+    switch (node.operation) {
+    case MatchNone:
+        return false;
+
+    case MatchAll:
+        return true;
+
+    case MatchIds:
+        return node.ids.contains(item.id());
+
+    case MatchCollections:
+        return node.collectionIds.contains(item.collectionId());
+
+    case MatchIntersection:
+        foreach (int child, node.children) {
+            if (!evaluate(child, item))
+                return false;
+        }
+        return true;
+
+    case MatchUnion:
+        foreach (int child, node.children) {
+            if (evaluate(child, item))
+                return true;
+        }
+        return false;
+
+    default:
+        return evaluateDetails(node, item);
+    }
+}
+
+bool QOrganizerItemFilterProgram::evaluateDetails(const Node &node, const QOrganizerItem &item) const
+{
+    /* See if this organizer item has one of these details in it */
+    const QList<QOrganizerItemDetail> details = item.details(node.detailType);
+    if (details.isEmpty())
+        return false; /* can't match */
+
+    switch (node.operation) {
+    case MatchDetail:
+        foreach (const QOrganizerItemDetail &detail, details) {
+            if (detail == node.detail)
+                return true;
+        }
+        return false;
+
+    case MatchDetailPresence:
+        return true;
+
+    case MatchFieldPresence:
+        foreach (const QOrganizerItemDetail &detail, details) {
+            /* Check that the field is present and has a non-empty value */
+            if (detail.hasValue(node.field) && !detail.value(node.field).isNull())
+                return true;
+        }
+        return false;
+
+    case MatchRangeFieldPresence:
+        foreach (const QOrganizerItemDetail &detail, details) {
+            if (detail.hasValue(node.field))
+                return true;
+        }
+        return false;
+
+    case MatchString:
+        foreach (const QOrganizerItemDetail &detail, details) {
+            const QString var = detail.value(node.field).toString();
+            if (node.matchType == QOrganizerItemFilter::MatchStartsWith && var.startsWith(node.needle, node.caseSensitivity))
+                return true;
+            if (node.matchType == QOrganizerItemFilter::MatchEndsWith && var.endsWith(node.needle, node.caseSensitivity))
+                return true;
+            if (node.matchType == QOrganizerItemFilter::MatchContains && var.contains(node.needle, node.caseSensitivity))
+                return true;
+            if (QString::compare(var, node.needle, node.caseSensitivity) == 0)
+                return true;
+        }
+        return false;
+
+    case MatchVariant:
+        foreach (const QOrganizerItemDetail &detail, details) {
+            const QVariant var = detail.value(node.field);
+            if (!var.isNull() && QOrganizerManagerEngine::compareVariant(var, node.value, node.caseSensitivity) == 0)
+                return true;
+        }
+        return false;
+
+    case MatchStringRange:
+        /* Starts with is the normal compare case, endsWith is a bit trickier */
+        foreach (const QOrganizerItemDetail &detail, details) {
+            const QString var = detail.value(node.field).toString();
+            if (node.matchType != QOrganizerItemFilter::MatchEndsWith) {
+                // MatchStarts or MatchFixedString
+                if (node.testMin && QString::compare(var, node.minString, node.caseSensitivity) < node.minComp)
+                    continue;
+                if (node.testMax && QString::compare(var, node.maxString, node.caseSensitivity) >= node.maxComp)
+                    continue;
+                return true;
+            } else {
+                /* Have to test the length of min & max */
+                // using refs means the parameter order is backwards, so negate the result of compare
+                if (node.testMin && -QString::compare(node.minString, var.right(node.minString.length()), node.caseSensitivity) < node.minComp)
+                    continue;
+                if (node.testMax && -QString::compare(node.maxString, var.right(node.maxString.length()), node.caseSensitivity) >= node.maxComp)
+                    continue;
+                return true;
+            }
+        }
+        return false;
+
+    case MatchVariantRange:
+        foreach (const QOrganizerItemDetail &detail, details) {
+            const QVariant var = detail.value(node.field);
+            if (node.testMin && QOrganizerManagerEngine::compareVariant(var, node.value, node.caseSensitivity) < node.minComp)
+                continue;
+            if (node.testMax && QOrganizerManagerEngine::compareVariant(var, node.maxValue, node.caseSensitivity) >= node.maxComp)
+                continue;
+            return true;
+        }
+        return false;
+
+    default:
+        break;
+    }
+    return false;
+}
+
+QT_END_NAMESPACE_ORGANIZER
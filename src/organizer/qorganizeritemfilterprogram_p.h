@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtOrganizer module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+
+#ifndef QORGANIZERITEMFILTERPROGRAM_P_H
+#define QORGANIZERITEMFILTERPROGRAM_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qlist.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+
+#include <QtOrganizer/qorganizercollectionid.h>
+#include <QtOrganizer/qorganizeritem.h>
+#include <QtOrganizer/qorganizeritemdetail.h>
+#include <QtOrganizer/qorganizeritemfilter.h>
+#include <QtOrganizer/qorganizeritemid.h>
+
+QT_BEGIN_NAMESPACE_ORGANIZER
+
+/*
+    A QOrganizerItemFilter compiled into a flat evaluation plan, the
+    organizer counterpart of QContactFilterProgram.
+
+    The filter tree is walked once, the operands are extracted from the
+    filter wrappers and trivially true or false branches are folded away.
+    The terms of intersections and unions are ordered so that the cheap and
+    most selective tests run first.  matches() gives exactly the same result
+    as QOrganizerManagerEngine::testFilter() for the original filter.
+*/
+class Q_ORGANIZER_EXPORT QOrganizerItemFilterProgram
+{
+public:
+    QOrganizerItemFilterProgram();
+    explicit QOrganizerItemFilterProgram(const QOrganizerItemFilter &filter);
+
+    bool matches(const QOrganizerItem &item) const;
+
+    bool matchesAll() const;
+    bool matchesNone() const;
+
+private:
+    enum Operation {
+        MatchNone,
+        MatchAll,
+        MatchIds,
+        MatchCollections,
+        MatchDetail,
+        MatchDetailPresence,
+        MatchFieldPresence,
+        MatchString,
+        MatchVariant,
+        MatchRangeFieldPresence,
+        MatchStringRange,
+        MatchVariantRange,
+        MatchIntersection,
+        MatchUnion
+    };
+
+    struct Node {
+        Node() : operation(MatchNone), detailType(QOrganizerItemDetail::TypeUndefined), field(-1),
+                 matchType(0), caseSensitivity(Qt::CaseInsensitive),
+                 minComp(0), maxComp(0), testMin(false), testMax(false), cost(0) {}
+
+        Operation operation;
+
+        // detail, field and range tests
+        QOrganizerItemDetail::DetailType detailType;
+        QOrganizerItemDetail detail;
+        int field;
+        int matchType;
+        Qt::CaseSensitivity caseSensitivity;
+        QString needle;
+        QVariant value;       // variant operand, or the minimum of a range
+        QVariant maxValue;
+        QString minString;
+        QString maxString;
+        int minComp;
+        int maxComp;
+        bool testMin;
+        bool testMax;
+
+        // id and collection tests
+        QSet<QOrganizerItemId> ids;
+        QSet<QOrganizerCollectionId> collectionIds;
+
+        // intersections and unions
+        QList<int> children;
+
+        int cost;
+    };
+
+    int compile(const QOrganizerItemFilter &filter);
+    int compileFieldFilter(const QOrganizerItemFilter &filter);
+    int compileRangeFilter(const QOrganizerItemFilter &filter);
+    int compileComposite(Operation operation, const QList<QOrganizerItemFilter> &terms);
+    int addConstant(bool value);
+    int addNode(const Node &node);
+
+    bool evaluate(int index, const QOrganizerItem &item) const;
+    bool evaluateDetails(const Node &node, const QOrganizerItem &item) const;
+
+    QList<Node> m_nodes;
+    int m_root;
+};
+
+QT_END_NAMESPACE_ORGANIZER
+
+#endif // QORGANIZERITEMFILTERPROGRAM_P_H
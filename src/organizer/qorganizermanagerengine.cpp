@@ -44,6 +44,8 @@
 #include "qorganizeritemrequests.h"
 #include "qorganizeritemrequests_p.h"
 
+#include <algorithm>
+
 #include <QtCore/qmutex.h>
 
 QT_BEGIN_NAMESPACE_ORGANIZER
@@ -1248,6 +1250,145 @@ int QOrganizerManagerEngine::addSorted(QList<QOrganizerItem> *sorted, const QOrg
     return it - sorted->begin();
 }
 
+/*
+    The values of one sort order, extracted once per item so that sorting doesn't
+    have to look up and copy the item details in every comparison.  compareAt()
+    gives the same results as compareItem() for a single sort order.
+*/
+class OrganizerItemSortColumn
+{
+public:
+    OrganizerItemSortColumn(const QList<QOrganizerItem> &items, const QOrganizerItemSortOrder &sortOrder)
+        : m_sortOrder(sortOrder)
+        , m_presenceTest(sortOrder.detailField() == -1)
+    {
+        const QOrganizerItemDetail::DetailType detailType = sortOrder.detailType();
+        const int detailField = sortOrder.detailField();
+
+        if (m_presenceTest) {
+            m_detailCounts.reserve(items.size());
+            foreach (const QOrganizerItem &item, items)
+                m_detailCounts.append(item.details(detailType).size());
+            return;
+        }
+
+        // obtain the values which this sort order concerns; empty strings are treated as null.
+        m_values.reserve(items.size());
+        m_blanks.reserve(items.size());
+        foreach (const QOrganizerItem &item, items) {
+            const QOrganizerItemDetail detail = item.detail(detailType);
+            const QVariant value = detail.value(detailField);
+            m_values.append(value);
+            m_blanks.append((value.metaType().id() == QMetaType::QString && value.toString().isEmpty()) || value.isNull());
+        }
+    }
+
+    // returns the comparison of the items at a and b, and sets decided if the
+    // remaining sort orders must not be consulted (as compareItem() does).
+    int compareAt(int a, int b, bool *decided) const
+    {
+        *decided = true;
+        if (m_presenceTest) {
+            const int aCount = m_detailCounts.at(a);
+            const int bCount = m_detailCounts.at(b);
+            if (aCount == bCount) {
+                *decided = false;
+                return 0;
+            }
+            if (aCount == 0)
+                return m_sortOrder.blankPolicy() == QOrganizerItemSortOrder::BlanksFirst ? -1 : 1;
+            if (bCount == 0)
+                return m_sortOrder.blankPolicy() == QOrganizerItemSortOrder::BlanksFirst ? 1 : -1;
+            return 0;
+        }
+
+        const bool aIsNull = m_blanks.at(a);
+        const bool bIsNull = m_blanks.at(b);
+        if (aIsNull && bIsNull) {
+            *decided = false;
+            return 0;
+        }
+        if (aIsNull)
+            return (m_sortOrder.blankPolicy() == QOrganizerItemSortOrder::BlanksFirst ? -1 : 1);
+        if (bIsNull)
+            return (m_sortOrder.blankPolicy() == QOrganizerItemSortOrder::BlanksFirst ? 1 : -1);
+
+        const int comparison = QOrganizerManagerEngine::compareVariant(m_values.at(a), m_values.at(b), m_sortOrder.caseSensitivity())
+                * (m_sortOrder.direction() == Qt::AscendingOrder ? 1 : -1);
+        *decided = comparison != 0;
+        return comparison;
+    }
+
+private:
+    QOrganizerItemSortOrder m_sortOrder;
+    bool m_presenceTest;
+    QList<int> m_detailCounts;
+    QList<bool> m_blanks;
+    QList<QVariant> m_values;
+};
+
+/*!
+    A functor that returns true iff the item at index \a a is less than the one
+    at index \a b, according to the sort \a columns passed in to the ctor.
+*/
+class OrganizerItemSortColumnsLessThan
+{
+    const QList<OrganizerItemSortColumn> &m_columns;
+
+public:
+    inline OrganizerItemSortColumnsLessThan(const QList<OrganizerItemSortColumn> &columns)
+        : m_columns(columns)
+    {}
+
+    inline bool operator()(int a, int b) const
+    {
+        bool decided = false;
+        for (int i = 0; i < m_columns.size(); ++i) {
+            const int comparison = m_columns.at(i).compareAt(a, b, &decided);
+            if (decided)
+                return comparison < 0;
+        }
+        return false;
+    }
+};
+
+/*!
+    Sorts the \a items list in place, according to the provided \a sortOrders.
+
+    The result is the same as inserting each item with addSorted(), and items which are equal
+    according to all sort orders keep their relative order.  However, the values each sort order
+    concerns are extracted only once per item, so this should be preferred over repeated calls
+    to addSorted() when sorting many items.
+
+    The first one in the \a sortOrders list has the highest priority.
+ */
+void QOrganizerManagerEngine::sortItemsInPlace(QList<QOrganizerItem> *items, const QList<QOrganizerItemSortOrder> &sortOrders)
+{
+    if (items->size() < 2)
+        return;
+
+    QList<OrganizerItemSortColumn> columns;
+    foreach (const QOrganizerItemSortOrder &sortOrder, sortOrders) {
+        if (!sortOrder.isValid())
+            break;
+        columns.append(OrganizerItemSortColumn(*items, sortOrder));
+    }
+    if (columns.isEmpty())
+        return;
+
+    QList<int> order;
+    order.reserve(items->size());
+    for (int i = 0; i < items->size(); ++i)
+        order.append(i);
+    std::stable_sort(order.begin(), order.end(), OrganizerItemSortColumnsLessThan(columns));
+
+    QList<QOrganizerItem> sorted;
+    sorted.reserve(items->size());
+    foreach (int index, order)
+        sorted.append(items->at(index));
+    *items = sorted;
+}
+
 /*!
     Insert \a toAdd to the \a defaultSorted map. If \a toAdd does not have valid start or end date,
     returns false and does not insert \a toAdd to \a defaultSorted map.
@@ -1402,11 +1543,13 @@ QList<QDateTime> QOrganizerManagerEngine::generateDateTimes(const QDateTime &ini
         realPeriodEnd.setTime(QTime(23,59,59,999)); // the last instant of the limit date, since it's prior to the periodEnd.
     }
 
+    // no date before the initial date can match, so start from the first period which
+    // overlaps both the requested period and the recurrence.
     QDate nextDate;
     if (rrule.limitType() == QOrganizerRecurrenceRule::CountLimit)
         nextDate = localInitialDateTime.date();
     else
-        nextDate = localPeriodStart.date();
+        nextDate = qMax(localPeriodStart.date(), localInitialDateTime.date());
 
     inferMissingCriteria(&rrule, localInitialDateTime.date());
     int countLimitDates = 0;
@@ -1537,14 +1680,12 @@ bool QOrganizerManagerEngine::inMultipleOfInterval(const QDate &date, const QDat
         case QOrganizerRecurrenceRule::Weekly: {
             // we need to adjust for the week start specified by the client if the interval is greater than 1
             // ie, every time we hit the day specified, we increment the week count.
-            uint weekCount = 0;
-            QDate tempDate = initialDate;
-            while (tempDate < date) {
-                tempDate = tempDate.addDays(1);
-                if (static_cast<Qt::DayOfWeek>(tempDate.dayOfWeek()) == firstDayOfWeek) {
-                    weekCount += 1;
-                }
-            }
+            // The first such day after initialDate is firstWeekStart days after it, and there is one every 7 days.
+            const qint64 daysDelta = initialDate.daysTo(date);
+            int firstWeekStart = (firstDayOfWeek - initialDate.dayOfWeek() + 7) % 7;
+            if (firstWeekStart == 0)
+                firstWeekStart = 7;
+            const uint weekCount = daysDelta >= firstWeekStart ? uint((daysDelta - firstWeekStart) / 7 + 1) : 0;
             return (weekCount % interval == 0);
         }
         case QOrganizerRecurrenceRule::Daily: {
@@ -1627,15 +1768,65 @@ QDate QOrganizerManagerEngine::firstDateInNextPeriod(const QDate &date, QOrganiz
 QList<QDate> QOrganizerManagerEngine::matchingDates(const QDate &periodStart, const QDate &periodEnd, const QOrganizerRecurrenceRule &rrule)
 {
     QList<QDate> retn;
+    if (periodStart > periodEnd)
+        return retn;
+
+    const QSet<Qt::DayOfWeek> daysOfWeek = rrule.daysOfWeek();
+    const QSet<int> daysOfMonth = rrule.daysOfMonth();
+    const QSet<int> daysOfYear = rrule.daysOfYear();
+    const QSet<int> weeksOfYear = rrule.weeksOfYear();
+    const QSet<QOrganizerRecurrenceRule::Month> monthsOfYear = rrule.monthsOfYear();
+
+    // Rather than testing every date of the period, compute the dates allowed by the most
+    // selective criterion directly, and then limit those candidates by all of the criteria.
+    QList<QDate> candidates;
+    if (!daysOfYear.isEmpty()) {
+        for (int year = periodStart.year(); year <= periodEnd.year(); ++year) {
+            const QDate firstDate(year, 1, 1);
+            foreach (int day, daysOfYear) {
+                if (day >= 1 && day <= firstDate.daysInYear())
+                    candidates.append(firstDate.addDays(day - 1));
+            }
+        }
+    } else if (!daysOfMonth.isEmpty()) {
+        for (QDate month(periodStart.year(), periodStart.month(), 1); month <= periodEnd; month = month.addMonths(1)) {
+            if (!monthsOfYear.isEmpty() && !monthsOfYear.contains(static_cast<QOrganizerRecurrenceRule::Month>(month.month())))
+                continue;
+            foreach (int day, daysOfMonth) {
+                if (day >= 1 && day <= month.daysInMonth())
+                    candidates.append(month.addDays(day - 1));
+            }
+        }
+    } else if (!weeksOfYear.isEmpty()) {
+        // the dates of a period belong to the ISO 8601 years before, of and after their own year.
+        for (int year = periodStart.year() - 1; year <= periodEnd.year() + 1; ++year) {
+            const QDate fourthOfJanuary(year, 1, 4); // always in week 1
+            const QDate firstMonday = fourthOfJanuary.addDays(1 - fourthOfJanuary.dayOfWeek());
+            foreach (int week, weeksOfYear) {
+                if (week < 1 || week > 53)
+                    continue;
+                const QDate monday = firstMonday.addDays(7 * (week - 1));
+                for (int day = 0; day < 7; ++day)
+                    candidates.append(monday.addDays(day));
+            }
+        }
+    } else if (!daysOfWeek.isEmpty()) {
+        foreach (Qt::DayOfWeek dayOfWeek, daysOfWeek) {
+            QDate date = periodStart.addDays((dayOfWeek - periodStart.dayOfWeek() + 7) % 7);
+            for ( ; date <= periodEnd; date = date.addDays(7))
+                candidates.append(date);
+        }
+    } else {
+        for (QDate date = periodStart; date <= periodEnd; date = date.addDays(1))
+            candidates.append(date);
+    }
 
-    QSet<Qt::DayOfWeek> daysOfWeek = rrule.daysOfWeek();
-    QSet<int> daysOfMonth = rrule.daysOfMonth();
-    QSet<int> daysOfYear = rrule.daysOfYear();
-    QSet<int> weeksOfYear = rrule.weeksOfYear();
-    QSet<QOrganizerRecurrenceRule::Month> monthsOfYear = rrule.monthsOfYear();
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
 
-    QDate tempDate = periodStart;
-    while (tempDate <= periodEnd) {
+    foreach (const QDate &tempDate, candidates) {
+        if (tempDate < periodStart || tempDate > periodEnd)
+            continue;
         if ((monthsOfYear.isEmpty() || monthsOfYear.contains(static_cast<QOrganizerRecurrenceRule::Month>(tempDate.month())))
                 && (weeksOfYear.isEmpty() || weeksOfYear.contains(tempDate.weekNumber()))
                 && (daysOfYear.isEmpty() || daysOfYear.contains(tempDate.dayOfYear()))
@@ -1643,7 +1834,6 @@ QList<QDate> QOrganizerManagerEngine::matchingDates(const QDate &periodStart, co
                 && (daysOfWeek.isEmpty() || daysOfWeek.contains(static_cast<Qt::DayOfWeek>(tempDate.dayOfWeek())))) {
             retn.append(tempDate);
         }
-        tempDate = tempDate.addDays(1);
     }
     return retn;
 }
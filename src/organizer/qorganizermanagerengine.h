@@ -164,6 +164,7 @@ public:
 
     // helper
     static int addSorted(QList<QOrganizerItem> *sorted, const QOrganizerItem &toAdd, const QList<QOrganizerItemSortOrder> &sortOrders);
+    static void sortItemsInPlace(QList<QOrganizerItem> *items, const QList<QOrganizerItemSortOrder> &sortOrders);
     static bool addDefaultSorted(QMultiMap<QDateTime, QOrganizerItem> *defaultSorted, const QOrganizerItem &toAdd);
     static int compareItem(const QOrganizerItem &a, const QOrganizerItem &b, const QList<QOrganizerItemSortOrder> &sortOrders);
     static int compareVariant(const QVariant &a, const QVariant &b, Qt::CaseSensitivity sensitivity);
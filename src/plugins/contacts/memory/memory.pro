@@ -1,5 +1,5 @@
 TARGET = qtcontacts_memory
-QT = core contacts
+QT = core contacts-private
 
 PLUGIN_TYPE = contacts
 load(qt_plugin)
@@ -39,16 +39,23 @@
 
 #include "qcontactmemorybackend_p.h"
 
+#include <algorithm>
+
 #ifndef QT_NO_DEBUG_STREAM
 #include <QtCore/qdebug.h>
 #endif
+#include <QtCore/qdeadlinetimer.h>
 #include <QtCore/qpointer.h>
 #include <QtCore/qstringbuilder.h>
+#include <QtCore/qthreadpool.h>
 #include <QtCore/quuid.h>
 
 #include <QtContacts/qcontactidfilter.h>
+#include <QtContacts/qcontactintersectionfilter.h>
 #include <QtContacts/qcontactrequests.h>
 #include <QtContacts/qcontacttimestamp.h>
+#include <QtContacts/qcontactunionfilter.h>
+#include <QtContacts/private/qcontactfilterprogram_p.h>
 
 QT_BEGIN_NAMESPACE_CONTACTS
 
@@ -86,8 +93,25 @@ QString QContactMemoryEngineFactory::managerName() const
   This engine supports sharing, so an internal reference count is increased
   whenever a manager uses this backend, and is decreased when the manager
   no longer requires this engine.
+
+  The optional "fieldIndexes" parameter enables indexes of detail field values,
+  which are consulted when filtering before falling back to testing every contact.
+  Its value is a comma separated list of "detailType:detailField" pairs of integers,
+  for example "20:0" to index QContactPhoneNumber::FieldNumber.  The indexes answer
+  QContactDetailFilter value tests using MatchExactly, MatchStartsWith and
+  MatchPhoneNumber (with MatchExactly or MatchEndsWith) semantics.
+
+  By default, asynchronous requests are completed before QContactAbstractRequest::start()
+  returns.  The optional "workerThreads" parameter gives the number of threads on which
+  contact fetch, contact id fetch and contact fetch by id requests are executed instead;
+  their results are delivered through the event loop of the thread which started them,
+  with the partial results of unsorted fetches reported as they are found.  Requests which
+  modify the store are always completed immediately.
  */
 
+/* The number of contacts tested between checks for cancellation and reports of partial results */
+static const int MatchingBatchSize = 1000;
+
 /* static data for manager class */
 QMap<QString, QContactMemoryEngineData*> QContactMemoryEngine::engineDatas;
 
@@ -117,7 +141,18 @@ QContactMemoryEngine* QContactMemoryEngine::createMemoryEngine(const QMap<QStrin
         data->m_anonymous = anonymous;
         engineDatas.insert(idValue, data);
     }
-    return new QContactMemoryEngine(data);
+    {
+        QWriteLocker locker(&data->m_lock);
+        data->addFieldIndexes(parameters.value(QStringLiteral("fieldIndexes")));
+    }
+
+    QContactMemoryEngine *engine = new QContactMemoryEngine(data);
+    const int workerThreads = parameters.value(QStringLiteral("workerThreads")).toInt();
+    if (workerThreads > 0) {
+        engine->m_threadPool = new QThreadPool(engine);
+        engine->m_threadPool->setMaxThreadCount(workerThreads);
+    }
+    return engine;
 }
 
 /*!
@@ -126,6 +161,7 @@ QContactMemoryEngine* QContactMemoryEngine::createMemoryEngine(const QMap<QStrin
  */
 QContactMemoryEngine::QContactMemoryEngine(QContactMemoryEngineData *data)
     : d(data)
+    , m_threadPool(0)
 {
     qRegisterMetaType<QContactAbstractRequest::State>("QContactAbstractRequest::State");
     qRegisterMetaType<QList<QContactId> >("QList<QContactId>");
@@ -147,6 +183,13 @@ QContactMemoryEngine::QContactMemoryEngine(QContactMemoryEngineData *data)
 /*! Frees any memory used by this engine */
 QContactMemoryEngine::~QContactMemoryEngine()
 {
+    // the worker threads may still be reading the shared data
+    foreach (const QSharedPointer<QContactMemoryRequestJob> &job, m_threadedRequests)
+        job->cancelled.storeRelaxed(1);
+    m_threadedRequests.clear();
+    if (m_threadPool)
+        m_threadPool->waitForDone();
+
     d->m_sharedEngines.removeAll(this);
     if (!d->m_refCount.deref()) {
         engineDatas.remove(d->m_id);
@@ -178,7 +221,7 @@ QMap<QString, QString> QContactMemoryEngine::idInterpretationParameters() const
 /*! \reimp */
 bool QContactMemoryEngine::setSelfContactId(const QContactId &contactId, QContactManager::Error *error)
 {
-    if (contactId.isNull() || d->m_contactIds.contains(contactId)) {
+    if (contactId.isNull() || d->m_contactIndexes.contains(contactId)) {
         *error = QContactManager::NoError;
         QContactId oldId = d->m_selfContactId;
         d->m_selfContactId = contactId;
@@ -206,7 +249,7 @@ QContactId QContactMemoryEngine::selfContactId(QContactManager::Error *error) co
 QContact QContactMemoryEngine::contact(const QContactId &contactId, const QContactFetchHint &fetchHint, QContactManager::Error *error) const
 {
     Q_UNUSED(fetchHint); // no optimizations are possible in the memory backend; ignore the fetch hint.
-    int index = d->m_contactIds.indexOf(contactId);
+    int index = d->contactIndex(contactId);
     if (index != -1) {
         // found the contact successfully.
         *error = QContactManager::NoError;
@@ -222,7 +265,7 @@ QList<QContactId> QContactMemoryEngine::contactIds(const QContactFilter &filter,
 {
     /* Special case the fast case */
     if (filter.type() == QContactFilter::DefaultFilter && sortOrders.count() == 0) {
-        return d->m_contactIds;
+        return d->allContactIds();
     } else {
         QList<QContact> clist = contacts(filter, sortOrders, QContactFetchHint(), error);
 
@@ -241,20 +284,70 @@ QList<QContact> QContactMemoryEngine::contacts(const QContactFilter &filter, con
     Q_UNUSED(fetchHint); // no optimizations are possible in the memory backend; ignore the fetch hint.
     Q_UNUSED(error);
 
+    return matchingContacts(filter, QContactFilterProgram(filter), sortOrders);
+}
+
+/*!
+  Returns the contacts which match the given \a filter, sorted according to \a sortOrders.
+  The \a program has to be compiled from \a filter; the filter itself is only used to
+  find candidates in the field indexes.
+
+  If \a partialResults is set and the contacts are not sorted, it is called with the
+  contacts matched so far after each batch of contacts has been tested.  If \a cancelled
+  is set, the search is abandoned and an empty list returned as soon as it becomes non-zero.
+ */
+QList<QContact> QContactMemoryEngine::matchingContacts(const QContactFilter &filter, const QContactFilterProgram &program,
+                                                       const QList<QContactSortOrder> &sortOrders,
+                                                       const QAtomicInt *cancelled,
+                                                       const std::function<void (const QList<QContact> &)> &partialResults) const
+{
     QList<QContact> sorted;
 
-    /* First filter out contacts - check for default filter first */
-    if (filter.type() == QContactFilter::DefaultFilter) {
-        foreach(const QContact&c, d->m_contacts) {
-            QContactManagerEngine::addSorted(&sorted,c, sortOrders);
-        }
+    /* First filter out contacts - compile the filter once, and check for trivial filters first */
+    QSet<QContactId> candidates;
+    if (program.matchesAll()) {
+        sorted = d->allContacts();
+    } else if (program.matchesNone()) {
+        return sorted;
     } else {
-        foreach(const QContact&c, d->m_contacts) {
-            if (QContactManagerEngine::testFilter(filter, c))
-                QContactManagerEngine::addSorted(&sorted,c, sortOrders);
+        /* Only test the contacts which the indexes could not rule out, in storage order */
+        QList<int> indexes;
+        const bool useIndexes = d->filterCandidates(filter, &candidates);
+        if (useIndexes) {
+            indexes.reserve(candidates.size());
+            foreach (const QContactId &id, candidates) {
+                const int index = d->contactIndex(id);
+                if (index != -1)
+                    indexes.append(index);
+            }
+            std::sort(indexes.begin(), indexes.end());
+        }
+
+        const bool progressive = partialResults && sortOrders.isEmpty();
+        const int count = useIndexes ? indexes.size() : d->m_contacts.size();
+        int reported = 0;
+        for (int i = 0; i < count; ++i) {
+            const int index = useIndexes ? indexes.at(i) : i;
+            if (!d->isRemovedAt(index) && program.matches(d->m_contacts.at(index)))
+                sorted.append(d->m_contacts.at(index));
+
+            if ((i + 1) % MatchingBatchSize == 0) {
+                if (cancelled && cancelled->loadRelaxed())
+                    return QList<QContact>();
+                if (progressive && sorted.size() > reported) {
+                    partialResults(sorted);
+                    reported = sorted.size();
+                }
+            }
         }
     }
 
+    if (cancelled && cancelled->loadRelaxed())
+        return QList<QContact>();
+
+    /* Then sort the matching contacts in one go */
+    QContactManagerEngine::sortContactsInPlace(&sorted, sortOrders);
+
     return sorted;
 }
 
@@ -279,7 +372,7 @@ bool QContactMemoryEngine::saveContacts(QList<QContact> *contacts, QMap<int, QCo
 */
 bool QContactMemoryEngine::removeContact(const QContactId &contactId, QContactChangeSet &changeSet, QContactManager::Error *error)
 {
-    int index = d->m_contactIds.indexOf(contactId);
+    int index = d->contactIndex(contactId);
 
     if (index == -1) {
         *error = QContactManager::DoesNotExistError;
@@ -299,8 +392,10 @@ bool QContactMemoryEngine::removeContact(const QContactId &contactId, QContactCh
     removeRelationships(allRelationships, 0, error);
 
     // having cleaned up the relationships, remove the contact from the lists.
-    d->m_contacts.removeAt(index);
-    d->m_contactIds.removeAt(index);
+    {
+        QWriteLocker locker(&d->m_lock);
+        d->removeContactAt(index);
+    }
     *error = QContactManager::NoError;
 
     // and if it was the self contact, reset the self contact id
@@ -382,7 +477,7 @@ bool QContactMemoryEngine::saveRelationship(QContactRelationship *relationship,
     // Attempt to validate the relationship.
     // first, check that the source contact exists and is in this manager.
     QString myUri = managerUri();
-    int firstContactIndex = d->m_contactIds.indexOf(relationship->first());
+    int firstContactIndex = d->contactIndex(relationship->first());
     if ((!relationship->first().managerUri().isEmpty() && relationship->first().managerUri() != myUri)
             ||firstContactIndex == -1) {
         *error = QContactManager::InvalidRelationshipError;
@@ -391,7 +486,7 @@ bool QContactMemoryEngine::saveRelationship(QContactRelationship *relationship,
 
     // second, check that the second contact exists (if it's local); we cannot check other managers' contacts.
     QContactId dest = relationship->second();
-    int secondContactIndex = d->m_contactIds.indexOf(dest);
+    int secondContactIndex = d->contactIndex(dest);
 
     if (dest.managerUri().isEmpty() || dest.managerUri() == myUri) {
         // this entry in the destination list is supposedly stored in this manager.
@@ -431,8 +526,11 @@ bool QContactMemoryEngine::saveRelationship(QContactRelationship *relationship,
     changeSet.insertAddedRelationshipsContact(relationship->second());
 
     // update the contacts involved
-    QContactManagerEngine::setContactRelationships(&d->m_contacts[firstContactIndex], firstRelationships);
-    QContactManagerEngine::setContactRelationships(&d->m_contacts[secondContactIndex], secondRelationships);
+    {
+        QWriteLocker locker(&d->m_lock);
+        QContactManagerEngine::setContactRelationships(&d->m_contacts[firstContactIndex], firstRelationships);
+        QContactManagerEngine::setContactRelationships(&d->m_contacts[secondContactIndex], secondRelationships);
+    }
 
     // finally, insert into our list of all relationships, and return.
     d->m_relationships.append(*relationship);
@@ -485,12 +583,15 @@ bool QContactMemoryEngine::removeRelationship(const QContactRelationship &relati
     d->m_orderedRelationships.insert(relationship.second(), secondRelationships);
 
     // Update the contacts as well
-    int firstContactIndex = d->m_contactIds.indexOf(relationship.first());
-    int secondContactIndex = relationship.second().managerUri() == managerUri() ? d->m_contactIds.indexOf(relationship.second()) : -1;
-    if (firstContactIndex != -1)
-        QContactMemoryEngine::setContactRelationships(&d->m_contacts[firstContactIndex], firstRelationships);
-    if (secondContactIndex != -1)
-        QContactMemoryEngine::setContactRelationships(&d->m_contacts[secondContactIndex], secondRelationships);
+    int firstContactIndex = d->contactIndex(relationship.first());
+    int secondContactIndex = relationship.second().managerUri() == managerUri() ? d->contactIndex(relationship.second()) : -1;
+    {
+        QWriteLocker locker(&d->m_lock);
+        if (firstContactIndex != -1)
+            QContactMemoryEngine::setContactRelationships(&d->m_contacts[firstContactIndex], firstRelationships);
+        if (secondContactIndex != -1)
+            QContactMemoryEngine::setContactRelationships(&d->m_contacts[secondContactIndex], secondRelationships);
+    }
 
     // set our changes, and return.
     changeSet.insertRemovedRelationshipsContact(relationship.first());
@@ -616,34 +717,223 @@ bool QContactMemoryEngine::removeCollection(const QContactCollectionId &collecti
 /*! \reimp */
 void QContactMemoryEngine::requestDestroyed(QContactAbstractRequest *req)
 {
-    Q_UNUSED(req);
+    // a worker thread may still be executing the request; let it finish on its own.
+    QSharedPointer<QContactMemoryRequestJob> job = m_threadedRequests.take(req);
+    if (job)
+        job->cancelled.storeRelaxed(1);
 }
 
 /*! \reimp */
 bool QContactMemoryEngine::startRequest(QContactAbstractRequest *req)
 {
     updateRequestState(req, QContactAbstractRequest::ActiveState);
-    performAsynchronousOperation(req);
+    if (!m_threadPool || !startThreadedRequest(req))
+        performAsynchronousOperation(req);
 
     return true;
 }
 
 bool QContactMemoryEngine::cancelRequest(QContactAbstractRequest *req)
 {
-    Q_UNUSED(req); // we can't cancel since we complete immediately
-    return false;
+    // only requests executed by the worker threads can be canceled; the others complete immediately
+    QSharedPointer<QContactMemoryRequestJob> job = m_threadedRequests.take(req);
+    if (!job)
+        return false;
+
+    job->cancelled.storeRelaxed(1);
+    updateRequestState(req, QContactAbstractRequest::CanceledState);
+    return true;
 }
 
 /*! \reimp */
 bool QContactMemoryEngine::waitForRequestFinished(QContactAbstractRequest *req, int msecs)
 {
-    // in our implementation, we always complete any operation we start.
-    Q_UNUSED(msecs);
-    Q_UNUSED(req);
+    // in the immediate mode, we always complete any operation we start.
+    QSharedPointer<QContactMemoryRequestJob> job = m_threadedRequests.value(req);
+    if (!job)
+        return true;
+
+    {
+        const QDeadlineTimer deadline = msecs > 0 ? QDeadlineTimer(msecs) : QDeadlineTimer(QDeadlineTimer::Forever);
+        QMutexLocker locker(&job->mutex);
+        while (!job->finished) {
+            if (!job->finishedCondition.wait(&job->mutex, deadline))
+                return false;
+        }
+    }
+
+    finishThreadedRequest(req, job);
+    return true;
+}
+
+/*!
+ * Queues the given read only \a request for execution by the worker threads.
+ * Returns false if the request has to be performed immediately instead.
+ *
+ * The workers only use copies of the parameters of the request, and its filter is compiled
+ * before it is queued, so that the action plugins are only consulted in the thread of the engine.
+ * Its results are delivered in the thread of the engine by deliverPartialResults() and
+ * finishThreadedRequest().
+ */
+bool QContactMemoryEngine::startThreadedRequest(QContactAbstractRequest *req)
+{
+    QSharedPointer<QContactMemoryRequestJob> job(new QContactMemoryRequestJob);
+    std::function<void ()> work;
+
+    switch (req->type()) {
+        case QContactAbstractRequest::ContactFetchRequest:
+        {
+            QContactFetchRequest *r = static_cast<QContactFetchRequest*>(req);
+            const QContactFilter filter = r->filter();
+            const QContactFilterProgram program(filter);
+            const QList<QContactSortOrder> sorting = r->sorting();
+            work = [this, req, job, filter, program, sorting]() {
+                QList<QContact> results;
+                {
+                    QReadLocker locker(&d->m_lock);
+                    results = matchingContacts(filter, program, sorting, &job->cancelled, [this, req, job](const QList<QContact> &partial) {
+                        QMetaObject::invokeMethod(this, [this, req, job, partial]() {
+                            deliverPartialResults(req, job, partial);
+                        }, Qt::QueuedConnection);
+                    });
+                }
+                QMutexLocker locker(&job->mutex);
+                job->contacts = results;
+            };
+        }
+        break;
+
+        case QContactAbstractRequest::ContactIdFetchRequest:
+        {
+            QContactIdFetchRequest *r = static_cast<QContactIdFetchRequest*>(req);
+            const QContactFilter filter = r->filter();
+            const QContactFilterProgram program(filter);
+            const QList<QContactSortOrder> sorting = r->sorting();
+            work = [this, job, filter, program, sorting]() {
+                QList<QContactId> results;
+                {
+                    QReadLocker locker(&d->m_lock);
+                    if (filter.type() == QContactFilter::DefaultFilter && sorting.isEmpty()) {
+                        results = d->allContactIds();
+                    } else {
+                        foreach (const QContact &c, matchingContacts(filter, program, sorting, &job->cancelled))
+                            results.append(c.id());
+                    }
+                }
+                QMutexLocker locker(&job->mutex);
+                job->contactIds = results;
+            };
+        }
+        break;
+
+        case QContactAbstractRequest::ContactFetchByIdRequest:
+        {
+            QContactFetchByIdRequest *r = static_cast<QContactFetchByIdRequest*>(req);
+            const QList<QContactId> contactIds = r->contactIds();
+            work = [this, job, contactIds]() {
+                QList<QContact> results;
+                QMap<int, QContactManager::Error> errorMap;
+                QContactManager::Error error = QContactManager::NoError;
+                {
+                    QReadLocker locker(&d->m_lock);
+                    for (int i = 0; i < contactIds.size(); ++i) {
+                        const int index = d->contactIndex(contactIds.at(i));
+                        if (index == -1) {
+                            errorMap.insert(i, QContactManager::DoesNotExistError);
+                            error = QContactManager::DoesNotExistError;
+                            results.append(QContact());
+                        } else {
+                            results.append(d->m_contacts.at(index));
+                        }
+                    }
+                }
+                QMutexLocker locker(&job->mutex);
+                job->contacts = results;
+                job->errorMap = errorMap;
+                job->error = error;
+            };
+        }
+        break;
+
+        default: // requests which modify the store are performed immediately.
+        return false;
+    }
+
+    m_threadedRequests.insert(req, job);
+    m_threadPool->start([this, req, job, work]() {
+        if (!job->cancelled.loadRelaxed())
+            work();
+
+        {
+            QMutexLocker locker(&job->mutex);
+            job->finished = true;
+            job->finishedCondition.wakeAll();
+        }
+
+        QMetaObject::invokeMethod(this, [this, req, job]() {
+            finishThreadedRequest(req, job);
+        }, Qt::QueuedConnection);
+    });
 
     return true;
 }
 
+/*!
+ * Updates the contact fetch \a request with the \a contacts matched so far by its \a job,
+ * unless the request has been canceled, destroyed or finished in the meantime.
+ */
+void QContactMemoryEngine::deliverPartialResults(QContactAbstractRequest *request, const QSharedPointer<QContactMemoryRequestJob> &job, const QList<QContact> &contacts)
+{
+    if (m_threadedRequests.value(request) != job)
+        return;
+
+    updateContactFetchRequest(static_cast<QContactFetchRequest*>(request), contacts, QContactManager::NoError, QContactAbstractRequest::ActiveState);
+}
+
+/*!
+ * Updates the \a request with the results of its finished \a job,
+ * unless the request has been canceled, destroyed or finished in the meantime.
+ */
+void QContactMemoryEngine::finishThreadedRequest(QContactAbstractRequest *request, const QSharedPointer<QContactMemoryRequestJob> &job)
+{
+    if (m_threadedRequests.value(request) != job)
+        return;
+    m_threadedRequests.remove(request);
+
+    QMutexLocker locker(&job->mutex);
+    const QContactManager::Error error = job->error;
+    const QList<QContact> contacts = job->contacts;
+    const QList<QContactId> contactIds = job->contactIds;
+    const QMap<int, QContactManager::Error> errorMap = job->errorMap;
+    locker.unlock();
+
+    switch (request->type()) {
+        case QContactAbstractRequest::ContactFetchRequest:
+            if (!contacts.isEmpty() || error != QContactManager::NoError)
+                updateContactFetchRequest(static_cast<QContactFetchRequest*>(request), contacts, error, QContactAbstractRequest::FinishedState);
+            else
+                updateRequestState(request, QContactAbstractRequest::FinishedState);
+        break;
+
+        case QContactAbstractRequest::ContactIdFetchRequest:
+            if (!contactIds.isEmpty() || error != QContactManager::NoError)
+                updateContactIdFetchRequest(static_cast<QContactIdFetchRequest*>(request), contactIds, error, QContactAbstractRequest::FinishedState);
+            else
+                updateRequestState(request, QContactAbstractRequest::FinishedState);
+        break;
+
+        case QContactAbstractRequest::ContactFetchByIdRequest:
+            if (!contacts.isEmpty() || error != QContactManager::NoError)
+                updateContactFetchByIdRequest(static_cast<QContactFetchByIdRequest*>(request), contacts, error, errorMap, QContactAbstractRequest::FinishedState);
+            else
+                updateRequestState(request, QContactAbstractRequest::FinishedState);
+        break;
+
+        default:
+        break;
+    }
+}
+
 /*!
  * This slot is called some time after an asynchronous request is started.
  * It performs the required operation, sets the result and returns.
@@ -677,31 +967,25 @@ void QContactMemoryEngine::performAsynchronousOperation(QContactAbstractRequest
         case QContactAbstractRequest::ContactFetchByIdRequest:
         {
             QContactFetchByIdRequest *r = static_cast<QContactFetchByIdRequest*>(currentRequest);
-            QContactIdFilter idFilter;
-            idFilter.setIds(r->contactIds());
-            QList<QContactSortOrder> sorting;
             QContactFetchHint fetchHint = r->fetchHint();
             QContactManager::Error error = QContactManager::NoError;
-            QList<QContact> requestedContacts = contacts(idFilter, sorting, fetchHint, &error);
-            // Build an index into the results
-            QHash<QContactId, int> idMap; // value is index into unsorted
-            if (error == QContactManager::NoError) {
-                for (int i = 0; i < requestedContacts.size(); i++) {
-                    idMap.insert(requestedContacts[i].id(), i);
-                }
-            }
-            // Find the order in which the results should be presented
+
+            // Look up each requested id directly, preserving the requested order
             // Build up the results and errors
             QList<QContact> results;
+            QList<QContact> requestedContacts;
             QMap<int, QContactManager::Error> errorMap;
             int index = 0;
             foreach (const QContactId &id, r->contactIds()) {
-                if (!idMap.contains(id)) {
+                QContactManager::Error tempError = QContactManager::NoError;
+                QContact requested = contact(id, fetchHint, &tempError);
+                if (tempError != QContactManager::NoError) {
                     errorMap.insert(index, QContactManager::DoesNotExistError);
                     error = QContactManager::DoesNotExistError;
                     results.append(QContact());
                 } else {
-                    results.append(requestedContacts[idMap[id]]);
+                    results.append(requested);
+                    requestedContacts.append(requested);
                 }
                 index++;
             }
@@ -966,6 +1250,295 @@ QList<QMetaType::Type> QContactMemoryEngine::supportedDataTypes() const
     return st;
 }
 
+static QString reversedString(const QString &string)
+{
+    QString reversed(string.size(), Qt::Uninitialized);
+    std::reverse_copy(string.constBegin(), string.constEnd(), reversed.begin());
+    return reversed;
+}
+
+/*!
+  Indexes the values of the indexed field in the details of the given \a contact,
+  replacing any values previously indexed for it.
+ */
+void QContactMemoryEngineFieldIndex::insertContact(const QContact &contact)
+{
+    const QContactId contactId = contact.id();
+    removeContact(contactId);
+
+    QStringList foldedKeys;
+    QStringList digitKeys;
+    bool unindexed = false;
+    foreach (const QContactDetail &detail, contact.details(m_detailType)) {
+        const QVariant value = detail.value(m_detailField);
+        const int valueType = value.metaType().id();
+
+        // testFilter() compares values of other types with compareVariant(),
+        // which can't be answered from the string keys.
+        if (value.isValid() && valueType != QMetaType::QString
+                && valueType != QMetaType::QChar && valueType != QMetaType::Char) {
+            unindexed = true;
+        }
+
+        // details without the field are indexed too, as they match empty values.
+        const QString valueString = value.toString();
+        foldedKeys.append(valueString.toCaseFolded());
+        digitKeys.append(reversedString(QContactFilterProgram::phoneNumberDigits(valueString)));
+    }
+
+    if (foldedKeys.isEmpty())
+        return;
+
+    foreach (const QString &key, foldedKeys) {
+        m_exactKeys.insert(key, contactId);
+        m_sortedKeys.insert(key, contactId);
+    }
+    foreach (const QString &key, digitKeys)
+        m_reversedDigits.insert(key, contactId);
+    if (unindexed)
+        m_unindexedContacts.insert(contactId);
+    m_contactKeys.insert(contactId, qMakePair(foldedKeys, digitKeys));
+}
+
+/*!
+  Removes any values indexed for the contact identified by \a contactId.
+ */
+void QContactMemoryEngineFieldIndex::removeContact(const QContactId &contactId)
+{
+    QHash<QContactId, QPair<QStringList, QStringList> >::iterator it = m_contactKeys.find(contactId);
+    if (it == m_contactKeys.end())
+        return;
+
+    foreach (const QString &key, it->first) {
+        m_exactKeys.remove(key, contactId);
+        m_sortedKeys.remove(key, contactId);
+    }
+    foreach (const QString &key, it->second)
+        m_reversedDigits.remove(key, contactId);
+    m_unindexedContacts.remove(contactId);
+    m_contactKeys.erase(it);
+}
+
+void QContactMemoryEngineFieldIndex::insertPrefixRange(const QMultiMap<QString, QContactId> &keys, const QString &prefix, QSet<QContactId> *candidates) const
+{
+    QMultiMap<QString, QContactId>::const_iterator it = keys.lowerBound(prefix);
+    for ( ; it != keys.constEnd() && it.key().startsWith(prefix); ++it)
+        candidates->insert(it.value());
+}
+
+/*!
+  Inserts into \a candidates the ids of the contacts which may match the given detail \a filter.
+  Returns false if the filter cannot be answered from this index, in which case every
+  contact has to be tested.
+
+  The candidates are a superset of the matching contacts; they still have to be
+  tested with QContactManagerEngine::testFilter().
+ */
+bool QContactMemoryEngineFieldIndex::candidates(const QContactDetailFilter &filter, QSet<QContactId> *candidates) const
+{
+    if (filter.detailType() != m_detailType || filter.detailField() != m_detailField)
+        return false;
+
+    // presence tests are cheap enough to evaluate directly.
+    if (!filter.value().isValid())
+        return false;
+
+    const QContactFilter::MatchFlags flags = filter.matchFlags();
+    const int matchType = flags & 7;
+
+    if (flags & QContactFilter::MatchPhoneNumber) {
+        // a phone number matches either by the requested criteria, or by its rightmost 7 digits;
+        // both are prefixes of the reversed digits.
+        if (matchType != QContactFilter::MatchExactly && matchType != QContactFilter::MatchEndsWith)
+            return false;
+        const QString digits = QContactFilterProgram::phoneNumberDigits(filter.value().toString());
+        const QString reversedInput = reversedString(digits);
+        insertPrefixRange(m_reversedDigits, reversedInput.left(7), candidates);
+        return true;
+    }
+
+    if (flags & QContactFilter::MatchKeypadCollation)
+        return false;
+    if (matchType == QContactFilter::MatchContains || matchType == QContactFilter::MatchEndsWith)
+        return false;
+
+    const QString needle = filter.value().toString().toCaseFolded();
+    if (matchType == QContactFilter::MatchStartsWith) {
+        insertPrefixRange(m_sortedKeys, needle, candidates);
+    } else {
+        foreach (const QContactId &contactId, m_exactKeys.values(needle))
+            candidates->insert(contactId);
+    }
+    candidates->unite(m_unindexedContacts);
+    return true;
+}
+
+/*!
+  Adds the field indexes described by \a specification, building them
+  from the contacts already in the store.
+ */
+void QContactMemoryEngineData::addFieldIndexes(const QString &specification)
+{
+    foreach (const QString &entry, specification.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        const QStringList typeAndField = entry.trimmed().split(QLatin1Char(':'));
+        if (typeAndField.size() != 2)
+            continue;
+
+        bool typeOk = false;
+        bool fieldOk = false;
+        const int detailType = typeAndField.at(0).toInt(&typeOk);
+        const int detailField = typeAndField.at(1).toInt(&fieldOk);
+        if (!typeOk || !fieldOk || detailType <= QContactDetail::TypeUndefined || detailField < 0)
+            continue;
+
+        bool exists = false;
+        foreach (const QContactMemoryEngineFieldIndex &index, m_fieldIndexes) {
+            if (index.detailType() == detailType && index.detailField() == detailField)
+                exists = true;
+        }
+        if (exists)
+            continue;
+
+        QContactMemoryEngineFieldIndex index(static_cast<QContactDetail::DetailType>(detailType), detailField);
+        for (int i = 0; i < m_contacts.size(); ++i) {
+            if (!isRemovedAt(i))
+                index.insertContact(m_contacts.at(i));
+        }
+        m_fieldIndexes.append(index);
+    }
+}
+
+/*!
+  Updates the field indexes with the current details of \a contact.
+ */
+void QContactMemoryEngineData::updateFieldIndexes(const QContact &contact)
+{
+    for (int i = 0; i < m_fieldIndexes.size(); ++i)
+        m_fieldIndexes[i].insertContact(contact);
+}
+
+/*!
+  Drops the slots of removed contacts from the contact lists, and updates the
+  indexes of the remaining contacts.
+ */
+void QContactMemoryEngineData::compactContacts()
+{
+    int next = 0;
+    for (int i = 0; i < m_contactIds.size(); ++i) {
+        if (isRemovedAt(i))
+            continue;
+        if (next != i) {
+            m_contacts[next] = m_contacts.at(i);
+            m_contactIds[next] = m_contactIds.at(i);
+            m_contactIndexes[m_contactIds.at(next)] = next;
+        }
+        ++next;
+    }
+    m_contacts.erase(m_contacts.begin() + next, m_contacts.end());
+    m_contactIds.erase(m_contactIds.begin() + next, m_contactIds.end());
+    m_removedContacts = 0;
+}
+
+/*!
+  Returns the stored contacts in insertion order.
+ */
+QList<QContact> QContactMemoryEngineData::allContacts() const
+{
+    if (m_removedContacts == 0)
+        return m_contacts;
+
+    QList<QContact> contacts;
+    contacts.reserve(m_contacts.size() - m_removedContacts);
+    for (int i = 0; i < m_contacts.size(); ++i) {
+        if (!isRemovedAt(i))
+            contacts.append(m_contacts.at(i));
+    }
+    return contacts;
+}
+
+/*!
+  Returns the ids of the stored contacts in insertion order.
+ */
+QList<QContactId> QContactMemoryEngineData::allContactIds() const
+{
+    if (m_removedContacts == 0)
+        return m_contactIds;
+
+    QList<QContactId> contactIds;
+    contactIds.reserve(m_contactIds.size() - m_removedContacts);
+    for (int i = 0; i < m_contactIds.size(); ++i) {
+        if (!isRemovedAt(i))
+            contactIds.append(m_contactIds.at(i));
+    }
+    return contactIds;
+}
+
+/*!
+  Inserts into \a candidates the ids of the contacts which may match \a filter,
+  as determined from the id filters and indexed detail filters it contains.
+  Returns false if the filter cannot be narrowed down, in which case every
+  contact has to be tested.
+ */
+bool QContactMemoryEngineData::filterCandidates(const QContactFilter &filter, QSet<QContactId> *candidates) const
+{
+    switch (filter.type()) {
+        case QContactFilter::IdFilter:
+        {
+            foreach (const QContactId &id, QContactIdFilter(filter).ids())
+                candidates->insert(id);
+            return true;
+        }
+
+        case QContactFilter::ContactDetailFilter:
+        {
+            const QContactDetailFilter detailFilter(filter);
+            foreach (const QContactMemoryEngineFieldIndex &index, m_fieldIndexes) {
+                if (index.candidates(detailFilter, candidates))
+                    return true;
+            }
+            return false;
+        }
+
+        case QContactFilter::IntersectionFilter:
+        {
+            // any term which can be narrowed down narrows down the whole intersection.
+            bool narrowed = false;
+            QSet<QContactId> intersection;
+            foreach (const QContactFilter &term, QContactIntersectionFilter(filter).filters()) {
+                QSet<QContactId> termCandidates;
+                if (!filterCandidates(term, &termCandidates))
+                    continue;
+                if (narrowed)
+                    intersection.intersect(termCandidates);
+                else
+                    intersection = termCandidates;
+                narrowed = true;
+            }
+            if (narrowed)
+                candidates->unite(intersection);
+            return narrowed;
+        }
+
+        case QContactFilter::UnionFilter:
+        {
+            // every term has to be narrowed down for the union to be.
+            const QList<QContactFilter> terms = QContactUnionFilter(filter).filters();
+            if (terms.isEmpty())
+                return false;
+            QSet<QContactId> termsCandidates;
+            foreach (const QContactFilter &term, terms) {
+                if (!filterCandidates(term, &termsCandidates))
+                    return false;
+            }
+            candidates->unite(termsCandidates);
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
 /*!
  * The function returns true if the backend natively supports the given filter \a filter, otherwise false.
  */
@@ -1020,7 +1593,7 @@ bool QContactMemoryEngine::saveContact(QContact *theContact, QContactChangeSet &
     }
 
     // check to see if this contact already exists
-    int index = d->m_contactIds.indexOf(id);
+    int index = d->contactIndex(id);
     if (index != -1) {
         /* We also need to check that there are no modified create only details */
         QContact oldContact = d->m_contacts.at(index);
@@ -1043,7 +1616,8 @@ bool QContactMemoryEngine::saveContact(QContact *theContact, QContactChangeSet &
         theContact->saveDetail(&ts);
 
         // Looks ok, so continue
-        d->m_contacts.replace(index, *theContact);
+        QWriteLocker locker(&d->m_lock);
+        d->replaceContactAt(index, *theContact);
         changeSet.insertChangedContact(theContact->id(), mask);
     } else {
         // id does not exist; if not zero, fail.
@@ -1088,8 +1662,8 @@ bool QContactMemoryEngine::saveContact(QContact *theContact, QContactChangeSet &
         theContact->setId(newContactId);
 
         // finally, add the contact to our internal lists and return
-        d->m_contacts.append(*theContact);                   // add contact to list
-        d->m_contactIds.append(theContact->id());  // track the contact id.
+        QWriteLocker locker(&d->m_lock);
+        d->appendContact(*theContact);             // add contact to list and track the contact id.
         d->m_contactsInCollections.insert(collectionId, newContactId); // link contact to collection
 
         changeSet.insertAddedContact(theContact->id());
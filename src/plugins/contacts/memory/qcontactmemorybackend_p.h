@@ -56,12 +56,59 @@
 #include <QtContacts/qcontactmanager.h>
 #include <QtContacts/qcontactmanagerengine.h>
 #include <QtContacts/qcontactchangeset.h>
+#include <QtContacts/qcontactdetailfilter.h>
 #include <QtContacts/qcontactmanagerenginefactory.h>
 
+#include <QtCore/qmutex.h>
+#include <QtCore/qreadwritelock.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qwaitcondition.h>
+
+#include <functional>
+
+QT_FORWARD_DECLARE_CLASS(QThreadPool)
+
 QT_BEGIN_NAMESPACE_CONTACTS
 
+class QContactFilterProgram;
 class QContactMemoryEngine;
 
+class QContactMemoryEngineFieldIndex
+{
+public:
+    QContactMemoryEngineFieldIndex()
+        : m_detailType(QContactDetail::TypeUndefined)
+        , m_detailField(-1)
+    {
+    }
+
+    QContactMemoryEngineFieldIndex(QContactDetail::DetailType detailType, int detailField)
+        : m_detailType(detailType)
+        , m_detailField(detailField)
+    {
+    }
+
+    QContactDetail::DetailType detailType() const { return m_detailType; }
+    int detailField() const { return m_detailField; }
+
+    void insertContact(const QContact &contact);
+    void removeContact(const QContactId &contactId);
+
+    bool candidates(const QContactDetailFilter &filter, QSet<QContactId> *candidates) const;
+
+private:
+    void insertPrefixRange(const QMultiMap<QString, QContactId> &keys, const QString &prefix, QSet<QContactId> *candidates) const;
+
+    QContactDetail::DetailType m_detailType;
+    int m_detailField;
+
+    QMultiHash<QString, QContactId> m_exactKeys;        // case folded value, for MatchExactly
+    QMultiMap<QString, QContactId> m_sortedKeys;        // case folded value, for MatchStartsWith
+    QMultiMap<QString, QContactId> m_reversedDigits;    // reversed digits of the value, for MatchPhoneNumber
+    QSet<QContactId> m_unindexedContacts;               // contacts with non-string values, which are always candidates
+    QHash<QContactId, QPair<QStringList, QStringList> > m_contactKeys; // keys inserted for each contact
+};
+
 class QContactMemoryEngineFactory : public QContactManagerEngineFactory
 {
     Q_OBJECT
@@ -78,6 +125,7 @@ public:
         : QSharedData()
         , m_refCount(QAtomicInt(1))
         , m_selfContactId()
+        , m_removedContacts(0)
         , m_nextContactId(1)
         , m_anonymous(false)
     {
@@ -87,6 +135,7 @@ public:
         : QSharedData(other),
         m_refCount(QAtomicInt(1)),
         m_selfContactId(other.m_selfContactId),
+        m_removedContacts(0),
         m_nextContactId(other.m_nextContactId),
         m_anonymous(other.m_anonymous)
     {
@@ -98,6 +147,56 @@ public:
 
     static QContactMemoryEngineData *data(QContactMemoryEngine *engine);
 
+    int contactIndex(const QContactId &contactId) const
+    {
+        return m_contactIndexes.value(contactId, -1);
+    }
+
+    void appendContact(const QContact &contact)
+    {
+        m_contactIndexes.insert(contact.id(), m_contacts.size());
+        m_contacts.append(contact);
+        m_contactIds.append(contact.id());
+        updateFieldIndexes(contact);
+    }
+
+    void replaceContactAt(int index, const QContact &contact)
+    {
+        m_contacts.replace(index, contact);
+        updateFieldIndexes(contact);
+    }
+
+    bool isRemovedAt(int index) const
+    {
+        return m_contactIds.at(index).isNull();
+    }
+
+    void removeContactAt(int index)
+    {
+        // the lists keep insertion order (it is observable through contactIds()),
+        // so the slot of the removed contact is left empty instead of shifting the
+        // following contacts; the empty slots are dropped once they make up half
+        // of the lists, which keeps removal constant time on average.
+        const QContactId contactId = m_contactIds.at(index);
+        for (int i = 0; i < m_fieldIndexes.size(); ++i)
+            m_fieldIndexes[i].removeContact(contactId);
+        m_contactIndexes.remove(contactId);
+        m_contacts[index] = QContact();
+        m_contactIds[index] = QContactId();
+        if (++m_removedContacts * 2 > m_contactIds.size())
+            compactContacts();
+    }
+
+    void compactContacts();
+    QList<QContact> allContacts() const;
+    QList<QContactId> allContactIds() const;
+
+    void addFieldIndexes(const QString &specification);
+    void updateFieldIndexes(const QContact &contact);
+    bool filterCandidates(const QContactFilter &filter, QSet<QContactId> *candidates) const;
+
+    QReadWriteLock m_lock;                    // held by worker threads while reading the contacts and their indexes,
+                                              // and by the engine while modifying them
     QAtomicInt m_refCount;
     QString m_id;                                  // the id parameter value
 
@@ -105,7 +204,10 @@ public:
     QList<QContact> m_contacts;               // list of contacts
     QMultiHash<QContactCollectionId, QContactId> m_contactsInCollections; // hash of contacts for each collection
     QHash<QContactCollectionId, QContactCollection> m_idToCollectionHash; // hash of id to the collection identified by that id
-    QList<QContactId> m_contactIds;           // list of contact Id's
+    QList<QContactId> m_contactIds;           // list of contact Id's, a null id marks the slot of a removed contact
+    QHash<QContactId, int> m_contactIndexes;  // hash of contact id to its index in m_contacts and m_contactIds
+    int m_removedContacts;                    // number of removed contact slots in m_contacts and m_contactIds
+    QList<QContactMemoryEngineFieldIndex> m_fieldIndexes; // opt-in indexes of detail field values
     QList<QContactRelationship> m_relationships;   // list of contact relationships
     QMap<QContactId, QList<QContactRelationship> > m_orderedRelationships; // map of ordered lists of contact relationships
     QList<QString> m_definitionIds;                // list of definition types (id's)
@@ -130,6 +232,26 @@ public:
 };
 
 
+class QContactMemoryRequestJob
+{
+public:
+    QContactMemoryRequestJob()
+        : finished(false)
+        , error(QContactManager::NoError)
+    {
+    }
+
+    QAtomicInt cancelled;
+
+    QMutex mutex;                             // guards the members below
+    QWaitCondition finishedCondition;
+    bool finished;
+    QContactManager::Error error;
+    QList<QContact> contacts;
+    QList<QContactId> contactIds;
+    QMap<int, QContactManager::Error> errorMap;
+};
+
 class QContactMemoryEngine : public QContactManagerEngine
 {
     Q_OBJECT
@@ -213,9 +335,21 @@ private:
     bool saveContact(QContact *theContact, QContactChangeSet &changeSet, QContactManager::Error *error, const QList<QContactDetail::DetailType> &mask);
     void partiallySyncDetails(QContact *to, const QContact &from, const QList<QContactDetail::DetailType> &mask);
 
+    QList<QContact> matchingContacts(const QContactFilter &filter, const QContactFilterProgram &program,
+                                     const QList<QContactSortOrder> &sortOrders,
+                                     const QAtomicInt *cancelled = 0,
+                                     const std::function<void (const QList<QContact> &)> &partialResults = std::function<void (const QList<QContact> &)>()) const;
+
     void performAsynchronousOperation(QContactAbstractRequest *request);
 
+    /* Requests executed by the worker threads */
+    bool startThreadedRequest(QContactAbstractRequest *request);
+    void deliverPartialResults(QContactAbstractRequest *request, const QSharedPointer<QContactMemoryRequestJob> &job, const QList<QContact> &contacts);
+    void finishThreadedRequest(QContactAbstractRequest *request, const QSharedPointer<QContactMemoryRequestJob> &job);
+
     QContactMemoryEngineData *d;
+    QThreadPool *m_threadPool;                // null unless the "workerThreads" parameter was given
+    QHash<QContactAbstractRequest *, QSharedPointer<QContactMemoryRequestJob> > m_threadedRequests;
     static QMap<QString, QContactMemoryEngineData*> engineDatas;
 
     friend class QContactMemoryEngineData;
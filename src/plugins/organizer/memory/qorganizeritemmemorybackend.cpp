@@ -99,6 +99,200 @@ QOrganizerItemMemoryEngineData::QOrganizerItemMemoryEngineData()
 
 }
 
+/* Spans of at most this length are kept sorted by their start; the others are tested one by one */
+static const qint64 ShortSpanMSecs = Q_INT64_C(7) * 24 * 60 * 60 * 1000;
+
+/*!
+  Computes the \a span of times at which the given \a item can be found by a date range query.
+  Returns false if the item is never found by such queries, or if it has to be tested for
+  every query, in which case \a unindexed is set.
+
+  For a recurring item, the span starts at its first occurrence and ends at the last instant
+  of the latest limit date of its recurrence rules and of its recurrence dates, or is unbounded
+  if any rule has no limit date.
+ */
+bool QOrganizerItemMemoryEngineTimeIndex::itemSpan(const QOrganizerItem &item, Span *span, bool *unindexed)
+{
+    *unindexed = false;
+
+    if (QOrganizerManagerEngine::itemHasReccurence(item)) {
+        QDateTime initialDateTime;
+        if (item.type() == QOrganizerItemType::TypeEvent) {
+            QOrganizerEvent evt = item;
+            initialDateTime = evt.startDateTime().isValid() ? evt.startDateTime() : evt.endDateTime();
+        } else {
+            QOrganizerTodo todo = item;
+            initialDateTime = todo.startDateTime().isValid() ? todo.startDateTime() : todo.dueDateTime();
+        }
+        if (!initialDateTime.isValid()) {
+            *unindexed = true;
+            return false;
+        }
+
+        QOrganizerItemRecurrence recur = item.detail(QOrganizerItemDetail::TypeRecurrence);
+        QDate lastDate = initialDateTime.toLocalTime().date();
+        bool bounded = true;
+        foreach (const QOrganizerRecurrenceRule &rrule, recur.recurrenceRules()) {
+            if (rrule.frequency() == QOrganizerRecurrenceRule::Invalid)
+                continue;
+            if (rrule.limitType() != QOrganizerRecurrenceRule::DateLimit) {
+                bounded = false;
+                break;
+            }
+            lastDate = qMax(lastDate, rrule.limitDate());
+        }
+        foreach (const QDate &rdate, recur.recurrenceDates())
+            lastDate = qMax(lastDate, rdate);
+
+        span->start = initialDateTime;
+        span->end = bounded ? QDateTime(lastDate, QTime(23, 59, 59, 999)) : QDateTime();
+        return true;
+    }
+
+    // the times compared by QOrganizerManagerEngine::isItemBetweenDates()
+    QDateTime first;
+    QDateTime second;
+    if (item.type() == QOrganizerItemType::TypeEvent || item.type() == QOrganizerItemType::TypeEventOccurrence) {
+        QOrganizerEventTime etr = item.detail(QOrganizerItemDetail::TypeEventTime);
+        first = etr.startDateTime();
+        second = etr.endDateTime();
+    } else if (item.type() == QOrganizerItemType::TypeTodo || item.type() == QOrganizerItemType::TypeTodoOccurrence) {
+        QOrganizerTodoTime ttr = item.detail(QOrganizerItemDetail::TypeTodoTime);
+        first = ttr.startDateTime();
+        second = ttr.dueDateTime();
+    } else if (item.type() == QOrganizerItemType::TypeJournal) {
+        QOrganizerJournal journal = item;
+        first = journal.dateTime();
+    }
+
+    if (first.isNull())
+        first = second;
+    else if (second.isNull())
+        second = first;
+    if (first.isNull())
+        return false;
+
+    span->start = qMin(first, second);
+    span->end = qMax(first, second);
+    return true;
+}
+
+/*!
+  Indexes the span of the given \a item, replacing any span previously indexed for it.
+ */
+void QOrganizerItemMemoryEngineTimeIndex::insertItem(const QOrganizerItem &item)
+{
+    const QOrganizerItemId itemId = item.id();
+    removeItem(itemId);
+
+    Span span;
+    bool unindexed = false;
+    if (!itemSpan(item, &span, &unindexed)) {
+        if (unindexed)
+            m_unindexedItems.insert(itemId);
+        return;
+    }
+
+    m_spans.insert(itemId, span);
+    if (!span.end.isNull() && span.start.msecsTo(span.end) <= ShortSpanMSecs)
+        m_shortSpans.insert(span.start, itemId);
+    else
+        m_longSpans.insert(itemId);
+}
+
+/*!
+  Removes the span indexed for the item identified by \a itemId.
+ */
+void QOrganizerItemMemoryEngineTimeIndex::removeItem(const QOrganizerItemId &itemId)
+{
+    m_unindexedItems.remove(itemId);
+
+    QHash<QOrganizerItemId, Span>::iterator it = m_spans.find(itemId);
+    if (it == m_spans.end())
+        return;
+
+    if (!m_longSpans.remove(itemId))
+        m_shortSpans.remove(it->start, itemId);
+    m_spans.erase(it);
+}
+
+/*!
+  Returns the ids of the items which may be found by a query for the period between
+  \a startDateTime and \a endDateTime, either of which may be null.
+
+  The candidates are a superset of the items found; they still have to be tested
+  with QOrganizerManagerEngine::isItemBetweenDates() or have their occurrences generated.
+ */
+QList<QOrganizerItemId> QOrganizerItemMemoryEngineTimeIndex::candidates(const QDateTime &startDateTime, const QDateTime &endDateTime) const
+{
+    QList<QOrganizerItemId> result;
+    if (!startDateTime.isNull() && !endDateTime.isNull() && startDateTime > endDateTime)
+        return result;
+
+    result.reserve(m_unindexedItems.size());
+    foreach (const QOrganizerItemId &itemId, m_unindexedItems)
+        result.append(itemId);
+
+    // a short span ending after the period start begins at most ShortSpanMSecs before it.
+    QMultiMap<QDateTime, QOrganizerItemId>::const_iterator it = startDateTime.isNull()
+            ? m_shortSpans.constBegin() : m_shortSpans.lowerBound(startDateTime.addMSecs(-ShortSpanMSecs));
+    const QMultiMap<QDateTime, QOrganizerItemId>::const_iterator end = endDateTime.isNull()
+            ? m_shortSpans.constEnd() : m_shortSpans.upperBound(endDateTime);
+    for ( ; it != end; ++it) {
+        if (startDateTime.isNull() || m_spans.value(it.value()).end >= startDateTime)
+            result.append(it.value());
+    }
+
+    foreach (const QOrganizerItemId &itemId, m_longSpans) {
+        const Span span = m_spans.value(itemId);
+        if ((endDateTime.isNull() || span.start <= endDateTime)
+                && (startDateTime.isNull() || span.end.isNull() || span.end >= startDateTime)) {
+            result.append(itemId);
+        }
+    }
+
+    return result;
+}
+
+/*!
+  Stores the given \a item, replacing any item with the same id, and updates the indexes.
+ */
+void QOrganizerItemMemoryEngineData::insertItem(const QOrganizerItem &item)
+{
+    const QOrganizerItemId itemId = item.id();
+    removeItem(itemId);
+
+    m_idToItemHash.insert(itemId, item);
+    m_timeIndex.insertItem(item);
+
+    const QOrganizerItemParent parentDetail = item.detail(QOrganizerItemDetail::TypeParent);
+    if (!parentDetail.parentId().isNull())
+        m_parentIdToExceptionsHash[parentDetail.parentId()].insert(parentDetail.originalDate(), itemId);
+}
+
+/*!
+  Removes the item identified by \a itemId, and its entries in the indexes.
+ */
+void QOrganizerItemMemoryEngineData::removeItem(const QOrganizerItemId &itemId)
+{
+    QHash<QOrganizerItemId, QOrganizerItem>::iterator it = m_idToItemHash.find(itemId);
+    if (it == m_idToItemHash.end())
+        return;
+
+    const QOrganizerItemParent parentDetail = it->detail(QOrganizerItemDetail::TypeParent);
+    if (!parentDetail.parentId().isNull()) {
+        QHash<QOrganizerItemId, QMultiMap<QDate, QOrganizerItemId> >::iterator exceptions = m_parentIdToExceptionsHash.find(parentDetail.parentId());
+        if (exceptions != m_parentIdToExceptionsHash.end()) {
+            exceptions->remove(parentDetail.originalDate(), itemId);
+            if (exceptions->isEmpty())
+                m_parentIdToExceptionsHash.erase(exceptions);
+        }
+    }
+
+    m_timeIndex.removeItem(itemId);
+    m_idToItemHash.erase(it);
+}
+
 /*!
  * Factory function for creating a new in-memory backend, based
  * on the given \a parameters.
@@ -250,29 +444,29 @@ QList<QOrganizerItem> QOrganizerItemMemoryEngine::internalItemOccurrences(const
     }
 
     QList<QOrganizerItem> retn;
-    QList<QOrganizerItem> xoccurrences;
+    QMultiMap<QDate, QOrganizerItem> xoccurrences; // persisted exceptions, by original date
     QOrganizerItemRecurrence recur = parentItem.detail(QOrganizerItemDetail::TypeRecurrence);
 
     if (includeExceptions) {
         // first, retrieve all persisted instances (exceptions) which occur between the specified datetimes.
-        foreach (const QOrganizerItem& item, d->m_idToItemHash) {
-            if (item.detail(QOrganizerItemDetail::TypeParent).value<QOrganizerItemId>(QOrganizerItemParent::FieldParentId) == parentItem.id()) {
-                QDateTime lowerBound;
-                QDateTime upperBound;
-                if (item.type() == QOrganizerItemType::TypeEventOccurrence) {
-                    QOrganizerEventOccurrence instance = item;
-                    lowerBound = instance.startDateTime();
-                    upperBound = instance.endDateTime();
-                } else {
-                    QOrganizerTodoOccurrence instance = item;
-                    lowerBound = instance.startDateTime();
-                    upperBound = instance.dueDateTime();
-                }
+        const QMultiMap<QDate, QOrganizerItemId> exceptions = d->m_parentIdToExceptionsHash.value(parentItem.id());
+        for (QMultiMap<QDate, QOrganizerItemId>::const_iterator it = exceptions.constBegin(); it != exceptions.constEnd(); ++it) {
+            const QOrganizerItem item = d->m_idToItemHash.value(it.value());
+            QDateTime lowerBound;
+            QDateTime upperBound;
+            if (item.type() == QOrganizerItemType::TypeEventOccurrence) {
+                QOrganizerEventOccurrence instance = item;
+                lowerBound = instance.startDateTime();
+                upperBound = instance.endDateTime();
+            } else {
+                QOrganizerTodoOccurrence instance = item;
+                lowerBound = instance.startDateTime();
+                upperBound = instance.dueDateTime();
+            }
 
-                if ((lowerBound.isNull() || lowerBound >= realPeriodStart) && (upperBound.isNull() || upperBound <= realPeriodEnd)) {
-                    // this occurrence fulfils the criteria.
-                    xoccurrences.append(item);
-                }
+            if ((lowerBound.isNull() || lowerBound >= realPeriodStart) && (upperBound.isNull() || upperBound <= realPeriodEnd)) {
+                // this occurrence fulfils the criteria.
+                xoccurrences.insert(it.key(), item);
             }
         }
     }
@@ -338,11 +532,9 @@ QList<QOrganizerItem> QOrganizerItemMemoryEngine::internalItemOccurrences(const
                 // generate the required instance and add it to the return list.
                 retn.append(QOrganizerManagerEngine::generateOccurrence(parentItem, rdate));
             } else if (includeExceptions) {
-                for (int i = 0; i < xoccurrences.size(); i++) {
-                    QOrganizerItemParent parentDetail = xoccurrences[i].detail(QOrganizerItemDetail::TypeParent);
-                    if (parentDetail.originalDate() == localRDate)
-                        retn.append(xoccurrences[i]);
-                }
+                QMultiMap<QDate, QOrganizerItem>::const_iterator it = xoccurrences.constFind(localRDate);
+                for ( ; it != xoccurrences.constEnd() && it.key() == localRDate; ++it)
+                    retn.append(it.value());
             } else if (exceptionDates) {
                 exceptionDates->append(localRDate);
             }
@@ -458,48 +650,65 @@ QList<QOrganizerItem> QOrganizerItemMemoryEngine::internalItems(const QDateTime&
 
     QList<QOrganizerItem> sorted;
     QSet<QOrganizerItemId> parentsAdded;
-    bool isDefFilter = (filter.type() == QOrganizerItemFilter::DefaultFilter);
+    const QOrganizerItemFilterProgram program(filter);
+    if (program.matchesNone())
+        return sorted;
+    bool isDefFilter = program.matchesAll();
 
-    foreach(const QOrganizerItem& c, d->m_idToItemHash) {
+    const auto addItem = [&](const QOrganizerItem &c) {
         if (itemHasReccurence(c)) {
-            addItemRecurrences(sorted, c, startDate, endDate, filter, sortOrders, forExport, &parentsAdded);
+            addItemRecurrences(sorted, c, startDate, endDate, program, forExport, &parentsAdded);
         } else {
-            if ((isDefFilter || QOrganizerManagerEngine::testFilter(filter, c)) && QOrganizerManagerEngine::isItemBetweenDates(c, startDate, endDate)) {
-                QOrganizerManagerEngine::addSorted(&sorted,c, sortOrders);
+            if ((isDefFilter || program.matches(c)) && QOrganizerManagerEngine::isItemBetweenDates(c, startDate, endDate)) {
+                sorted.append(c);
                 if (forExport
                         && (c.type() == QOrganizerItemType::TypeEventOccurrence
                         ||  c.type() == QOrganizerItemType::TypeTodoOccurrence)) {
                     QOrganizerItemId parentId(c.detail(QOrganizerItemDetail::TypeParent).value<QOrganizerItemId>(QOrganizerItemParent::FieldParentId));
                     if (!parentsAdded.contains(parentId)) {
                         parentsAdded.insert(parentId);
-                        QOrganizerManagerEngine::addSorted(&sorted, item(parentId), sortOrders);
+                        sorted.append(item(parentId));
                     }
                 }
             }
         }
+    };
+
+    if (startDate.isNull() && endDate.isNull()) {
+        foreach (const QOrganizerItem &c, d->m_idToItemHash)
+            addItem(c);
+    } else {
+        // only visit the items whose span can overlap the period
+        foreach (const QOrganizerItemId &id, d->m_timeIndex.candidates(startDate, endDate)) {
+            QHash<QOrganizerItemId, QOrganizerItem>::const_iterator it = d->m_idToItemHash.constFind(id);
+            if (it != d->m_idToItemHash.constEnd())
+                addItem(it.value());
+        }
     }
 
+    // sort the collected items in one go
+    QOrganizerManagerEngine::sortItemsInPlace(&sorted, sortOrders);
     return sorted;
 }
 
 
-void QOrganizerItemMemoryEngine::addItemRecurrences(QList<QOrganizerItem>& sorted, const QOrganizerItem& c, const QDateTime& startDate, const QDateTime& endDate, const QOrganizerItemFilter& filter, const QList<QOrganizerItemSortOrder>& sortOrders, bool forExport, QSet<QOrganizerItemId>* parentsAdded) const
+void QOrganizerItemMemoryEngine::addItemRecurrences(QList<QOrganizerItem>& sorted, const QOrganizerItem& c, const QDateTime& startDate, const QDateTime& endDate, const QOrganizerItemFilterProgram& filter, bool forExport, QSet<QOrganizerItemId>* parentsAdded) const
 {
     QOrganizerManager::Error error = QOrganizerManager::NoError;
     if (forExport && parentsAdded->contains(c.id()))
         return;
 
     QList<QOrganizerItem> recItems = internalItemOccurrences(c, startDate, endDate, forExport ? 1 : 50, false, false, 0, &error); // XXX TODO: why maxcount of 50?
-    if (filter.type() == QOrganizerItemFilter::DefaultFilter) {
+    if (filter.matchesAll()) {
         foreach(const QOrganizerItem& oi, recItems) {
-            QOrganizerManagerEngine::addSorted(&sorted, forExport ? c : oi, sortOrders);
+            sorted.append(forExport ? c : oi);
             if (forExport)
                 parentsAdded->insert(c.id());
         }
     } else {
         foreach(const QOrganizerItem& oi, recItems) {
-            if (QOrganizerManagerEngine::testFilter(filter, oi)) {
-                QOrganizerManagerEngine::addSorted(&sorted, forExport ? c : oi, sortOrders);
+            if (filter.matches(oi)) {
+                sorted.append(forExport ? c : oi);
                 if (forExport)
                     parentsAdded->insert(c.id());
             }
@@ -554,7 +763,7 @@ bool QOrganizerItemMemoryEngine::storeItem(QOrganizerItem* theOrganizerItem, QOr
             return false;
         }
         // Looks ok, so continue
-        d->m_idToItemHash.insert(theOrganizerItemId, *theOrganizerItem); // replacement insert.
+        d->insertItem(*theOrganizerItem); // replacement insert.
         changeSet.insertChangedItem(theOrganizerItemId, detailMask);
 
         // cross-check if stored exception occurrences are still valid
@@ -564,7 +773,7 @@ bool QOrganizerItemMemoryEngine::storeItem(QOrganizerItem* theOrganizerItem, QOr
 
             // should we also check and remove exception dates if e.g. limit date or limit count has been changed
             // to be earlier (or smaller) than before thus invelidating an exception date..?
-            QList<QOrganizerItemId> occurrenceIds = d->m_parentIdToChildIdHash.values(theOrganizerItemId);
+            QList<QOrganizerItemId> occurrenceIds = d->exceptionIds(theOrganizerItemId);
             QOrganizerManager::Error occurrenceError = QOrganizerManager::NoError;
             if (!occurrenceIds.isEmpty()) {
                 if (itemHasReccurence(*theOrganizerItem)) {
@@ -641,7 +850,7 @@ bool QOrganizerItemMemoryEngine::storeItem(QOrganizerItem* theOrganizerItem, QOr
                 currentExceptionDates << originalDate;
                 recurrence.setExceptionDates(currentExceptionDates);
                 parentItem.saveDetail(&recurrence);
-                d->m_idToItemHash.insert(parentId, parentItem); // replacement insert
+                d->insertItem(parentItem); // replacement insert
                 changeSet.insertChangedItem(parentId, detailMask); // is this correct?  it's an exception, so change parent?
             }
         }
@@ -656,11 +865,7 @@ bool QOrganizerItemMemoryEngine::storeItem(QOrganizerItem* theOrganizerItem, QOr
         theOrganizerItem->setId(theOrganizerItemId);
         // finally, add the organizer item to our internal lists and return
         theOrganizerItem->setCollectionId(targetCollectionId);
-        d->m_idToItemHash.insert(theOrganizerItemId, *theOrganizerItem);  // add organizer item to hash
-        if (!parentId.isNull()) {
-            // if it was an occurrence, we need to add it to the children hash.
-            d->m_parentIdToChildIdHash.insert(parentId, theOrganizerItemId);
-        }
+        d->insertItem(*theOrganizerItem);  // add organizer item to hash (and an occurrence to its parent's exceptions)
         d->m_itemsInCollectionsHash.insert(targetCollectionId, theOrganizerItemId);
         changeSet.insertAddedItem(theOrganizerItemId);
     }
@@ -918,25 +1123,18 @@ bool QOrganizerItemMemoryEngine::removeItem(const QOrganizerItemId& organizerite
         return false;
     }
 
-    // if it is a child item, remove itself from the children hash
-    QOrganizerItem thisItem = hashIterator.value();
-    QOrganizerItemParent parentDetail = thisItem.detail(QOrganizerItemDetail::TypeParent);
-    if (!parentDetail.parentId().isNull()) {
-        d->m_parentIdToChildIdHash.remove(parentDetail.parentId(), organizeritemId);
-    }
-
     // if it is a parent item, remove any children.
-    QList<QOrganizerItemId> childrenIds = d->m_parentIdToChildIdHash.values(organizeritemId);
+    // (a child item is removed from its parent's exceptions along with the item itself)
+    QList<QOrganizerItemId> childrenIds = d->exceptionIds(organizeritemId);
     foreach (const QOrganizerItemId& childId, childrenIds) {
         // remove the child occurrence from our lists.
-        d->m_idToItemHash.remove(childId);
+        d->removeItem(childId);
         d->m_itemsInCollectionsHash.remove(d->m_itemsInCollectionsHash.key(childId), childId);
         changeSet.insertRemovedItem(childId);
     }
 
     // remove the organizer item from the lists.
-    d->m_idToItemHash.remove(organizeritemId);
-    d->m_parentIdToChildIdHash.remove(organizeritemId);
+    d->removeItem(organizeritemId);
     d->m_itemsInCollectionsHash.remove(d->m_itemsInCollectionsHash.key(organizeritemId), organizeritemId);
     *error = QOrganizerManager::NoError;
 
@@ -967,7 +1165,7 @@ bool QOrganizerItemMemoryEngine::removeOccurrence(const QOrganizerItem &organize
         exceptionDates.insert(parentDetail.originalDate());
         recurrenceDetail.setExceptionDates(exceptionDates);
         parentItem.saveDetail(&recurrenceDetail);
-        d->m_idToItemHash.insert(parentDetail.parentId(), parentItem);
+        d->insertItem(parentItem);
         changeSet.insertChangedItem(parentDetail.parentId(), QList<QOrganizerItemDetail::DetailType>());
     }
     *error = QOrganizerManager::NoError;
@@ -56,6 +56,7 @@
 #include <QtOrganizer/qorganizercollectionchangeset.h>
 #include <QtOrganizer/qorganizeritemchangeset.h>
 #include <QtOrganizer/qorganizerrecurrencerule.h>
+#include <QtOrganizer/private/qorganizeritemfilterprogram_p.h>
 
 QT_BEGIN_NAMESPACE_ORGANIZER
 
@@ -70,6 +71,29 @@ public:
 };
 
 
+class QOrganizerItemMemoryEngineTimeIndex
+{
+public:
+    void insertItem(const QOrganizerItem &item);
+    void removeItem(const QOrganizerItemId &itemId);
+
+    QList<QOrganizerItemId> candidates(const QDateTime &startDateTime, const QDateTime &endDateTime) const;
+
+private:
+    struct Span
+    {
+        QDateTime start;
+        QDateTime end;                            // null if the span is unbounded
+    };
+
+    static bool itemSpan(const QOrganizerItem &item, Span *span, bool *unindexed);
+
+    QHash<QOrganizerItemId, Span> m_spans;                  // span of each indexed item
+    QMultiMap<QDateTime, QOrganizerItemId> m_shortSpans;    // items with short spans, by span start
+    QSet<QOrganizerItemId> m_longSpans;                     // items with long or unbounded spans
+    QSet<QOrganizerItemId> m_unindexedItems;                // recurring items without a start, which are always candidates
+};
+
 class QOrganizerAbstractRequest;
 class QOrganizerManagerEngine;
 class QOrganizerItemMemoryEngineData : public QSharedData
@@ -82,10 +106,19 @@ public:
     {
     }
 
+    void insertItem(const QOrganizerItem &item);
+    void removeItem(const QOrganizerItemId &itemId);
+
+    QList<QOrganizerItemId> exceptionIds(const QOrganizerItemId &parentId) const
+    {
+        return m_parentIdToExceptionsHash.value(parentId).values();
+    }
+
     QString m_id;                                  // the id parameter value
 
     QHash<QOrganizerItemId, QOrganizerItem> m_idToItemHash; // hash of id to the item identified by that id
-    QMultiHash<QOrganizerItemId, QOrganizerItemId> m_parentIdToChildIdHash; // hash of id to that item's children's ids
+    QOrganizerItemMemoryEngineTimeIndex m_timeIndex; // spans of the items in m_idToItemHash, for date range queries
+    QHash<QOrganizerItemId, QMultiMap<QDate, QOrganizerItemId> > m_parentIdToExceptionsHash; // hash of id to that item's exception occurrences' ids, by original date
     QHash<QOrganizerCollectionId, QOrganizerCollection> m_idToCollectionHash; // hash of id to the collection identified by that id
     QMultiHash<QOrganizerCollectionId, QOrganizerItemId> m_itemsInCollectionsHash; // hash of collection ids to the ids of items the collection contains.
     quint32 m_nextOrganizerItemId; // the localId() portion of a QOrganizerItemId
@@ -211,7 +244,7 @@ private:
     QList<QOrganizerItem> itemsForExport(const QList<QOrganizerItemId> &ids, const QOrganizerItemFetchHint &fetchHint, QMap<int, QOrganizerManager::Error> *errorMap, QOrganizerManager::Error *error);
     QList<QOrganizerItem> internalItems(const QDateTime& startDate, const QDateTime& endDate, const QOrganizerItemFilter& filter, const QList<QOrganizerItemSortOrder>& sortOrders, const QOrganizerItemFetchHint& fetchHint, QOrganizerManager::Error* error, bool forExport) const;
     QList<QOrganizerItem> internalItemOccurrences(const QOrganizerItem& parentItem, const QDateTime& periodStart, const QDateTime& periodEnd, int maxCount, bool includeExceptions, bool sortItems, QList<QDate> *exceptionDates, QOrganizerManager::Error* error) const;
-    void addItemRecurrences(QList<QOrganizerItem>& sorted, const QOrganizerItem& c, const QDateTime& startDate, const QDateTime& endDate, const QOrganizerItemFilter& filter, const QList<QOrganizerItemSortOrder>& sortOrders, bool forExport, QSet<QOrganizerItemId>* parentsAdded) const;
+    void addItemRecurrences(QList<QOrganizerItem>& sorted, const QOrganizerItem& c, const QDateTime& startDate, const QDateTime& endDate, const QOrganizerItemFilterProgram& filter, bool forExport, QSet<QOrganizerItemId>* parentsAdded) const;
 
     bool fixOccurrenceReferences(QOrganizerItem* item, QOrganizerManager::Error* error);
     bool typesAreRelated(QOrganizerItemType::ItemType occurrenceType, QOrganizerItemType::ItemType parentType);
@@ -180,25 +180,25 @@ void BackupVCardHandler::detailProcessed(
     Q_UNUSED(toBeRemoved);
     if (detail.accessConstraints().testFlag(QContactDetail::ReadOnly))
         return;
-    QMap<int, QVariant> fields = detail.values();
     // fields from the same detail have the same group so the importer can collate them
     QString detailGroup = GroupPrefix + QString::number(mDetailNumber++);
     int toBeAddedCount = toBeAdded->count();
     bool propertiesSynthesized = false;
-    for (QMap<int, QVariant>::const_iterator it = fields.constBegin(); it != fields.constEnd(); it++) {
-        if (!processedFields->contains(it.key()) && !it.value().toString().isEmpty()) {
+    for (int field = detail.nextField(); field != -1; field = detail.nextField(field)) {
+        const QVariant value = detail.value(field);
+        if (!processedFields->contains(field) && !value.toString().isEmpty()) {
             // Generate a property for the unknown field
             QVersitProperty property;
             property.setGroups(QStringList(detailGroup));
             property.setName(PropertyName);
             property.insertParameter(DetailTypeParameter, QString::number(detail.type()));
-            property.insertParameter(FieldParameter, QString::number(it.key()));
+            property.insertParameter(FieldParameter, QString::number(field));
 
-            serializeValue(&property, it.value());
+            serializeValue(&property, value);
 
             toBeAdded->append(property);
             propertiesSynthesized = true;
-            processedFields->insert(it.key());
+            processedFields->insert(field);
         }
     }
     if (propertiesSynthesized) {
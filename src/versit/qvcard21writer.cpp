@@ -39,7 +39,6 @@
 
 #include "qvcard21writer_p.h"
 
-#include <QtCore/qregularexpression.h>
 #include <QtCore/qvariant.h>
 #include <QtCore/qurl.h>
 
@@ -56,16 +55,6 @@ QVCard21Writer::QVCard21Writer(QVersitDocument::VersitType type) : QVersitDocume
 {
 }
 
-QTextEncoder* QVCard21Writer::utf8Encoder()
-{
-    static QTextEncoder* encoder = 0;
-    if (encoder == 0) {
-        // prevent output of byte order mark for UTF-8 encoding
-        encoder = QTextCodec::codecForName("UTF-8")->makeEncoder(QStringConverterBase::Flag::Default);
-    }
-    return encoder;
-}
-
 /*! Destroys a writer. */
 QVCard21Writer::~QVCard21Writer()
 {
@@ -102,7 +91,6 @@ void QVCard21Writer::encodeVersitProperty(const QVersitProperty& property)
             separator = QStringLiteral(",");
         }
         QString replacement = QLatin1Char('\\') + separator;
-        const QRegularExpression separatorRegex(separator);
 
         // Check first if any of the values need to be UTF-8 encoded (if so, all of them must be
         // UTF-8 encoded)
@@ -115,7 +103,7 @@ void QVCard21Writer::encodeVersitProperty(const QVersitProperty& property)
                 if (!first) {
                     renderedValue += separator;
                 }
-                renderedValue += value.replace(separatorRegex, replacement);
+                renderedValue += value.replace(separator, replacement);
                 first = false;
             }
         }
@@ -164,7 +152,7 @@ void QVCard21Writer::encodeVersitProperty(const QVersitProperty& property)
 /*! Returns true if and only if the current codec is incapable of encoding any of the \a values */
 bool QVCard21Writer::requiresUtf8(const QStringList& values) {
     foreach (const QString& value, values) {
-        if (!mCodec->canEncode(value)
+        if (!canEncode(value)
             // if codec is ASCII and there is a character > U+007F in value, encode it as UTF-8
             || (mCodecIsAscii && containsNonAscii(value))) {
             return true;
@@ -180,11 +168,11 @@ void QVCard21Writer::encodeVersitValue(QMultiHash<QString,QString>& parameters,
 {
     // Add the CHARSET parameter, if necessary and encode in UTF-8 later
     if (forceUtf8
-            || !mCodec->canEncode(value)
+            || !canEncode(value)
             // if codec is ASCII and there is a character > U+007F in value, encode it as UTF-8
             || (mCodecIsAscii && containsNonAscii(value))) {
         parameters.replace(QStringLiteral("CHARSET"), QStringLiteral("UTF-8"));
-        value = QString::fromLatin1(utf8Encoder()->fromUnicode(value));
+        value = QString::fromLatin1(value.toUtf8());
     }
 
     // Quoted-Printable encode the value and add Quoted-Printable parameter, if necessary
@@ -256,18 +244,31 @@ bool QVCard21Writer::containsNonAscii(const QString& str)
  */
 bool QVCard21Writer::quotedPrintableEncode(QString& text)
 {
-    bool encoded = false;
-    for (int i=0; i<text.length(); i++) {
-        QChar current = text.at(i);
+    const QChar* data = text.constData();
+    const int length = text.length();
+    int i = 0;
+    while (i < length && !shouldBeQuotedPrintableEncoded(data[i]))
+        i++;
+    if (i == length)
+        return false;
+
+    // Encode the rest in a single pass, rather than replacing each character in place
+    static const char hexDigits[] = "0123456789ABCDEF";
+    QString encoded;
+    encoded.reserve(length + 2 * (length - i));
+    encoded.append(data, i);
+    for (; i < length; i++) {
+        const QChar current = data[i];
         if (shouldBeQuotedPrintableEncoded(current)) {
-            QString encodedStr(QString::fromLatin1("=%1").
-                               arg(current.unicode(), 2, 16, QLatin1Char('0')).toUpper());
-            text.replace(i, 1, encodedStr);
-            i += 2;
-            encoded = true;
+            encoded.append(QLatin1Char('='));
+            encoded.append(QLatin1Char(hexDigits[(current.unicode() >> 4) & 0xF]));
+            encoded.append(QLatin1Char(hexDigits[current.unicode() & 0xF]));
+        } else {
+            encoded.append(current);
         }
     }
-    return encoded;
+    text = encoded;
+    return true;
 }
 
 
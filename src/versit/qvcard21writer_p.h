@@ -68,9 +68,6 @@ public:
     static bool containsNonAscii(const QString& str);
     static bool quotedPrintableEncode(QString& text);
     static bool shouldBeQuotedPrintableEncoded(QChar chr);
-
-private:
-    static QTextEncoder* utf8Encoder();
 };
 
 QT_END_NAMESPACE_VERSIT
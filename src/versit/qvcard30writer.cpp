@@ -40,7 +40,6 @@
 #include "qvcard30writer_p.h"
 
 #include <QtCore/qbuffer.h>
-#include <QtCore/qregularexpression.h>
 #include <QtCore/qvariant.h>
 #include <QtCore/qurl.h>
 
@@ -72,18 +71,22 @@ QVCard30Writer::~QVCard30Writer()
  */
 void QVCard30Writer::encodeVersitProperty(const QVersitProperty& property)
 {
-    QVersitProperty modifiedProperty(property);
-    QString name = mPropertyNameMappings.value(property.name(),property.name());
-    modifiedProperty.setName(name);
-    encodeGroupsAndName(modifiedProperty);
+    // The property is not copied: modifying the copy would detach it, deep copying its groups,
+    // parameters and value for every property written.
+    QHash<QString,QString>::const_iterator mapping = mPropertyNameMappings.constFind(property.name());
+    encodeGroupsAndName(property, mapping == mPropertyNameMappings.constEnd()
+                                  ? property.name() : mapping.value());
 
-    QVariant variant(modifiedProperty.variantValue());
+    QVariant variant(property.variantValue());
     if (variant.metaType().id() == QMetaType::QByteArray) {
-        modifiedProperty.insertParameter(QStringLiteral("ENCODING"), QStringLiteral("b"));
-    } else if (variant.metaType().id() == QMetaType::QUrl) {
-        variant = QVariant(variant.toUrl().toString());
+        QMultiHash<QString,QString> parameters(property.parameters());
+        parameters.insert(QStringLiteral("ENCODING"), QStringLiteral("b"));
+        encodeParameters(parameters);
+    } else {
+        if (variant.metaType().id() == QMetaType::QUrl)
+            variant = QVariant(variant.toUrl().toString());
+        encodeParameters(property.parameters());
     }
-    encodeParameters(modifiedProperty.parameters());
     writeString(QStringLiteral(":"));
 
     QString renderedValue;
@@ -177,17 +180,47 @@ void QVCard30Writer::encodeParameters(const QMultiHash<QString,QString>& paramet
  */
 void QVCard30Writer::backSlashEscape(QString* text)
 {
-    static const QString m1(QStringLiteral("([;,\\\\])"));
-    static const QString r1(QStringLiteral("\\\\1"));
-    static const QString m2(QStringLiteral("\r\n|\r|\n"));
-    static const QString r2(QStringLiteral("\\n"));
     /* replaces ; with \;
                 , with \,
                 \ with \\
-     */
-    text->replace(QRegularExpression(m1), r1);
-    // replaces any CRLFs with \n
-    text->replace(QRegularExpression(m2), r2);
+                any of CRLF, CR and LF with \n
+       in a single pass, leaving the string untouched (and unallocated) if there is nothing to do */
+    const QChar* data = text->constData();
+    const int length = text->length();
+    int i = 0;
+    while (i < length) {
+        const ushort c = data[i].unicode();
+        if (c == ';' || c == ',' || c == '\\' || c == '\r' || c == '\n')
+            break;
+        i++;
+    }
+    if (i == length)
+        return;
+
+    QString escaped;
+    escaped.reserve(length + length / 8 + 2);
+    escaped.append(data, i);
+    for (; i < length; i++) {
+        const QChar c = data[i];
+        switch (c.unicode()) {
+        case ';':
+        case ',':
+        case '\\':
+            escaped.append(QLatin1Char('\\'));
+            escaped.append(c);
+            break;
+        case '\r':
+            if (i + 1 < length && data[i + 1] == QLatin1Char('\n'))
+                i++;
+            Q_FALLTHROUGH();
+        case '\n':
+            escaped.append(QLatin1String("\\n"));
+            break;
+        default:
+            escaped.append(c);
+        }
+    }
+    *text = escaped;
 }
 
 QT_END_NAMESPACE_VERSIT
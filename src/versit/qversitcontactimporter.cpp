@@ -40,6 +40,11 @@
 #include "qversitcontactimporter.h"
 #include "qversitcontactimporter_p.h"
 
+#include <QtCore/qthreadpool.h>
+
+// The smallest number of documents worth handing to a thread of their own
+#define MIN_DOCUMENTS_PER_THREAD 64
+
 QT_BEGIN_NAMESPACE_VERSIT
 
 /*!
@@ -242,25 +247,110 @@ QVersitContactImporter::~QVersitContactImporter()
  */
 bool QVersitContactImporter::importDocuments(const QList<QVersitDocument>& documents)
 {
-    int documentIndex = 0;
-    int contactIndex = 0;
     d->mContacts.clear();
     d->mErrors.clear();
-    bool ok = true;
-    foreach (const QVersitDocument& document, documents) {
-        QContact contact;
-        QVersitContactImporter::Error error;
-        if (d->importContact(document, contactIndex, &contact, &error)) {
-            d->mContacts.append(contact);
-            contactIndex++;
-        } else {
-            d->mErrors.insert(documentIndex, error);
-            ok = false;
+
+    // Property handlers and resource handlers supplied by the client may not be safe to call
+    // from several threads at once (and v1 handlers rely on contact indices), so only documents
+    // handled entirely by the importer and its plugins are imported concurrently.
+    const int threadCount = qMin(d->mMaxThreadCount, documents.size() / MIN_DOCUMENTS_PER_THREAD);
+    if (threadCount < 2
+            || d->mPropertyHandler
+            || d->mPropertyHandler2
+            || d->mResourceHandler != d->mDefaultResourceHandler) {
+        int documentIndex = 0;
+        int contactIndex = 0;
+        bool ok = true;
+        foreach (const QVersitDocument& document, documents) {
+            QContact contact;
+            QVersitContactImporter::Error error;
+            if (d->importContact(document, contactIndex, &contact, &error)) {
+                d->mContacts.append(contact);
+                contactIndex++;
+            } else {
+                d->mErrors.insert(documentIndex, error);
+                ok = false;
+            }
+            documentIndex++;
         }
-        documentIndex++;
+        return ok;
     }
 
-    return ok;
+    // Each thread imports a contiguous range of documents with its own importer, so that the
+    // per-document state of the importer and its plugins is never shared.
+    struct ImportBatch {
+        QVersitContactImporterPrivate* importer;
+        int begin;
+        int end;
+        QList<QContact> contacts;
+        QMap<int, QVersitContactImporter::Error> errors;
+    };
+    QList<ImportBatch> batches;
+    const int batchSize = (documents.size() + threadCount - 1) / threadCount;
+    for (int begin = 0; begin < documents.size(); begin += batchSize) {
+        // The plugins are loaded here rather than on the worker threads.
+        ImportBatch batch;
+        batch.importer = new QVersitContactImporterPrivate(d->mProfiles);
+        batch.begin = begin;
+        batch.end = qMin(begin + batchSize, documents.size());
+        batches.append(batch);
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    for (int i = 0; i < batches.size(); i++) {
+        ImportBatch* batch = &batches[i];
+        pool.start([batch, &documents]() {
+            for (int documentIndex = batch->begin; documentIndex < batch->end; documentIndex++) {
+                QContact contact;
+                QVersitContactImporter::Error error;
+                if (batch->importer->importContact(documents.at(documentIndex),
+                                                   batch->contacts.size(), &contact, &error)) {
+                    batch->contacts.append(contact);
+                } else {
+                    batch->errors.insert(documentIndex, error);
+                }
+            }
+        });
+    }
+    pool.waitForDone();
+
+    d->mContacts.reserve(documents.size());
+    foreach (const ImportBatch& batch, batches) {
+        d->mContacts.append(batch.contacts);
+        for (QMap<int, QVersitContactImporter::Error>::const_iterator it = batch.errors.constBegin();
+             it != batch.errors.constEnd(); ++it) {
+            d->mErrors.insert(it.key(), it.value());
+        }
+        delete batch.importer;
+    }
+    return d->mErrors.isEmpty();
+}
+
+/*!
+ * Sets the maximum number of threads used by importDocuments() to \a count.  The default of 1
+ * imports the documents one after another on the calling thread.
+ *
+ * With a larger \a count, large lists of documents are split between up to \a count threads.  The
+ * contacts and the error map are the same as for a serial import.  Documents are always imported
+ * serially while a property handler or a custom resource handler is set, as these are not
+ * required to be thread-safe.  Values smaller than 1 are treated as 1.
+ *
+ * \sa maxThreadCount()
+ */
+void QVersitContactImporter::setMaxThreadCount(int count)
+{
+    d->mMaxThreadCount = qMax(1, count);
+}
+
+/*!
+ * Returns the maximum number of threads used by importDocuments().
+ *
+ * \sa setMaxThreadCount()
+ */
+int QVersitContactImporter::maxThreadCount() const
+{
+    return d->mMaxThreadCount;
 }
 
 /*!
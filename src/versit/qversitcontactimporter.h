@@ -103,6 +103,9 @@ public:
     QList<QContact> contacts() const;
     QMap<int, Error> errorMap() const;
 
+    void setMaxThreadCount(int count);
+    int maxThreadCount() const;
+
     void setPropertyHandler(QVersitContactImporterPropertyHandlerV2* handler);
 
     void setResourceHandler(QVersitResourceHandler* handler);
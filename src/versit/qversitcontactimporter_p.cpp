@@ -57,9 +57,11 @@ QT_BEGIN_NAMESPACE_VERSIT
  * Constructor.
  */
 QVersitContactImporterPrivate::QVersitContactImporterPrivate(const QStringList& profiles) :
+    mProfiles(profiles),
     mPropertyHandler(NULL),
     mPropertyHandler2(NULL),
     mPropertyHandlerVersion(0),
+    mMaxThreadCount(1),
     mDefaultResourceHandler(new QVersitDefaultResourceHandler),
     mResourceHandler(mDefaultResourceHandler)
 {
@@ -75,6 +77,7 @@ QVersitContactImporterPrivate::QVersitContactImporterPrivate(const QStringList&
         contactDetail.second =
             versitContactDetailMappings[i].detailField;
         mDetailMappings.insert(versitPropertyName,contactDetail);
+        mDetailCreators.insert(versitPropertyName, detailCreator(contactDetail.first));
     }
 
     // Context mappings
@@ -129,16 +132,19 @@ bool QVersitContactImporterPrivate::importContact(
     }
 
     // First, do the properties with PREF set so they appear first in the contact details
-    foreach (const QVersitProperty& property, properties) {
+    QList<bool> preferred;
+    preferred.reserve(properties.size());
+    for (int i = 0; i < properties.size(); i++) {
+        const QVersitProperty& property = properties.at(i);
         QStringList typeParameters = property.parameters().values(QStringLiteral("TYPE"));
-        if (typeParameters.contains(QStringLiteral("PREF"), Qt::CaseInsensitive))
+        preferred.append(typeParameters.contains(QStringLiteral("PREF"), Qt::CaseInsensitive));
+        if (preferred.last())
             importProperty(document, property, contactIndex, contact);
     }
     // ... then, do the rest of the properties.
-    foreach (const QVersitProperty& property, properties) {
-        QStringList typeParameters = property.parameters().values(QStringLiteral("TYPE"));
-        if (!typeParameters.contains(QStringLiteral("PREF"), Qt::CaseInsensitive))
-            importProperty(document, property, contactIndex, contact);
+    for (int i = 0; i < properties.size(); i++) {
+        if (!preferred.at(i))
+            importProperty(document, properties.at(i), contactIndex, contact);
     }
 
     contact->setType(QContactType::TypeContact);
@@ -156,87 +162,72 @@ bool QVersitContactImporterPrivate::importContact(
     return true;
 }
 
-void QVersitContactImporterPrivate::importProperty(
-        const QVersitDocument& document, const QVersitProperty& property, int contactIndex,
-        QContact* contact)
+/*!
+ * Returns the function that creates the details for a property mapped to a detail of \a type.
+ */
+QVersitContactImporterPrivate::DetailCreator QVersitContactImporterPrivate::detailCreator(
+        QContactDetail::DetailType type)
 {
-    if (mPropertyHandler
-        && mPropertyHandlerVersion == 1
-        && mPropertyHandler->preProcessProperty(document, property, contactIndex, contact))
-        return;
-
-    QPair<QContactDetail::DetailType, int> detailDefinition =
-        mDetailMappings.value(property.name());
-    QContactDetail::DetailType detailType = detailDefinition.first;
-
-    QList<QContactDetail> updatedDetails;
-
-    bool success = false;
-
-    // The following functions create and save the details to the contact
-    switch (detailType) {
+    switch (type) {
     case QContactDetail::TypeAddress:
-        success = createAddress(property, contact, &updatedDetails); // pass in group
-        break;
+        return &QVersitContactImporterPrivate::createAddress;
     case QContactDetail::TypeAnniversary:
-        success = createAnniversary(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createAnniversary;
     case QContactDetail::TypeAvatar:
-        success = createAvatar(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createAvatar;
     case QContactDetail::TypeBirthday:
-        success = createBirthday(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createBirthday;
     case QContactDetail::TypeExtendedDetail:
-        success = createExtendedDetail(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createExtendedDetail;
     case QContactDetail::TypeFamily:
-        success = createFamily(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createFamily;
     case QContactDetail::TypeFavorite:
-        success = createFavorite(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createFavorite;
     case QContactDetail::TypeGender:
-        success = createGender(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createGender;
     case QContactDetail::TypeGeoLocation:
-        success = createGeoLocation(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createGeoLocation;
     case QContactDetail::TypeName:
-        success = createName(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createName;
     case QContactDetail::TypeNickname:
-        success = createNicknames(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createNicknames;
     case QContactDetail::TypeDisplayLabel:
-        success = createDisplaylabel(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createDisplaylabel;
     case QContactDetail::TypeOnlineAccount:
-        success = createOnlineAccount(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createOnlineAccount;
     case QContactDetail::TypeOrganization:
-        success = createOrganization(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createOrganization;
     case QContactDetail::TypePhoneNumber:
-        success = createPhone(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createPhone;
     case QContactDetail::TypeRingtone:
-        success = createRingtone(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createRingtone;
     case QContactDetail::TypeTag:
-        success = createTags(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createTags;
     case QContactDetail::TypeTimestamp:
-        success = createTimeStamp(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createTimeStamp;
     case QContactDetail::TypeVersion:
-        success = createVersion(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createVersion;
     default:
-        // Look up mDetailMappings for a simple mapping from property to detail.
-        success = createNameValueDetail(property, contact, &updatedDetails);
-        break;
+        return &QVersitContactImporterPrivate::createNameValueDetail;
     }
+}
+
+void QVersitContactImporterPrivate::importProperty(
+        const QVersitDocument& document, const QVersitProperty& property, int contactIndex,
+        QContact* contact)
+{
+    if (mPropertyHandler
+        && mPropertyHandlerVersion == 1
+        && mPropertyHandler->preProcessProperty(document, property, contactIndex, contact))
+        return;
+
+    QList<QContactDetail> updatedDetails;
+
+    // The detail creators create and save the details to the contact.  Properties without a
+    // specific creator are handled with a simple mapping from property to detail.
+    DetailCreator createDetail =
+        mDetailCreators.value(property.name(), &QVersitContactImporterPrivate::createNameValueDetail);
+    bool success = (this->*createDetail)(property, contact, &updatedDetails);
 
     if (mRestoreHandler.propertyProcessed(property, &updatedDetails))
         success = true;
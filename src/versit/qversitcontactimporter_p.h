@@ -56,6 +56,7 @@
 #include <QtCore/qlist.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qpair.h>
+#include <QtCore/qstringlist.h>
 
 #include <QtContacts/qcontact.h>
 #include <QtContacts/qcontactdetail.h>
@@ -85,6 +86,11 @@ public:
                        QContact* contact, QVersitContactImporter::Error* error);
 
 private:
+    typedef bool (QVersitContactImporterPrivate::*DetailCreator)(
+            const QVersitProperty& property, QContact* contact,
+            QList<QContactDetail>* updatedDetails);
+    static DetailCreator detailCreator(QContactDetail::DetailType type);
+
     void importProperty(const QVersitDocument& document, const QVersitProperty& property, int contactIndex, QContact* contact);
     bool createName(const QVersitProperty& property, QContact* contact, QList<QContactDetail>* updatedDetails);
     bool createPhone(const QVersitProperty& property, QContact* contact, QList<QContactDetail>* updatedDetails);
@@ -117,17 +123,20 @@ private:
     void saveDetailWithContext(QList<QContactDetail>* updatedDetails, QContactDetail detail, const QList<int>& contexts);
 
 public: // Data
+    QStringList mProfiles;
     QList<QContact> mContacts;
     QMap<int, QVersitContactImporter::Error> mErrors;
     QVersitContactImporterPropertyHandler* mPropertyHandler;
     QVersitContactImporterPropertyHandlerV2* mPropertyHandler2;
     QList<QVersitContactHandler*> mPluginPropertyHandlers;
     int mPropertyHandlerVersion;
+    int mMaxThreadCount;
     QVersitDefaultResourceHandler* mDefaultResourceHandler;
     QVersitResourceHandler* mResourceHandler;
     QVCardRestoreHandler mRestoreHandler;
 
     QHash<QString, QPair<QContactDetail::DetailType, int> > mDetailMappings;
+    QHash<QString, DetailCreator> mDetailCreators; // property name -> function that imports it
     QMultiHash<QString, QPair<QContactDetail::DetailType, int> > mSubTypeMappings;
     QHash< int ,QString> mContextMappings;
 };
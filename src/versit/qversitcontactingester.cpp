@@ -0,0 +1,357 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtVersit module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qversitcontactingester.h"
+#include "qversitcontactingester_p.h"
+
+QT_BEGIN_NAMESPACE_VERSIT
+
+/*!
+  \class QVersitContactIngester
+  \brief The QVersitContactIngester class reads the vCards from a device and saves them as
+  contacts in a manager.
+  \ingroup versit
+  \inmodule QtVersit
+
+  QVersitContactIngester combines a QVersitReader, a QVersitContactImporter and a
+  QContactManager into a pipeline.  The input is read, imported and saved in batches of
+  batchSize() documents, each stage running on its own thread, so that a large input is saved
+  in about the time taken by its slowest stage while only a few batches are held in memory at
+  once.
+
+  After each batch has been saved, the progress() signal is emitted with the offset in the input
+  just past that batch.  If the ingestion is canceled or a batch fails to save, the ingester ends
+  in the CanceledState and the input can be resumed from checkpoint() with setStartOffset().
+  Every contact before the checkpoint has been saved.  Depending on the manager, some of the
+  contacts of a batch which failed to save may have been saved too, in which case they are saved
+  again when the input is resumed.
+
+  As the contacts are saved from a thread other than the one in which the ingester was created,
+  the manager must not be used by the client while the ingester is active.
+
+  \sa QVersitReader, QVersitContactImporter
+ */
+
+/*!
+ * \enum QVersitContactIngester::Error
+ * This enum specifies an error that occurred during the most recent operation:
+ * \value NoError The most recent operation was successful
+ * \value UnspecifiedError The most recent operation failed for an undocumented reason
+ * \value IOError The most recent operation failed because of a problem with the device
+ * \value NotReadyError The most recent operation failed because there is an operation in progress
+ * \value ParseError Some of the input was malformed and could not be read
+ * \value ImportError Some of the documents could not be imported as contacts
+ * \value SaveError A batch of contacts could not be saved, and the ingestion was stopped
+ */
+
+/*!
+ * \enum QVersitContactIngester::State
+ * Enumerates the various states that an ingester may be in at any given time
+ * \value InactiveState Ingestion not yet started
+ * \value ActiveState Ingestion started, not yet finished
+ * \value CanceledState Ingestion is finished due to cancellation or an error saving the contacts
+ * \value FinishedState Ingestion successfully completed
+ */
+
+/*!
+ * \fn QVersitContactIngester::stateChanged(QVersitContactIngester::State state)
+ * The signal is emitted by the ingester when its state has changed (eg. when it has finished
+ * saving the contacts).
+ * \a state is the new state of the ingester.
+ */
+
+/*!
+ * \fn QVersitContactIngester::progress(qint64 checkpoint, int savedCount)
+ * The signal is emitted from the ingesting thread each time a batch of contacts has been saved.
+ * \a checkpoint is the offset in the input past which no contact has been saved, and
+ * \a savedCount is the number of contacts saved since the ingestion was started.
+ */
+
+/*! Constructs a new ingester. */
+QVersitContactIngester::QVersitContactIngester() : d(new QVersitContactIngesterPrivate)
+{
+    d->init(this);
+}
+
+/*! Constructs a new ingester that reads from \a inputDevice and saves to \a manager. */
+QVersitContactIngester::QVersitContactIngester(QIODevice* inputDevice, QContactManager* manager)
+    : d(new QVersitContactIngesterPrivate)
+{
+    d->init(this);
+    d->mIoDevice = inputDevice;
+    d->mManager = manager;
+}
+
+/*!
+ * Frees the memory used by the ingester.
+ * Cancels and waits for any ingestion in progress.
+ */
+QVersitContactIngester::~QVersitContactIngester()
+{
+    d->setCanceling(true);
+    d->wait();
+    delete d;
+}
+
+/*!
+ * Sets the device used for reading the input to be the given \a inputDevice.
+ * Does not take ownership of the device.
+ *
+ * The caller must ensure that \a inputDevice remains valid for the lifetime of
+ * this QVersitContactIngester object.
+ */
+void QVersitContactIngester::setDevice(QIODevice* inputDevice)
+{
+    d->mIoDevice = inputDevice;
+}
+
+/*!
+ * Returns the device used for reading input, or 0 if no device has been set.
+ */
+QIODevice* QVersitContactIngester::device() const
+{
+    return d->mIoDevice;
+}
+
+/*!
+ * Sets the manager that the contacts are saved to be \a manager.
+ * Does not take ownership of the manager.
+ */
+void QVersitContactIngester::setManager(QContactManager* manager)
+{
+    d->mManager = manager;
+}
+
+/*!
+ * Returns the manager that the contacts are saved to, or 0 if no manager has been set.
+ */
+QContactManager* QVersitContactIngester::manager() const
+{
+    return d->mManager;
+}
+
+/*!
+ * Sets \a codec as the codec for the ingester to use when parsing the input stream.
+ * The codec is detected from the input as described in QVersitReader::setDefaultCodec()
+ * if none is set.
+ */
+void QVersitContactIngester::setDefaultCodec(QTextCodec *codec)
+{
+    d->mDefaultCodec = codec;
+}
+
+/*!
+ * Returns the codec the ingester uses when parsing the input stream.  If the codec is null, the
+ * ingester will attempt to detect the codec from the input.
+ */
+QTextCodec* QVersitContactIngester::defaultCodec() const
+{
+    return d->mDefaultCodec;
+}
+
+/*!
+ * Sets the \a profiles of the QVersitContactImporter used to import the documents.
+ *
+ * \sa QVersitContactImporter::QVersitContactImporter(const QStringList&)
+ */
+void QVersitContactIngester::setImportProfiles(const QStringList& profiles)
+{
+    d->mImportProfiles = profiles;
+}
+
+/*!
+ * Returns the profiles of the QVersitContactImporter used to import the documents.
+ */
+QStringList QVersitContactIngester::importProfiles() const
+{
+    return d->mImportProfiles;
+}
+
+/*!
+ * Sets the number of documents read, imported and saved at a time to \a documentCount.
+ * Larger batches make fewer calls to the manager, at the cost of more memory and of a checkpoint
+ * that advances less often.  The default is 100.
+ */
+void QVersitContactIngester::setBatchSize(int documentCount)
+{
+    d->mBatchSize = qMax(1, documentCount);
+}
+
+/*!
+ * Returns the number of documents read, imported and saved at a time.
+ */
+int QVersitContactIngester::batchSize() const
+{
+    return d->mBatchSize;
+}
+
+/*!
+ * Sets the number of batches that may be waiting between two stages of the pipeline to
+ * \a batchCount.  A stage that gets this far ahead of the next one waits for it to catch up.
+ * The default is 2.
+ */
+void QVersitContactIngester::setMaxQueuedBatches(int batchCount)
+{
+    d->mMaxQueuedBatches = qMax(1, batchCount);
+}
+
+/*!
+ * Returns the number of batches that may be waiting between two stages of the pipeline.
+ */
+int QVersitContactIngester::maxQueuedBatches() const
+{
+    return d->mMaxQueuedBatches;
+}
+
+/*!
+ * Sets the offset in the device at which the ingestion starts to \a offset.  This is typically
+ * the checkpoint() of an earlier ingestion of the same input which didn't finish.
+ */
+void QVersitContactIngester::setStartOffset(qint64 offset)
+{
+    d->mStartOffset = qMax(qint64(0), offset);
+}
+
+/*!
+ * Returns the offset in the device at which the ingestion starts.
+ */
+qint64 QVersitContactIngester::startOffset() const
+{
+    return d->mStartOffset;
+}
+
+/*!
+ * Returns the offset in the device up to which every contact has been saved.  Until the first
+ * batch is saved, this is the startOffset().  Once the ingestion has reached the FinishedState,
+ * this is the end of the input.
+ */
+qint64 QVersitContactIngester::checkpoint() const
+{
+    QMutexLocker locker(&d->mMutex);
+    return d->mCheckpoint;
+}
+
+/*!
+ * Returns the number of contacts saved since the ingestion was started.
+ */
+int QVersitContactIngester::savedCount() const
+{
+    QMutexLocker locker(&d->mMutex);
+    return d->mSavedCount;
+}
+
+/*!
+ * Returns the state of the ingester.
+ */
+QVersitContactIngester::State QVersitContactIngester::state() const
+{
+    return d->state();
+}
+
+/*!
+ * Returns the error encountered by the last operation.
+ */
+QVersitContactIngester::Error QVersitContactIngester::error() const
+{
+    return d->error();
+}
+
+/*!
+ * Starts reading the input asynchronously and saving its contacts to the manager.
+ * Returns false if the input device or the manager has not been set or is not usable, or if
+ * there is another ingestion in progress.
+ */
+bool QVersitContactIngester::start()
+{
+    if (d->state() == ActiveState || d->isRunning()) {
+        d->setError(NotReadyError);
+        return false;
+    } else if (!d->mIoDevice || !d->mIoDevice->isReadable()) {
+        d->setError(IOError);
+        return false;
+    } else if (!d->mManager) {
+        d->setError(UnspecifiedError);
+        return false;
+    } else {
+        d->mMutex.lock();
+        d->mCheckpoint = d->mStartOffset;
+        d->mSavedCount = 0;
+        d->mMutex.unlock();
+        d->setState(ActiveState);
+        d->setError(NoError);
+        d->setCanceling(false);
+        d->start();
+        return true;
+    }
+}
+
+/*!
+ * Attempts to asynchronously cancel the ingestion.  The batches which have already been saved
+ * stay in the manager, and checkpoint() tells where the input can be resumed from.
+ */
+void QVersitContactIngester::cancel()
+{
+    d->setCanceling(true);
+}
+
+/*!
+ * If the state is ActiveState, blocks until the ingester has finished or \a msec milliseconds
+ * has elapsed, returning true if it successfully finishes or is cancelled by the user.
+ * If \a msec is negative or zero, the function blocks until the ingester has finished, regardless
+ * of how long it takes.
+ * If the state is FinishedState, returns true immediately.
+ * Otherwise, returns false immediately.
+ */
+bool QVersitContactIngester::waitForFinished(int msec)
+{
+    State state = d->state();
+    if (state != InactiveState) {
+        if (msec <= 0)
+            return d->wait(ULONG_MAX);
+        else
+            return d->wait(msec);
+    } else {
+        return false;
+    }
+}
+
+QT_END_NAMESPACE_VERSIT
+
+#include "moc_qversitcontactingester.cpp"
@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtVersit module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QVERSITCONTACTINGESTER_H
+#define QVERSITCONTACTINGESTER_H
+
+#include <QtCore/qobject.h>
+#include <QtCore/qstringlist.h>
+
+#include <QtContacts/qcontactsglobal.h>
+
+#include <QtVersit/qversitglobal.h>
+
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QTextCodec)
+
+QT_BEGIN_NAMESPACE_CONTACTS
+class QContactManager;
+QT_END_NAMESPACE_CONTACTS
+
+QTCONTACTS_USE_NAMESPACE
+
+QT_BEGIN_NAMESPACE_VERSIT
+
+class QVersitContactIngesterPrivate;
+
+// reads, imports and saves the contacts of a vCard file in batches
+class Q_VERSIT_EXPORT QVersitContactIngester : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Error {
+        NoError = 0,
+        UnspecifiedError,
+        IOError,
+        NotReadyError,
+        ParseError,
+        ImportError,
+        SaveError
+    };
+
+    enum State {
+        InactiveState = 0,
+        ActiveState,
+        CanceledState,
+        FinishedState
+    };
+
+    QVersitContactIngester();
+    QVersitContactIngester(QIODevice* inputDevice, QContactManager* manager);
+    ~QVersitContactIngester();
+
+    void setDevice(QIODevice* inputDevice);
+    QIODevice* device() const;
+
+    void setManager(QContactManager* manager);
+    QContactManager* manager() const;
+
+    void setDefaultCodec(QTextCodec* codec);
+    QTextCodec* defaultCodec() const;
+
+    void setImportProfiles(const QStringList& profiles);
+    QStringList importProfiles() const;
+
+    void setBatchSize(int documentCount);
+    int batchSize() const;
+
+    void setMaxQueuedBatches(int batchCount);
+    int maxQueuedBatches() const;
+
+    void setStartOffset(qint64 offset);
+    qint64 startOffset() const;
+
+    qint64 checkpoint() const;
+    int savedCount() const;
+
+    State state() const;
+    Error error() const;
+
+    bool start();
+    void cancel();
+    bool waitForFinished(int msec = -1);
+
+Q_SIGNALS:
+    void stateChanged(QVersitContactIngester::State state);
+    void progress(qint64 checkpoint, int savedCount);
+
+private: // data
+    QVersitContactIngesterPrivate* d;
+};
+
+QT_END_NAMESPACE_VERSIT
+
+Q_DECLARE_METATYPE(QTVERSIT_PREPEND_NAMESPACE(QVersitContactIngester::State))
+
+#endif // QVERSITCONTACTINGESTER_H
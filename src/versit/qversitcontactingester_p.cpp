@@ -0,0 +1,325 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtVersit module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qversitcontactingester_p.h"
+
+#include <QtCore/qbuffer.h>
+#include <QtCore/qthreadpool.h>
+
+#include <QtContacts/qcontactmanager.h>
+
+#include <QTextCodec>
+
+#include "qversitcontactimporter.h"
+#include "qversitreader_p.h"
+
+QTCONTACTS_USE_NAMESPACE
+
+QT_BEGIN_NAMESPACE_VERSIT
+
+// The number of bytes read from the device at a time
+#define INGEST_CHUNK_SIZE 65536
+
+QVersitContactIngesterPrivate::QVersitContactIngesterPrivate()
+    : mIoDevice(0),
+    mManager(0),
+    mDefaultCodec(0),
+    mBatchSize(100),
+    mMaxQueuedBatches(2),
+    mStartOffset(0),
+    mCheckpoint(0),
+    mSavedCount(0),
+    mState(QVersitContactIngester::InactiveState),
+    mError(QVersitContactIngester::NoError),
+    mIsCanceling(false)
+{
+}
+
+QVersitContactIngesterPrivate::~QVersitContactIngesterPrivate()
+{
+}
+
+void QVersitContactIngesterPrivate::init(QVersitContactIngester* ingester)
+{
+    qRegisterMetaType<QVersitContactIngester::State>("QVersitContactIngester::State");
+    connect(this, SIGNAL(stateChanged(QVersitContactIngester::State)),
+            ingester, SIGNAL(stateChanged(QVersitContactIngester::State)), Qt::DirectConnection);
+    connect(this, SIGNAL(progress(qint64,int)),
+            ingester, SIGNAL(progress(qint64,int)), Qt::DirectConnection);
+}
+
+/*!
+ * Inherited from QThread, called by QThread when the thread has been started.
+ *
+ * Runs the three stages of the pipeline: the documents are read on this thread, while they are
+ * imported and saved on two more.  The stages are connected by queues of at most
+ * mMaxQueuedBatches batches each, so the pipeline goes at the speed of its slowest stage and only
+ * holds a few batches in memory.
+ */
+void QVersitContactIngesterPrivate::run()
+{
+    mMutex.lock();
+    const int maxQueuedBatches = mMaxQueuedBatches;
+    const QStringList profiles = mImportProfiles;
+    mMutex.unlock();
+
+    // Built here rather than racing in the stages
+    QVersitReaderPrivate::valueTypeMap();
+    QVersitContactImporter importer(profiles);
+
+    IngestQueue<IngestDocumentBatch> documents(maxQueuedBatches);
+    IngestQueue<IngestContactBatch> contacts(maxQueuedBatches);
+    bool saved = true;
+    QThreadPool pool;
+    pool.setMaxThreadCount(2);
+    pool.start([&]() { importDocuments(&importer, &documents, &contacts); });
+    pool.start([&]() { saved = saveContacts(&contacts); });
+    readDocuments(&documents);
+    pool.waitForDone();
+
+    if (!saved) {
+        // The other stages may have reported an error of their own while stopping
+        setError(QVersitContactIngester::SaveError);
+        setState(QVersitContactIngester::CanceledState);
+    } else if (isCanceling()) {
+        setState(QVersitContactIngester::CanceledState);
+    } else {
+        setState(QVersitContactIngester::FinishedState);
+    }
+}
+
+/*!
+ * The first stage of the pipeline: reads the device from mStartOffset and splits the input into
+ * batches of mBatchSize documents, each of which is parsed and passed to \a output with the offset
+ * at which it ends.
+ *
+ * The input is only split between top-level documents, which are found by looking for BEGIN and
+ * END lines.  A document that this scan doesn't delimit (eg. because of a mixed-case "End:") is
+ * merely kept in the same batch as the next one.
+ */
+void QVersitContactIngesterPrivate::readDocuments(IngestQueue<IngestDocumentBatch>* output)
+{
+    qint64 offset = mStartOffset; // The offset of pending in the input
+    if (offset > 0) {
+        bool skipped = mIoDevice->isSequential()
+                ? mIoDevice->skip(offset) == offset
+                : mIoDevice->seek(offset);
+        if (!skipped) {
+            setError(QVersitContactIngester::IOError);
+            output->close();
+            return;
+        }
+    }
+
+    QByteArray pending;
+    QTextCodec* batchCodec = 0; // The codec the batches are parsed with, or 0 to let each guess
+    QScopedPointer<DocumentBoundaryScanner> scanner;
+    QVersitReaderPrivate parser; // Parses every batch, sharing its string table between them
+    int documentCount = 0;
+    bool atEnd = false;
+    while (!atEnd && !isCanceling()) {
+        QByteArray chunk = mIoDevice->read(INGEST_CHUNK_SIZE);
+        if (chunk.isEmpty()) {
+            if (mIoDevice->atEnd() || !mIoDevice->waitForReadyRead(500))
+                atEnd = mIoDevice->atEnd() || !mIoDevice->isSequential();
+            if (!atEnd)
+                continue;
+        } else {
+            pending.append(chunk);
+        }
+
+        if (scanner.isNull()) {
+            // Sniff the codec once, as the first batch will.  If it is only a guess, let each
+            // batch guess it for itself, as it would have been guessed for the input as a whole.
+            if (pending.size() < 6 && !atEnd)
+                continue;
+            QBuffer sniffBuffer(&pending);
+            sniffBuffer.open(QIODevice::ReadOnly);
+            LineReader sniffer(&sniffBuffer, mDefaultCodec);
+            batchCodec = sniffer.isCodecCertain() ? sniffer.codec() : mDefaultCodec;
+            scanner.reset(new DocumentBoundaryScanner(sniffer.codec()));
+        }
+
+        // Scan the complete lines which have been read, counting the top-level documents
+        while (scanner->scanLine(pending, atEnd)) {
+            if (scanner->lineType() == DocumentBoundaryScanner::DocumentEnd)
+                documentCount++;
+            if (scanner->depth() == 0 && documentCount >= mBatchSize) {
+                const int batchEnd = scanner->nextLineStart();
+                offset += batchEnd;
+                if (!output->push(parseBatch(&parser, pending.left(batchEnd), batchCodec, offset))) {
+                    atEnd = true;
+                    break;
+                }
+                pending.remove(0, batchEnd);
+                scanner->discard(batchEnd);
+                documentCount = 0;
+            }
+        }
+    }
+
+    if (!isCanceling() && !pending.trimmed().isEmpty())
+        output->push(parseBatch(&parser, pending, batchCodec, offset + pending.size()));
+    output->close();
+}
+
+/*!
+ * Parses the documents in \a data with \a parser and \a codec (or a guessed codec if it is null),
+ * returning them as a batch that ends at \a endOffset.
+ */
+IngestDocumentBatch QVersitContactIngesterPrivate::parseBatch(
+        QVersitReaderPrivate* parser, const QByteArray& data, QTextCodec* codec, qint64 endOffset)
+{
+    IngestDocumentBatch batch;
+    batch.endOffset = endOffset;
+
+    QByteArray input(data);
+    QBuffer buffer(&input);
+    buffer.open(QIODevice::ReadOnly);
+    LineReader lineReader(&buffer, codec);
+    while (!lineReader.atEnd()) {
+        QVersitDocument document;
+        int oldPos = lineReader.odometer();
+        if (parser->parseVersitDocument(&lineReader, &document)) {
+            if (document.isEmpty())
+                break;
+            batch.documents.append(document);
+        } else {
+            setError(QVersitContactIngester::ParseError);
+            if (lineReader.odometer() == oldPos)
+                break;
+        }
+    }
+    return batch;
+}
+
+/*!
+ * The second stage of the pipeline: converts the batches of documents from \a input to contacts
+ * with \a importer and passes them to \a output.
+ */
+void QVersitContactIngesterPrivate::importDocuments(QVersitContactImporter* importer,
+                                                    IngestQueue<IngestDocumentBatch>* input,
+                                                    IngestQueue<IngestContactBatch>* output)
+{
+    IngestDocumentBatch documents;
+    while (input->pop(&documents) && !isCanceling()) {
+        IngestContactBatch contacts;
+        contacts.endOffset = documents.endOffset;
+        if (!documents.documents.isEmpty()) {
+            if (!importer->importDocuments(documents.documents))
+                setError(QVersitContactIngester::ImportError);
+            contacts.contacts = importer->contacts();
+        }
+        if (!output->push(contacts))
+            break;
+    }
+    // Unblock the first stage if this one stopped early
+    input->abort();
+    output->close();
+}
+
+/*!
+ * The last stage of the pipeline: saves the batches of contacts from \a input to the manager and
+ * advances the checkpoint past each batch that is saved.  The pipeline stops at the first batch
+ * that fails to save, so that the input can be resumed from the checkpoint.  Returns false if a
+ * batch failed to save.
+ */
+bool QVersitContactIngesterPrivate::saveContacts(IngestQueue<IngestContactBatch>* input)
+{
+    IngestContactBatch contacts;
+    while (input->pop(&contacts) && !isCanceling()) {
+        if (!contacts.contacts.isEmpty() && !mManager->saveContacts(&contacts.contacts)) {
+            setError(QVersitContactIngester::SaveError);
+            input->abort();
+            return false;
+        }
+        mMutex.lock();
+        mCheckpoint = contacts.endOffset;
+        mSavedCount += contacts.contacts.size();
+        const qint64 checkpoint = mCheckpoint;
+        const int savedCount = mSavedCount;
+        mMutex.unlock();
+        emit progress(checkpoint, savedCount);
+    }
+    input->abort();
+    return true;
+}
+
+void QVersitContactIngesterPrivate::setState(QVersitContactIngester::State state)
+{
+    mMutex.lock();
+    mState = state;
+    mMutex.unlock();
+    emit stateChanged(state);
+}
+
+QVersitContactIngester::State QVersitContactIngesterPrivate::state() const
+{
+    QMutexLocker locker(&mMutex);
+    return mState;
+}
+
+void QVersitContactIngesterPrivate::setError(QVersitContactIngester::Error error)
+{
+    QMutexLocker locker(&mMutex);
+    mError = error;
+}
+
+QVersitContactIngester::Error QVersitContactIngesterPrivate::error() const
+{
+    QMutexLocker locker(&mMutex);
+    return mError;
+}
+
+void QVersitContactIngesterPrivate::setCanceling(bool canceling)
+{
+    QMutexLocker locker(&mMutex);
+    mIsCanceling = canceling;
+}
+
+bool QVersitContactIngesterPrivate::isCanceling() const
+{
+    QMutexLocker locker(&mMutex);
+    return mIsCanceling;
+}
+
+QT_END_NAMESPACE_VERSIT
+
+#include "moc_qversitcontactingester_p.cpp"
@@ -0,0 +1,203 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtVersit module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QVERSITCONTACTINGESTER_P_H
+#define QVERSITCONTACTINGESTER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qiodevice.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qwaitcondition.h>
+
+#include <QtContacts/qcontact.h>
+
+#include <QtVersit/qversitcontactingester.h>
+#include <QtVersit/qversitdocument.h>
+
+QT_BEGIN_NAMESPACE_VERSIT
+
+class QVersitContactImporter;
+class QVersitReaderPrivate;
+
+/*
+ * A queue between two stages of the ingest pipeline.  push() blocks while the queue is full and
+ * pop() blocks while it is empty, so that a fast stage can't run ahead of a slow one by more than
+ * the capacity of the queue.
+ */
+template <class T>
+class IngestQueue
+{
+public:
+    explicit IngestQueue(int capacity) : mCapacity(qMax(1, capacity)), mClosed(false) {}
+
+    // Returns false if the queue has been closed
+    bool push(const T& item)
+    {
+        QMutexLocker locker(&mMutex);
+        while (mItems.size() >= mCapacity && !mClosed)
+            mNotFull.wait(&mMutex);
+        if (mClosed)
+            return false;
+        mItems.append(item);
+        mNotEmpty.wakeOne();
+        return true;
+    }
+
+    // Returns false once the queue is empty and no more items will be pushed
+    bool pop(T* item)
+    {
+        QMutexLocker locker(&mMutex);
+        while (mItems.isEmpty() && !mClosed)
+            mNotEmpty.wait(&mMutex);
+        if (mItems.isEmpty())
+            return false;
+        *item = mItems.takeFirst();
+        mNotFull.wakeOne();
+        return true;
+    }
+
+    // Marks the end of the input; the items already queued can still be popped
+    void close()
+    {
+        QMutexLocker locker(&mMutex);
+        mClosed = true;
+        mNotEmpty.wakeAll();
+        mNotFull.wakeAll();
+    }
+
+    // Closes the queue and discards the queued items
+    void abort()
+    {
+        QMutexLocker locker(&mMutex);
+        mClosed = true;
+        mItems.clear();
+        mNotEmpty.wakeAll();
+        mNotFull.wakeAll();
+    }
+
+private:
+    QList<T> mItems;
+    const int mCapacity;
+    bool mClosed;
+    QMutex mMutex;
+    QWaitCondition mNotEmpty;
+    QWaitCondition mNotFull;
+};
+
+// A batch of documents, and the offset in the input just past the last of them
+struct IngestDocumentBatch
+{
+    IngestDocumentBatch() : endOffset(0) {}
+    QList<QVersitDocument> documents;
+    qint64 endOffset;
+};
+
+struct IngestContactBatch
+{
+    IngestContactBatch() : endOffset(0) {}
+    QList<QContact> contacts;
+    qint64 endOffset;
+};
+
+class QVersitContactIngesterPrivate : public QThread
+{
+    Q_OBJECT
+
+public:
+    QVersitContactIngesterPrivate();
+    ~QVersitContactIngesterPrivate();
+
+    void init(QVersitContactIngester* ingester);
+
+    // mutexed getters and setters.
+    void setState(QVersitContactIngester::State state);
+    QVersitContactIngester::State state() const;
+    void setError(QVersitContactIngester::Error error);
+    QVersitContactIngester::Error error() const;
+    void setCanceling(bool canceling);
+    bool isCanceling() const;
+
+    void readDocuments(IngestQueue<IngestDocumentBatch>* output);
+    void importDocuments(QVersitContactImporter* importer,
+                         IngestQueue<IngestDocumentBatch>* input,
+                         IngestQueue<IngestContactBatch>* output);
+    bool saveContacts(IngestQueue<IngestContactBatch>* input);
+    IngestDocumentBatch parseBatch(QVersitReaderPrivate* parser, const QByteArray& data,
+                                   QTextCodec* codec, qint64 endOffset);
+
+signals:
+    void stateChanged(QVersitContactIngester::State state);
+    void progress(qint64 checkpoint, int savedCount);
+
+protected: // From QThread
+    void run() override;
+
+public: // data
+    QPointer<QIODevice> mIoDevice;
+    QContactManager* mManager;
+    QTextCodec* mDefaultCodec;
+    QStringList mImportProfiles;
+    int mBatchSize;
+    int mMaxQueuedBatches;
+    qint64 mStartOffset;
+    qint64 mCheckpoint; // All the documents before this offset have been saved
+    int mSavedCount;
+    QVersitContactIngester::State mState;
+    QVersitContactIngester::Error mError;
+    bool mIsCanceling;
+    mutable QMutex mMutex;
+};
+
+QT_END_NAMESPACE_VERSIT
+
+#endif // QVERSITCONTACTINGESTER_P_H
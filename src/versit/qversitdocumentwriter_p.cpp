@@ -49,6 +49,9 @@
 QT_BEGIN_NAMESPACE_VERSIT
 
 #define MAX_LINE_LENGTH 76
+// While a document is being encoded, output is collected and written to the device in chunks of
+// about this size, rather than with one write per fragment of a line
+#define VERSIT_WRITER_BUFFER_SIZE 16384
 
 /*!
   \class QVersitDocumentWriter
@@ -68,9 +71,13 @@ QVersitDocumentWriter::QVersitDocumentWriter(QVersitDocument::VersitType type)
     mDevice(0),
     mCodec(0),
     mCodecIsAscii(false),
+    mCodecIsAsciiCompatible(true),
+    mCodecIsUtf8(false),
+    mCodecIsLatin1(false),
     mEncoder(0),
     mSuccessful(true),
-    mCurrentLineLength(0)
+    mCurrentLineLength(0),
+    mBufferDepth(0)
 {
 }
 
@@ -87,10 +94,15 @@ void QVersitDocumentWriter::setCodec(QTextCodec *codec)
 {
     if (mEncoder)
         delete mEncoder;
+    mEncoder = 0;
     mCodec = codec;
-    mEncoder = codec->makeEncoder(mCodec->name() == QByteArrayLiteral("UTF-8")
-                ? QStringConverterBase::Flag::Default
-                : QStringConverterBase::Flag::WriteBom);
+
+    // UTF-8 and Latin-1 are encoded directly into the output buffer, without going through a
+    // QTextEncoder.  Neither has a byte order mark or any state between fragments.
+    mCodecIsUtf8 = mCodec->name() == QByteArrayLiteral("UTF-8");
+    mCodecIsLatin1 = mCodec->name() == QByteArrayLiteral("ISO-8859-1");
+    if (!mCodecIsUtf8 && !mCodecIsLatin1)
+        mEncoder = codec->makeEncoder(QStringConverterBase::Flag::WriteBom);
 
     // UTF-(16|32)(LE|BE) are the only codecs where characters in the base64 range aren't encoded
     // the same as in ASCII.  For ASCII compatible codecs, we can do some optimizations.
@@ -120,8 +132,26 @@ void QVersitDocumentWriter::setDevice(QIODevice *device)
  * encodeVersion is true.
  */
 bool QVersitDocumentWriter::encodeVersitDocument(const QVersitDocument& document, bool encodeVersion)
+{
+    mBufferDepth++;
+    encodeVersitDocumentStart(document, encodeVersion);
+    encodeVersitDocumentEnd(document);
+    mBufferDepth--;
+    written();
+
+    // This has been set by the methods called from this function
+    return mSuccessful;
+}
+
+/*!
+ * Writes the beginning of \a document to the device: the "BEGIN:" line, the "VERSION:" line iff \a
+ * encodeVersion is true, the properties and the subdocuments.  More subdocuments can be written
+ * with encodeVersitDocument() before the document is closed with encodeVersitDocumentEnd().
+ */
+bool QVersitDocumentWriter::encodeVersitDocumentStart(const QVersitDocument& document, bool encodeVersion)
 {
     mSuccessful = true;
+    mBufferDepth++;
 
     if (document.componentType().isEmpty()) {
         // for compatibility with code for Qt Mobility 1.0, which didn't have componentType
@@ -157,18 +187,32 @@ bool QVersitDocumentWriter::encodeVersitDocument(const QVersitDocument& document
         encodeVersitProperty(property);
     }
 
+    bool successful = mSuccessful;
     foreach (const QVersitDocument& document, document.subDocuments()) {
-        encodeVersitDocument(document, false);
+        successful = encodeVersitDocument(document, false) && successful;
     }
+    mSuccessful = successful;
 
+    mBufferDepth--;
+    written();
+    return mSuccessful;
+}
+
+/*!
+ * Writes the "END:" line of \a document to the device.
+ */
+bool QVersitDocumentWriter::encodeVersitDocumentEnd(const QVersitDocument& document)
+{
+    mBufferDepth++;
     if (document.componentType().isEmpty()) {
         writeString(QStringLiteral("END:VCARD"));
     } else {
         writeString(QStringLiteral("END:") + document.componentType());
     }
     writeCrlf();
+    mBufferDepth--;
+    written();
 
-    // This has been set by the methods called from this function
     return mSuccessful;
 }
 
@@ -177,12 +221,21 @@ bool QVersitDocumentWriter::encodeVersitDocument(const QVersitDocument& document
  */
 void QVersitDocumentWriter::encodeGroupsAndName(const QVersitProperty& property)
 {
-    QStringList groups = property.groups();
+    encodeGroupsAndName(property, property.name());
+}
+
+/*!
+ * Encodes the groups of the \a property and the \a name it is written with and writes them to the
+ * device
+ */
+void QVersitDocumentWriter::encodeGroupsAndName(const QVersitProperty& property, const QString& name)
+{
+    const QStringList groups = property.groups();
     if (!groups.isEmpty()) {
         writeString(groups.join(QStringLiteral(".")));
         writeString(QStringLiteral("."));
     }
-    writeString(property.name());
+    writeString(name);
 }
 
 /*!
@@ -197,17 +250,16 @@ void QVersitDocumentWriter::writeBytes(const QByteArray &value)
     int charsWritten = 0;
     while (spaceRemaining < value.length() - charsWritten) {
         // Write the first "spaceRemaining" characters
-        if (mDevice->write(value.constData() + charsWritten, spaceRemaining) < 0
-               || mDevice->write("\r\n ") < 0)
-            mSuccessful = false;
+        mBuffer.append(value.constData() + charsWritten, spaceRemaining);
+        mBuffer.append("\r\n ", 3);
         charsWritten += spaceRemaining;
         spaceRemaining = MAX_LINE_LENGTH - 1; // minus 1 for the space at the front.
         mCurrentLineLength = 1;
     }
 
-    if (mDevice->write(value.constData() + charsWritten) < 0)
-        mSuccessful = false;
+    mBuffer.append(value.constData() + charsWritten, value.length() - charsWritten);
     mCurrentLineLength += value.length() - charsWritten;
+    written();
 }
 
 /*!
@@ -218,25 +270,26 @@ void QVersitDocumentWriter::writeBytes(const QByteArray &value)
   */
 void QVersitDocumentWriter::writeString(const QString &value)
 {
+    static const QString crlfSpace(QStringLiteral("\r\n "));
     int spaceRemaining = MAX_LINE_LENGTH - mCurrentLineLength;
     int charsWritten = 0;
-    QString crlfSpace(QStringLiteral("\r\n "));
     while (spaceRemaining < value.length() - charsWritten) {
-        // Write the first "spaceRemaining" characters
-        QStringView line(value.constData() + charsWritten, spaceRemaining);
-        charsWritten += spaceRemaining;
-        const QByteArray encodedLine = mEncoder->fromUnicode(line.constData(), line.length());
-        const QByteArray encodedCrlfSpace = mEncoder->fromUnicode(crlfSpace);
-        if (mDevice->write(encodedLine) < 0 || mDevice->write(encodedCrlfSpace) < 0)
-            mSuccessful = false;
+        // Write the first "spaceRemaining" characters.  A surrogate pair isn't split in UTF-8, as
+        // it is encoded as a single sequence (the stateful encoder for other codecs handles this).
+        int lineLength = spaceRemaining;
+        if (mCodecIsUtf8 && lineLength > 1
+                && value.at(charsWritten + lineLength - 1).isHighSurrogate())
+            lineLength--;
+        appendEncoded(value.constData() + charsWritten, lineLength);
+        appendEncoded(crlfSpace.constData(), crlfSpace.length());
+        charsWritten += lineLength;
         spaceRemaining = MAX_LINE_LENGTH - 1; // minus 1 for the space at the front.
         mCurrentLineLength = 1;
     }
 
-    const QByteArray encodedRemainder = mEncoder->fromUnicode(value.mid(charsWritten));
-    if (mDevice->write(encodedRemainder) < 0)
-        mSuccessful = false;
+    appendEncoded(value.constData() + charsWritten, value.length() - charsWritten);
     mCurrentLineLength += value.length() - charsWritten;
+    written();
 }
 
 /*!
@@ -247,10 +300,10 @@ void QVersitDocumentWriter::writeString(const QString &value)
   */
 void QVersitDocumentWriter::writeStringQp(const QString &value)
 {
+    static const QString softBreak(QStringLiteral("=\r\n"));
     int spaceRemaining = MAX_LINE_LENGTH - mCurrentLineLength - 1;
                                              // minus 1 for the equals required at the end
     int charsWritten = 0;
-    QString softBreak(QStringLiteral("=\r\n"));
     while (spaceRemaining < value.length() - charsWritten) {
         // Write the first "spaceRemaining" characters
         if (value[charsWritten + spaceRemaining - 2] == QLatin1Char('=')) {
@@ -258,19 +311,16 @@ void QVersitDocumentWriter::writeStringQp(const QString &value)
         } else if (value[charsWritten + spaceRemaining - 1] == QLatin1Char('=')) {
             spaceRemaining -= 1;
         }
-        QStringView line(value.constData() + charsWritten, spaceRemaining);
-
+        appendEncoded(value.constData() + charsWritten, spaceRemaining);
+        appendEncoded(softBreak.constData(), softBreak.length());
         charsWritten += spaceRemaining;
-        if (mDevice->write(mEncoder->fromUnicode(line.constData(), line.length())) < 0
-               || mDevice->write(mEncoder->fromUnicode(softBreak)) < 0)
-            mSuccessful = false;
         spaceRemaining = MAX_LINE_LENGTH - 1; // minus 1 for the equals required at the end
         mCurrentLineLength = 0;
     }
 
-    if (mDevice->write(mEncoder->fromUnicode(value.mid(charsWritten))) < 0)
-        mSuccessful = false;
+    appendEncoded(value.constData() + charsWritten, value.length() - charsWritten);
     mCurrentLineLength += value.length() - charsWritten;
+    written();
 }
 
 /*!
@@ -283,4 +333,77 @@ void QVersitDocumentWriter::writeCrlf()
     mCurrentLineLength = 0;
 }
 
+/*!
+  Returns true if the codec can encode all of \a value.  This avoids the round trip through
+  QTextCodec::canEncode() for the codecs with a fast path.
+  */
+bool QVersitDocumentWriter::canEncode(const QString& value) const
+{
+    if (mCodecIsLatin1) {
+        for (const QChar& c : value) {
+            if (c.unicode() > 0xFF)
+                return false;
+        }
+        return true;
+    } else if (mCodecIsUtf8) {
+        // Everything but unpaired surrogates can be encoded
+        for (const QChar& c : value) {
+            if (c.isSurrogate())
+                return mCodec->canEncode(value);
+        }
+        return true;
+    }
+    return mCodec->canEncode(value);
+}
+
+/*!
+  Writes any buffered output to the device.
+  */
+void QVersitDocumentWriter::flush()
+{
+    if (mBuffer.isEmpty())
+        return;
+    if (mDevice->write(mBuffer) != mBuffer.size())
+        mSuccessful = false;
+    mBuffer.resize(0); // keeps the capacity for the next chunk
+}
+
+/*!
+  Encodes the \a length characters at \a data with the codec and appends them to the output
+  buffer.  ASCII characters are appended directly for the UTF-8 and Latin-1 codecs.
+  */
+void QVersitDocumentWriter::appendEncoded(const QChar* data, int length)
+{
+    if (length <= 0)
+        return;
+    if (mEncoder) {
+        mBuffer.append(mEncoder->fromUnicode(data, length));
+        return;
+    }
+
+    int i = 0;
+    while (i < length && data[i].unicode() < 0x80)
+        i++;
+    const qsizetype oldSize = mBuffer.size();
+    mBuffer.resize(oldSize + i);
+    char* out = mBuffer.data() + oldSize;
+    for (int j = 0; j < i; j++)
+        out[j] = char(data[j].unicode());
+    if (i < length) {
+        QStringView rest(data + i, length - i);
+        mBuffer.append(mCodecIsUtf8 ? rest.toUtf8() : rest.toLatin1());
+    }
+}
+
+/*!
+  Called after output has been appended to the buffer.  Outside of a document (eg. when a single
+  property is encoded), the output goes straight to the device; inside one, it is written once
+  enough has accumulated.
+  */
+void QVersitDocumentWriter::written()
+{
+    if (mBufferDepth == 0 || mBuffer.size() >= VERSIT_WRITER_BUFFER_SIZE)
+        flush();
+}
+
 QT_END_NAMESPACE_VERSIT
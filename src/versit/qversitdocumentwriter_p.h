@@ -51,12 +51,12 @@
 // We mean it.
 //
 
+#include <QtCore/qbytearray.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qstringlist.h>
 
 #include <QtVersit/qversitdocument.h>
 
-QT_FORWARD_DECLARE_CLASS(QByteArray)
 QT_FORWARD_DECLARE_CLASS(QIODevice)
 QT_FORWARD_DECLARE_CLASS(QTextCodec)
 QT_FORWARD_DECLARE_CLASS(QTextEncoder)
@@ -78,22 +78,34 @@ public:
     virtual void encodeVersitProperty(const QVersitProperty& property) = 0;
     virtual void encodeParameters(const QMultiHash<QString,QString>& parameters) = 0;
     bool encodeVersitDocument(const QVersitDocument& document, bool encodeVersion = true);
+    bool encodeVersitDocumentStart(const QVersitDocument& document, bool encodeVersion = true);
+    bool encodeVersitDocumentEnd(const QVersitDocument& document);
     void encodeGroupsAndName(const QVersitProperty& property);
+    void encodeGroupsAndName(const QVersitProperty& property, const QString& name);
 
     void writeBytes(const QByteArray& value);
     void writeString(const QString& value);
     void writeStringQp(const QString& value);
     void writeCrlf();
+    bool canEncode(const QString& value) const;
+    void flush();
 
 protected:
+    void appendEncoded(const QChar* data, int length);
+    void written();
+
     QVersitDocument::VersitType mType;
     QIODevice* mDevice;
     QTextCodec* mCodec;
     bool mCodecIsAscii;
     bool mCodecIsAsciiCompatible;
-    QTextEncoder* mEncoder;
+    bool mCodecIsUtf8;
+    bool mCodecIsLatin1;
+    QTextEncoder* mEncoder; // Only created for codecs without a fast path
     bool mSuccessful;
     int mCurrentLineLength;
+    QByteArray mBuffer; // Encoded output not yet written to the device
+    int mBufferDepth; // Nesting depth of the documents being encoded into mBuffer
 };
 
 QT_END_NAMESPACE_VERSIT
@@ -61,6 +61,11 @@ QT_BEGIN_NAMESPACE_VERSIT
   waitForFinished() function can be used to make a blocking
   read.
 
+  Large inputs can be consumed incrementally: connect to resultsAvailable() and
+  call takeResults() to hand the parsed documents over as they are produced.
+  With setResultsLimit(), the reading thread pauses once that many documents are
+  waiting to be taken, which bounds the memory used by the reader.
+
   \sa QVersitDocument
  */
 
@@ -126,6 +131,8 @@ QVersitReader::QVersitReader(const QByteArray &inputData) : d(new QVersitReaderP
  */
 QVersitReader::~QVersitReader()
 {
+    if (d->isRunning() && resultsLimit() > 0)
+        d->setCanceling(true); // Nobody is left to take the results
     d->wait();
     delete d;
 }
@@ -194,6 +201,62 @@ QTextCodec* QVersitReader::defaultCodec() const
     return d->mDefaultCodec;
 }
 
+/*!
+ * Sets the maximum number of threads used to parse documents to \a count.  The default of 1
+ * parses the documents one after another on the reader's own thread.
+ *
+ * With a larger \a count, the reader first reads the whole input into memory, splits it between
+ * top-level documents and parses the pieces concurrently on a pool of up to \a count threads.
+ * resultsAvailable() is still emitted as documents become available.  This scales the reading of
+ * large address books with the number of cores, at the cost of holding the input in memory.
+ * Values smaller than 1 are treated as 1.
+ *
+ * \sa maxThreadCount(), setResultsOrdered()
+ */
+void QVersitReader::setMaxThreadCount(int count)
+{
+    QMutexLocker locker(&d->mMutex);
+    d->mMaxThreadCount = qMax(1, count);
+}
+
+/*!
+ * Returns the maximum number of threads used to parse documents.
+ *
+ * \sa setMaxThreadCount()
+ */
+int QVersitReader::maxThreadCount() const
+{
+    QMutexLocker locker(&d->mMutex);
+    return d->mMaxThreadCount;
+}
+
+/*!
+ * Sets whether documents parsed concurrently are made available in the order in which they appear
+ * in the input to \a ordered.  This is true by default.  If false, batches of documents are made
+ * available as soon as they have been parsed, which keeps all threads busy when some parts of the
+ * input are slower to parse than others.  The documents within a batch always keep their order.
+ *
+ * This has no effect unless maxThreadCount() is greater than 1.
+ *
+ * \sa resultsOrdered(), setMaxThreadCount()
+ */
+void QVersitReader::setResultsOrdered(bool ordered)
+{
+    QMutexLocker locker(&d->mMutex);
+    d->mResultsOrdered = ordered;
+}
+
+/*!
+ * Returns whether documents parsed concurrently are made available in input order.
+ *
+ * \sa setResultsOrdered()
+ */
+bool QVersitReader::resultsOrdered() const
+{
+    QMutexLocker locker(&d->mMutex);
+    return d->mResultsOrdered;
+}
+
 /*!
  * Returns the state of the reader.
  */
@@ -276,6 +339,54 @@ QList<QVersitDocument> QVersitReader::results() const
     return d->mVersitDocuments;
 }
 
+/*!
+ * Returns the documents read since the reading was started or since the last call to
+ * takeResults(), and removes them from the reader.  The documents are returned in the order
+ * they appear in the input.
+ *
+ * If the reader is paused because the limit set with setResultsLimit() has been reached, taking
+ * the results lets it continue reading.
+ *
+ * \sa results(), setResultsLimit()
+ */
+QList<QVersitDocument> QVersitReader::takeResults()
+{
+    QList<QVersitDocument> documents;
+    QMutexLocker locker(&d->mMutex);
+    documents.swap(d->mVersitDocuments);
+    d->mResultsTaken.wakeAll();
+    return documents;
+}
+
+/*!
+ * Sets the maximum number of documents the reader holds before it waits for them to be taken
+ * with takeResults() to \a limit.  A \a limit of zero, the default, means that the reader never
+ * waits and accumulates all of the documents.
+ *
+ * While the limit is reached the reading thread is paused, so waitForFinished() only returns
+ * once the remaining results have been taken from another thread or the reading is canceled.
+ *
+ * \sa resultsLimit(), takeResults()
+ */
+void QVersitReader::setResultsLimit(int limit)
+{
+    QMutexLocker locker(&d->mMutex);
+    d->mResultsLimit = qMax(0, limit);
+    d->mResultsTaken.wakeAll();
+}
+
+/*!
+ * Returns the maximum number of documents the reader holds before it waits for them to be
+ * taken, or zero if the number is unlimited.
+ *
+ * \sa setResultsLimit()
+ */
+int QVersitReader::resultsLimit() const
+{
+    QMutexLocker locker(&d->mMutex);
+    return d->mResultsLimit;
+}
+
 QT_END_NAMESPACE_VERSIT
 
 #include "moc_qversitreader.cpp"
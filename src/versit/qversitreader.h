@@ -87,8 +87,16 @@ public:
     void setDefaultCodec(QTextCodec* codec);
     QTextCodec* defaultCodec() const;
 
+    void setMaxThreadCount(int count);
+    int maxThreadCount() const;
+    void setResultsOrdered(bool ordered);
+    bool resultsOrdered() const;
+
     // output:
     QList<QVersitDocument> results() const;
+    QList<QVersitDocument> takeResults();
+    void setResultsLimit(int limit);
+    int resultsLimit() const;
 
     State state() const;
     Error error() const;
@@ -41,6 +41,7 @@
 
 #include <QtCore/qregularexpression.h>
 #include <QtCore/qbuffer.h>
+#include <QtCore/qthreadpool.h>
 #include <QtCore/qvariant.h>
 
 #include <QTextCodec>
@@ -52,6 +53,9 @@ QT_BEGIN_NAMESPACE_VERSIT
 // Some big enough value for nested versit documents to prevent infinite recursion
 #define MAX_VERSIT_DOCUMENT_NESTING_DEPTH 20
 
+// Rough number of bytes of input handed to one task when documents are parsed concurrently
+#define VERSIT_SHARD_SIZE 65536
+
 QHash<QPair<QVersitDocument::VersitType,QString>, QVersitProperty::ValueType>*
     QVersitReaderPrivate::mValueTypeMap = 0;
 
@@ -118,6 +122,8 @@ LineReader::LineReader(QIODevice* device, QTextCodec *codec)
     } else {
         mIsCodecCertain = true;
     }
+    initDelimiters();
+    normalizeNewlines(&mBuffer.mData, 0);
 }
 
 /*!
@@ -134,6 +140,80 @@ LineReader::LineReader(QIODevice* device, QTextCodec *codec, int chunkSize)
     mSearchFrom(0)
 {
     Q_ASSERT(mCodec != NULL);
+    initDelimiters();
+}
+
+/*!
+  Encodes the delimiters the reader searches for with the reader's codec.
+  */
+void LineReader::initDelimiters()
+{
+    mCr = VersitUtils::encode('\r', mCodec);
+    mLf = VersitUtils::encode('\n', mCodec);
+    mCrLf = VersitUtils::encode("\r\n", mCodec);
+    mTab = VersitUtils::encode('\t', mCodec);
+    mSpace = VersitUtils::encode(' ', mCodec);
+    mColon = VersitUtils::encode(':', mCodec);
+    mEquals = VersitUtils::encode('=', mCodec);
+    mEndVCard = VersitUtils::encode(QByteArray("END:VCARD"), mCodec);
+    mEndVCardLf = VersitUtils::encode(QByteArray("END:VCARD\n"), mCodec);
+    mEndVCardBeginVCard = VersitUtils::encode(QByteArray("END:VCARDBEGIN:VCARD"), mCodec);
+}
+
+/*!
+  Converts the \r\n and \r newline sequences in \a data to \n, starting at \a from.  This is
+  done in place in a single pass so that only the newly read bytes need to be visited.  A \r at
+  the very end of \a data is left alone because it could be followed by a \n on the next read.
+  */
+void LineReader::normalizeNewlines(QByteArray* data, int from) const
+{
+    const int crLength = mCr.length();
+    const int lfLength = mLf.length();
+    const int crLfLength = mCrLf.length();
+    const int size = data->size();
+    if (from >= size || data->indexOf(mCr, from) < 0)
+        return;
+
+    char* bytes = data->data();
+    int read = from;
+    int write = from;
+    while (read < size) {
+        if (size - read >= crLfLength && memcmp(bytes + read, mCrLf.constData(), crLfLength) == 0) {
+            memmove(bytes + write, mLf.constData(), lfLength);
+            read += crLfLength;
+            write += lfLength;
+        } else if (size - read > crLength && memcmp(bytes + read, mCr.constData(), crLength) == 0) {
+            memmove(bytes + write, mLf.constData(), lfLength);
+            read += crLength;
+            write += lfLength;
+        } else {
+            bytes[write++] = bytes[read++];
+        }
+    }
+    data->truncate(write);
+}
+
+/*!
+  Removes the folds recorded in mFolds from the line ending at \a lineEnd in \a data, moving each
+  piece of the line only once, and returns the new end of the line.
+  */
+int LineReader::removeFolds(QByteArray* data, int lineEnd)
+{
+    if (mFolds.isEmpty())
+        return lineEnd;
+
+    const int foldLength = mLf.length() + mSpace.length();
+    char* bytes = data->data();
+    int write = mFolds.first();
+    for (int i = 0; i < mFolds.size(); ++i) {
+        int read = mFolds.at(i) + foldLength;
+        int next = i + 1 < mFolds.size() ? mFolds.at(i + 1) : lineEnd;
+        memmove(bytes + write, bytes + read, next - read);
+        write += next - read;
+    }
+    data->remove(write, lineEnd - write);
+    mFolds.clear();
+    return write;
 }
 
 /*!
@@ -155,8 +235,6 @@ LineReader::LineReader(QIODevice* device, QTextCodec *codec, int chunkSize)
   */
 LByteArray LineReader::readLine()
 {
-    QByteArray colon(VersitUtils::encode(':', mCodec));
-    QByteArray equals(VersitUtils::encode('=', mCodec));
     if (!mPushedLines.isEmpty()) {
         LByteArray retval(mPushedLines.pop());
         return retval;
@@ -173,8 +251,8 @@ LByteArray LineReader::readLine()
         // LByteArray copies the QByteArray, which is implicitly shared
         LByteArray prevLine(mBuffer.mData, prevStart, prevEnd);
         if (mBuffer.isEmpty()
-                || mBuffer.contains(colon)
-                || prevLine.endsWith(equals)) {
+                || mBuffer.contains(mColon)
+                || prevLine.endsWith(mEquals)) {
             // Normal, the next line is empty, or a new property, or it's been wrapped using
             // QUOTED-PRINTABLE.  Rewind it back one line so it gets read next time round.
             mBuffer.setBounds(prevStart, prevEnd);
@@ -199,12 +277,9 @@ LByteArray LineReader::readLine()
   continuation of the next line)
   */
 void LineReader::readOneLine(LByteArray* cursor) {
-    QByteArray cr(VersitUtils::encode('\r', mCodec));
-    QByteArray lf(VersitUtils::encode('\n', mCodec));
-    QByteArray crlf(VersitUtils::encode("\r\n", mCodec));
-
     cursor->mStart = cursor->mEnd;
     mSearchFrom = cursor->mStart;
+    mFolds.clear();
 
     // First, look for a newline in the already-existing buffer.  If found, return the line.
     if (tryReadLine(cursor, false)) {
@@ -215,21 +290,14 @@ void LineReader::readOneLine(LByteArray* cursor) {
     while (!mDevice->atEnd()) {
         QByteArray temp = mDevice->read(mChunkSize);
         if (!temp.isEmpty()) {
+            // Everything before the last few bytes has already been sanitised.  Back up far enough
+            // to catch a \r\n (or a trailing \r) that straddles the previous read.
+            int from = qMax(0, cursor->mData.size() - (mCrLf.length() - 1));
             cursor->mData.append(temp);
 
             // Sanitise CRLF before proceeding to handle mixed line endings.
             // Convert the other two possible newline representations to '\n'.
-            cursor->mData.replace(crlf, lf);
-            if (cursor->mData.endsWith(cr)) {
-                // Corner case: line ends with \r - could also be \r\n after the
-                // next read, so do not replace the last occurrence (yet)
-                // So restore it for now.
-                cursor->mData.replace(cr, lf);
-                cursor->mData.truncate(cursor->mData.length() - lf.length());
-                cursor->mData.append(cr);
-            } else {
-                cursor->mData.replace(cr, lf);
-            }
+            normalizeNewlines(&cursor->mData, from);
 
             if (tryReadLine(cursor, false))
                 return;
@@ -241,8 +309,8 @@ void LineReader::readOneLine(LByteArray* cursor) {
 
     // We've reached the end of the stream.  Find a newline from the buffer (or return what's left).
     // But first, strip the last occurrence of \r - if present - left from before.
-    if (cursor->mData.endsWith(cr))
-        cursor->mData.truncate(cursor->mData.length() - cr.length());
+    if (cursor->mData.endsWith(mCr))
+        cursor->mData.truncate(cursor->mData.length() - mCr.length());
 
     tryReadLine(cursor, true);
 
@@ -317,41 +385,37 @@ void LineReader::setCodecUtf8Incompatible() {
 bool LineReader::tryReadLine(LByteArray *cursor, bool atEnd)
 {
     int nlPos = -1;
-    int doubleNlCheck = -1;
 
-    QByteArray nl(VersitUtils::encode('\n', mCodec));
-    QByteArray tab(VersitUtils::encode('\t', mCodec));
-    QByteArray space(VersitUtils::encode(' ', mCodec));
-    QByteArray equals(VersitUtils::encode('=', mCodec));
-
-    int nlLength = nl.length();
-    int spaceLength = space.length();
-    int equalsLength = equals.length();
+    const int nlLength = mLf.length();
+    const int spaceLength = mSpace.length();
+    const int equalsLength = mEquals.length();
 
     forever {
-        nlPos = cursor->mData.indexOf(nl, mSearchFrom);
-        doubleNlCheck = cursor->mData.indexOf(nl, mSearchFrom + nlLength);
-        if ((nlPos == cursor->mStart) && (doubleNlCheck != nlPos + nlLength)) {
+        nlPos = cursor->mData.indexOf(mLf, mSearchFrom);
+        if ((nlPos == cursor->mStart)
+                && !QVersitReaderPrivate::containsAt(cursor->mData, mLf, nlPos + nlLength)) {
             // Single newline at start of line - ignore and set mStart to directly after it.
             cursor->mStart += nlLength;
             mSearchFrom = cursor->mStart;
             continue;
-        } else if ((nlPos == cursor->mStart) && (doubleNlCheck == nlPos + nlLength)) {
+        } else if (nlPos == cursor->mStart) {
             // Found '=NLNL' - we choose to see this as badly formed,
             // but clearly marks the end of the versit property.
             cursor->mData.remove(nlPos, nlLength);
             cursor->mEnd = nlPos;
-            if (QVersitReaderPrivate::containsAt(cursor->mData, equals, nlPos - equalsLength) ) {
+            if (QVersitReaderPrivate::containsAt(cursor->mData, mEquals, nlPos - equalsLength) ) {
                 cursor->mData.remove(nlPos - 1, 1);
             }
             return true;
         } else if (nlPos > cursor->mStart) {
             // Found the first occurrence of newline in the current buffer.
-            if (QVersitReaderPrivate::containsAt(cursor->mData, space, nlPos + nlLength)
-                || QVersitReaderPrivate::containsAt(cursor->mData, tab, nlPos + nlLength)) {
-                // If it's followed by whitespace, collapse it.
-                cursor->mData.remove(nlPos, nlLength + spaceLength);
-                mSearchFrom = nlPos;
+            if (QVersitReaderPrivate::containsAt(cursor->mData, mSpace, nlPos + nlLength)
+                || QVersitReaderPrivate::containsAt(cursor->mData, mTab, nlPos + nlLength)) {
+                // If it's followed by whitespace, collapse it.  The fold is only recorded here and
+                // removed with the others once the end of the line is known, so that the rest of
+                // the buffer isn't shifted for every fold.
+                mFolds.append(nlPos);
+                mSearchFrom = nlPos + nlLength + spaceLength;
                 continue;
             } else if (!atEnd && nlPos + nlLength + spaceLength >= cursor->mData.size()) {
                 // If our newline is at the end of the current buffer but there's more to read,
@@ -361,30 +425,22 @@ bool LineReader::tryReadLine(LByteArray *cursor, bool atEnd)
                 return false;
             } else {
                 // Found the newline.
+                int lineEnd = removeFolds(&cursor->mData, nlPos);
+
                 // Hack: if malformed vCard files (having no NL or NLNL ending) are
                 // concatenated, we can get a malformed line in the document which looks like:
                 // END:VCARDBEGIN:VCARD
                 // In that situation, we should actually insert the newline sequence manually,
                 // and return mEnd after the END:VCARD + NL position.
-                QByteArray ev(VersitUtils::encode(QByteArray("END:VCARD"), mCodec));
-                QByteArray evbv(VersitUtils::encode(QByteArray("END:VCARDBEGIN:VCARD"), mCodec));
-                QByteArray evnl(VersitUtils::encode(QByteArray("END:VCARD\n"), mCodec));
-
-                QByteArray possiblyMalformedLine = cursor->mData.mid(cursor->mStart, nlPos-cursor->mStart);
-                int pmlEnd = possiblyMalformedLine.size() - 1;
-                while (true) {
-                    if (QVersitReaderPrivate::containsAt(possiblyMalformedLine, nl, pmlEnd - nlLength))
-                        possiblyMalformedLine.chop(nlLength);
-                    else
-                        break;
-                }
-                if (possiblyMalformedLine == evbv) {
+                if (lineEnd - cursor->mStart == mEndVCardBeginVCard.length()
+                        && QVersitReaderPrivate::containsAt(cursor->mData, mEndVCardBeginVCard,
+                                                            cursor->mStart)) {
                     // fix up the malformed line, return the end cursor after it.
-                    cursor->mData.replace(cursor->mStart, ev.length(), evnl);
-                    cursor->mEnd = cursor->mStart + evnl.length();
+                    cursor->mData.replace(cursor->mStart, mEndVCard.length(), mEndVCardLf);
+                    cursor->mEnd = cursor->mStart + mEndVCardLf.length();
                 } else {
                     // A well-formed line.
-                    cursor->mEnd = nlPos;
+                    cursor->mEnd = lineEnd;
                 }
 
                 return true;
@@ -392,6 +448,11 @@ bool LineReader::tryReadLine(LByteArray *cursor, bool atEnd)
         }
         if (nlPos == -1) {
             // No newline found.
+            if (atEnd) {
+                // The rest of the input is the last line.
+                cursor->mEnd = removeFolds(&cursor->mData, cursor->mData.size());
+                return false;
+            }
             cursor->mEnd = cursor->mData.size();
             // Next time, continue searching from here.
             // The largest newline will have a size of 4 bytes, so we should backtrack 4 bytes
@@ -418,7 +479,10 @@ QVersitReaderPrivate::QVersitReaderPrivate()
     mDefaultCodec(0),
     mState(QVersitReader::InactiveState),
     mError(QVersitReader::NoError),
-    mIsCanceling(false)
+    mIsCanceling(false),
+    mResultsLimit(0),
+    mMaxThreadCount(1),
+    mResultsOrdered(true)
 {
 }
 
@@ -547,41 +611,313 @@ void QVersitReaderPrivate::run()
  */
 void QVersitReaderPrivate::read()
 {
+    // Each read is a session of its own for the interned strings
+    mStringTable.clear();
+    mCharsetCodecs.clear();
+
     mMutex.lock();
     mVersitDocuments.clear();
+    const int threadCount = mMaxThreadCount;
+    const bool ordered = mResultsOrdered;
     mMutex.unlock();
     bool canceled = false;
 
-    LineReader lineReader(mIoDevice, mDefaultCodec);
-    while(!lineReader.atEnd()) {
-        if (isCanceling()) {
-            canceled = true;
-            break;
-        }
-        QVersitDocument document;
-        int oldPos = lineReader.odometer();
-        bool ok = parseVersitDocument(&lineReader, &document);
-
-        if (ok) {
-            if (document.isEmpty())
+    if (threadCount > 1) {
+        canceled = !readConcurrently(threadCount, ordered);
+    } else {
+        LineReader lineReader(mIoDevice, mDefaultCodec);
+        while(!lineReader.atEnd()) {
+            if (isCanceling()) {
+                canceled = true;
                 break;
-            else {
-                QMutexLocker locker(&mMutex);
-                mVersitDocuments.append(document);
-                emit resultsAvailable();
             }
-        } else {
-            setError(QVersitReader::ParseError);
-            if (lineReader.odometer() == oldPos)
-                break;
-        }
-    };
+            QVersitDocument document;
+            int oldPos = lineReader.odometer();
+            bool ok = parseVersitDocument(&lineReader, &document);
+
+            if (ok) {
+                if (document.isEmpty())
+                    break;
+                else if (!addDocument(document)) {
+                    canceled = true;
+                    break;
+                }
+            } else {
+                setError(QVersitReader::ParseError);
+                if (lineReader.odometer() == oldPos)
+                    break;
+            }
+        };
+    }
     if (canceled)
         setState(QVersitReader::CanceledState);
     else
         setState(QVersitReader::FinishedState);
 }
 
+/*!
+ * Makes \a document available to the client, first waiting for results to be taken if the
+ * results limit has been reached.  Returns false if the reading was canceled instead.
+ */
+bool QVersitReaderPrivate::addDocument(const QVersitDocument& document)
+{
+    QMutexLocker locker(&mMutex);
+    // Apply backpressure: wait for the client to take results
+    // before parsing beyond the high-water mark.
+    while (mResultsLimit > 0 && mVersitDocuments.size() >= mResultsLimit && !mIsCanceling)
+        mResultsTaken.wait(&mMutex);
+    if (mIsCanceling)
+        return false;
+    mVersitDocuments.append(document);
+    locker.unlock();
+    emit resultsAvailable();
+    return true;
+}
+
+/*!
+ * Constructs a scanner for input encoded with \a codec.
+ */
+DocumentBoundaryScanner::DocumentBoundaryScanner(QTextCodec* codec)
+    : mCr(VersitUtils::encode('\r', codec)),
+      mLf(VersitUtils::encode('\n', codec)),
+      mBegin(VersitUtils::encode(QByteArray("BEGIN:"), codec)),
+      mEnd(VersitUtils::encode(QByteArray("END:"), codec)),
+      mLowerBegin(VersitUtils::encode(QByteArray("begin:"), codec)),
+      mLowerEnd(VersitUtils::encode(QByteArray("end:"), codec)),
+      mUnit(qMax(1, int(mCr.size()))),
+      mLineStart(0),
+      mNextLineStart(0),
+      mScanPosition(0),
+      mDepth(0),
+      mLineType(OtherLine)
+{
+}
+
+/*!
+ * Scans the line of \a data which starts at nextLineStart().  Returns false if \a data doesn't
+ * hold the whole line yet; unless \a atEnd, a line ending in a CR isn't complete until the next
+ * code unit shows whether it is a CRLF.  Otherwise, the line is classified by lineType() and
+ * starts at lineStart(), and true is returned.
+ */
+bool DocumentBoundaryScanner::scanLine(const QByteArray& data, bool atEnd)
+{
+    int position = mScanPosition;
+    while (position + mUnit <= data.size()) {
+        if (mCr.size() == 1 && mLf.size() == 1) {
+            // Skip to the next newline without comparing at every byte
+            const char* const bytes = data.constData();
+            const char cr = mCr.at(0);
+            const char lf = mLf.at(0);
+            while (position < data.size() && bytes[position] != cr && bytes[position] != lf)
+                position++;
+            if (position == data.size())
+                break;
+        }
+        const bool isCr = QVersitReaderPrivate::containsAt(data, mCr, position);
+        if (!isCr && !QVersitReaderPrivate::containsAt(data, mLf, position)) {
+            position += mUnit;
+            continue;
+        }
+        int lineEnd = position + mUnit;
+        if (isCr) {
+            // Wait to see if this is a CRLF
+            if (lineEnd + mUnit > data.size() && !atEnd)
+                break;
+            if (QVersitReaderPrivate::containsAt(data, mLf, lineEnd))
+                lineEnd += mUnit;
+        }
+
+        mLineStart = mNextLineStart;
+        mNextLineStart = mScanPosition = lineEnd;
+        mLineType = OtherLine;
+        if (QVersitReaderPrivate::containsAt(data, mBegin, mLineStart)
+                || QVersitReaderPrivate::containsAt(data, mLowerBegin, mLineStart)) {
+            if (mDepth++ == 0)
+                mLineType = DocumentBegin;
+        } else if (mDepth > 0
+                && (QVersitReaderPrivate::containsAt(data, mEnd, mLineStart)
+                    || QVersitReaderPrivate::containsAt(data, mLowerEnd, mLineStart))) {
+            if (--mDepth == 0)
+                mLineType = DocumentEnd;
+        }
+        return true;
+    }
+    mScanPosition = position;
+    return false;
+}
+
+/*!
+ * Tells the scanner that the first \a count bytes of the data, which must not go past
+ * nextLineStart(), have been removed.
+ */
+void DocumentBoundaryScanner::discard(int count)
+{
+    mLineStart -= count;
+    mNextLineStart -= count;
+    mScanPosition -= count;
+}
+
+/*
+ * Returns the offsets at which \a input can be split into shards of roughly VERSIT_SHARD_SIZE
+ * bytes.  Shards only start at BEGIN lines that are not nested in another document.  As every
+ * shard is parsed as a complete input, a boundary that this scan misses merely makes a shard
+ * bigger.
+ */
+static QList<int> shardOffsets(const QByteArray& input, QTextCodec* codec)
+{
+    QList<int> offsets;
+    offsets.append(0);
+    DocumentBoundaryScanner scanner(codec);
+    while (scanner.scanLine(input, true)) {
+        if (scanner.lineType() == DocumentBoundaryScanner::DocumentBegin
+                && scanner.lineStart() - offsets.last() >= VERSIT_SHARD_SIZE) {
+            offsets.append(scanner.lineStart());
+        }
+    }
+    return offsets;
+}
+
+namespace {
+struct VersitReaderShard
+{
+    VersitReaderShard() : done(false), taken(false), parseError(false), stopped(false) {}
+    QList<QVersitDocument> documents;
+    bool done;
+    bool taken;
+    bool parseError; // Some document in the shard failed to parse
+    bool stopped; // Parsing stopped before the end of the shard, as read() would have
+};
+}
+
+/*!
+ * Reads the whole input, splits it at document boundaries and parses the pieces on a pool of
+ * \a threadCount threads.  If \a ordered, the documents are made available in the order in which
+ * they appear in the input, otherwise in the order in which their shards finish parsing.  At most
+ * twice as many shards as there are threads are held in memory at any time.
+ * Returns false if the reading was canceled.
+ */
+bool QVersitReaderPrivate::readConcurrently(int threadCount, bool ordered)
+{
+    QByteArray input;
+    while (!mIoDevice->atEnd()) {
+        if (isCanceling())
+            return false;
+        QByteArray chunk = mIoDevice->readAll();
+        if (chunk.isEmpty())
+            mIoDevice->waitForReadyRead(500);
+        else
+            input.append(chunk);
+    }
+
+    // Sniff the codec once for the whole input.  If it is only a guess, let each shard guess it
+    // for itself, as it would have been guessed for the input as a whole.
+    QBuffer sniffBuffer(&input);
+    sniffBuffer.open(QIODevice::ReadOnly);
+    LineReader sniffer(&sniffBuffer, mDefaultCodec);
+    QTextCodec* codec = sniffer.isCodecCertain() ? sniffer.codec() : mDefaultCodec;
+
+    const QList<int> offsets = shardOffsets(input, sniffer.codec());
+    const int shardCount = offsets.size();
+    QList<VersitReaderShard> shards(shardCount);
+    QMutex shardMutex;
+    QWaitCondition shardFinished;
+    QAtomicInt stopping(0);
+
+    // The type map is built lazily; do it here rather than racing in the workers.
+    valueTypeMap();
+
+    // Declared last so that it waits for the tasks before the state they use is destroyed.
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    auto startShard = [&](int index) {
+        pool.start([&, index]() {
+            const int begin = offsets.at(index);
+            const int end = index + 1 < shardCount ? offsets.at(index + 1) : input.size();
+            QByteArray data(QByteArray::fromRawData(input.constData() + begin, end - begin));
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::ReadOnly);
+            LineReader lineReader(&buffer, codec);
+            QVersitReaderPrivate parser; // Keeps the nesting level of this shard
+
+            QList<QVersitDocument> documents;
+            bool parseError = false;
+            while (!lineReader.atEnd() && !stopping.loadRelaxed() && !isCanceling()) {
+                QVersitDocument document;
+                int oldPos = lineReader.odometer();
+                if (parser.parseVersitDocument(&lineReader, &document)) {
+                    if (document.isEmpty())
+                        break;
+                    documents.append(document);
+                } else {
+                    parseError = true;
+                    if (lineReader.odometer() == oldPos)
+                        break;
+                }
+            }
+
+            QMutexLocker locker(&shardMutex);
+            VersitReaderShard& shard = shards[index];
+            shard.documents.swap(documents);
+            shard.parseError = parseError;
+            shard.stopped = !lineReader.atEnd();
+            shard.done = true;
+            shardFinished.wakeAll();
+        });
+    };
+
+    int started = 0;
+    while (started < qMin(shardCount, 2 * threadCount))
+        startShard(started++);
+
+    bool canceled = false;
+    for (int delivered = 0; delivered < started; delivered++) {
+        VersitReaderShard shard;
+        {
+            QMutexLocker locker(&shardMutex);
+            int index = -1;
+            forever {
+                if (ordered) {
+                    if (shards.at(delivered).done)
+                        index = delivered;
+                } else {
+                    for (int i = 0; i < started && index < 0; i++) {
+                        if (shards.at(i).done && !shards.at(i).taken)
+                            index = i;
+                    }
+                }
+                if (index >= 0)
+                    break;
+                shardFinished.wait(&shardMutex);
+            }
+            shards[index].taken = true;
+            shard.documents.swap(shards[index].documents);
+            shard.parseError = shards.at(index).parseError;
+            shard.stopped = shards.at(index).stopped;
+        }
+
+        if (shard.parseError)
+            setError(QVersitReader::ParseError);
+        foreach (const QVersitDocument& document, shard.documents) {
+            if (!addDocument(document)) {
+                canceled = true;
+                break;
+            }
+        }
+        if (canceled || isCanceling()) {
+            canceled = true;
+            break;
+        }
+        if (shard.stopped)
+            break;
+        if (started < shardCount)
+            startShard(started++);
+    }
+
+    stopping.storeRelaxed(1);
+    pool.waitForDone();
+    return !canceled;
+}
+
 void QVersitReaderPrivate::setState(QVersitReader::State state)
 {
     mMutex.lock();
@@ -612,6 +948,8 @@ void QVersitReaderPrivate::setCanceling(bool canceling)
 {
     QMutexLocker locker(&mMutex);
     mIsCanceling = canceling;
+    if (canceling)
+        mResultsTaken.wakeAll();
 }
 
 bool QVersitReaderPrivate::isCanceling()
@@ -728,7 +1066,7 @@ QVersitProperty QVersitReaderPrivate::parseNextVersitProperty(
 
     QVersitProperty property;
     property.setGroups(groupsAndName.first);
-    property.setName(groupsAndName.second);
+    property.setName(mStringTable.intern(groupsAndName.second.toUpper()));
     // set the propertyValueType
     QPair<QVersitDocument::VersitType, QString> key =
         qMakePair(versitType, property.name());
@@ -893,7 +1231,9 @@ bool QVersitReaderPrivate::unencode(QByteArray* value,
         || encodingParameters.contains(QStringLiteral("B"), Qt::CaseInsensitive)
         || typeParameters.contains(QStringLiteral("BASE64"), Qt::CaseInsensitive)
         || typeParameters.contains(QStringLiteral("B"), Qt::CaseInsensitive)) {
-        *value = QByteArray::fromBase64(*value);
+        // Decode in place rather than into a copy, as photos and sounds may be large
+        QByteArray::FromBase64Result decoded = QByteArray::fromBase64Encoding(std::move(*value));
+        *value = std::move(decoded.decoded);
         // Remove the encoding parameter as the value is now decoded
         property->removeParameters(QStringLiteral("ENCODING"));
         return true;
@@ -912,19 +1252,22 @@ QString QVersitReaderPrivate::decodeCharset(const QByteArray& value,
                                             QTextCodec** codec) const
 {
     static const QString charset(QStringLiteral("CHARSET"));
+    static QTextCodec* utf8 = QTextCodec::codecForName("UTF-8");
 
     *codec = NULL;
+    bool isValidUtf8 = false;
     if (property->parameters().contains(charset)) {
         QString charsetValue = *property->parameters().find(charset);
         property->removeParameters(charset);
-        *codec = QTextCodec::codecForName(charsetValue.toLatin1());
+        *codec = codecForCharset(charsetValue);
     } else if (!lineReader->isCodecCertain()
             && lineReader->isCodecUtf8Compatible()) {
         // Guess the codec because we don't know for sure what it is and it could possibly be
         // either UTF-8 or an 8-bit codec.
-        if (VersitUtils::isValidUtf8(value)) {
+        isValidUtf8 = VersitUtils::isValidUtf8(value);
+        if (isValidUtf8) {
             // Valid UTF-8
-            *codec = QTextCodec::codecForName("UTF-8");
+            *codec = utf8;
         } else {
             // Invalid UTF-8 - don't try to test future properties for UTF-8-compatibility
             lineReader->setCodecUtf8Incompatible();
@@ -934,37 +1277,77 @@ QString QVersitReaderPrivate::decodeCharset(const QByteArray& value,
     if (*codec == NULL)
         *codec = lineReader->codec();
 
+    // Most values are plain ASCII, which any ASCII-compatible codec decodes to the same text
+    if (VersitUtils::isAsciiCompatible(*codec) && VersitUtils::isAscii(value))
+        return QString::fromLatin1(value);
+    // Valid UTF-8 decodes the same without the codec, unless it starts with a byte order mark
+    // (which the codec strips)
+    if (*codec == utf8 && !value.startsWith("\xef\xbb\xbf")
+            && (isValidUtf8 || VersitUtils::isValidUtf8(value)))
+        return QString::fromUtf8(value);
     return (*codec)->toUnicode(value);
 }
 
+/*!
+ * Returns the codec named by the CHARSET parameter value \a charset, or 0 if there is none.
+ * The codecs are cached for the session, as most documents name the same few charsets.
+ */
+QTextCodec* QVersitReaderPrivate::codecForCharset(const QString& charset) const
+{
+    QHash<QString, QTextCodec*>::const_iterator it = mCharsetCodecs.constFind(charset);
+    if (it != mCharsetCodecs.constEnd())
+        return it.value();
+    QTextCodec* codec = QTextCodec::codecForName(charset.toLatin1());
+    mCharsetCodecs.insert(charset, codec);
+    return codec;
+}
+
+/*!
+ * Returns the value of the hexadecimal digit \a ch, or -1 if it isn't one.
+ */
+static inline int hexDigitValue(char ch)
+{
+    if (ch >= '0' && ch <= '9')
+        return ch - '0';
+    if (ch >= 'a' && ch <= 'f')
+        return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F')
+        return ch - 'A' + 10;
+    return -1;
+}
+
 /*!
  * Decodes Quoted-Printable encoded (RFC 1521) characters in /a text.
  */
 void QVersitReaderPrivate::decodeQuotedPrintable(QByteArray* text) const
 {
-    for (int i=0; i < text->length(); i++) {
-        char current = text->at(i);
-        if (current == '=' && i+2 < text->length()) {
-            char next = text->at(i+1);
-            char nextAfterNext = text->at(i+2);
-            if (((next >= 'a' && next <= 'f') ||
-                 (next >= 'A' && next <= 'F') ||
-                 (next >= '0' && next <= '9')) &&
-                ((nextAfterNext >= 'a' && nextAfterNext <= 'f') ||
-                 (nextAfterNext >= 'A' && nextAfterNext <= 'F') ||
-                 (nextAfterNext >= '0' && nextAfterNext <= '9'))) {
-                bool ok;
-                char decodedChar(text->mid(i+1, 2).toInt(&ok,16));
-                if (ok) {
-                    (*text)[i] = decodedChar;
-                    text->remove(i+1, 2);
-                }
-            } else if (next == '\r' && nextAfterNext == '\n') {
+    if (!text->contains('='))
+        return;
+
+    // The decoded text is never longer than the encoded text, so decode in place in one pass
+    const int length = text->length();
+    char* data = text->data();
+    int decodedLength = 0;
+    int i = 0;
+    while (i < length) {
+        char current = data[i];
+        if (current == '=' && i+2 < length) {
+            int high = hexDigitValue(data[i+1]);
+            int low = hexDigitValue(data[i+2]);
+            if (high >= 0 && low >= 0) {
+                data[decodedLength++] = char((high << 4) | low);
+                i += 3;
+                continue;
+            } else if (data[i+1] == '\r' && data[i+2] == '\n') {
                 // Newlines can still be found here if they are encoded in a non-default charset.
-                text->remove(i, 3);
+                i += 3;
+                continue;
             }
         }
+        data[decodedLength++] = current;
+        i++;
     }
+    text->truncate(decodedLength);
 }
 
 /*!
@@ -991,10 +1374,12 @@ QPair<QStringList,QString>QVersitReaderPrivate::extractPropertyGroupsAndName(
         }
     }
     if (length > 0) {
-        QString trimmedGroupsAndName = codec->toUnicode(line->left(length)).trimmed();
-        QStringList parts = trimmedGroupsAndName.split(QLatin1Char('.'));
-        if (parts.count() > 1) {
-            groupsAndName.second = parts.takeLast();
+        QString trimmedGroupsAndName = mStringTable.decode(line->left(length), codec).trimmed();
+        if (trimmedGroupsAndName.contains(QLatin1Char('.'))) {
+            QStringList parts = trimmedGroupsAndName.split(QLatin1Char('.'));
+            groupsAndName.second = mStringTable.intern(parts.takeLast());
+            for (int i = 0; i < parts.size(); i++)
+                parts[i] = mStringTable.intern(parts.at(i));
             groupsAndName.first = parts;
         } else {
             groupsAndName.second = trimmedGroupsAndName;
@@ -1007,7 +1392,8 @@ QPair<QStringList,QString>QVersitReaderPrivate::extractPropertyGroupsAndName(
 
 /*!
  * Extracts the property parameters as a QMultiHash using \a codec to determine the delimiters.
- * The parameters without names are added as "TYPE" parameters.
+ * The parameters without names are added as "TYPE" parameters.  The parameter names are converted
+ * to upper-case.
  *
  * On entry \a line should contain the line sans the group and name
  * On exit, line will be updated to have the parameters removed.
@@ -1019,7 +1405,8 @@ QMultiHash<QString,QString> QVersitReaderPrivate::extractVCard21PropertyParams(
     QList<QByteArray> paramList = extractParams(line, codec);
     while (!paramList.isEmpty()) {
         QByteArray param = paramList.takeLast();
-        QString name = paramName(param, codec);
+        // Upper-cased here, as by QVersitProperty::insertParameter(), so the interned name is kept
+        QString name = mStringTable.intern(paramName(param, codec).toUpper());
         QString value = paramValue(param, codec);
         result.insert(name,value);
     }
@@ -1029,7 +1416,8 @@ QMultiHash<QString,QString> QVersitReaderPrivate::extractVCard21PropertyParams(
 
 /*!
  * Extracts the property parameters as a QMultiHash using \a codec to determine the delimiters.
- * The parameters without names are added as "TYPE" parameters.
+ * The parameters without names are added as "TYPE" parameters.  The parameter names are converted
+ * to upper-case.
  *
  * On entry \a line should contain the line sans the group and name
  * On exit, line will be updated to have the parameters removed.
@@ -1043,11 +1431,13 @@ QMultiHash<QString,QString> QVersitReaderPrivate::extractVCard30PropertyParams(
         QByteArray param = paramList.takeLast();
         QString name(paramName(param, codec));
         removeBackSlashEscaping(&name);
+        // Upper-cased here, as by QVersitProperty::insertParameter(), so the interned name is kept
+        name = mStringTable.intern(name.toUpper());
         QString values = paramValue(param, codec);
         QStringList valueList = splitValue(values, QLatin1Char(','), Qt::SkipEmptyParts, true);
         foreach (QString value, valueList) {
             removeBackSlashEscaping(&value);
-            result.insert(name, value);
+            result.insert(name, mStringTable.intern(value));
         }
     }
     return result;
@@ -1138,7 +1528,7 @@ QString QVersitReaderPrivate::paramName(const QByteArray& parameter, QTextCodec*
      const QByteArray equals = VersitUtils::encode('=', codec);
      int equalsIndex = parameter.indexOf(equals);
      if (equalsIndex > 0) {
-         return codec->toUnicode(parameter.left(equalsIndex)).trimmed();
+         return mStringTable.decode(parameter.left(equalsIndex), codec).trimmed();
      }
 
      return QStringLiteral("TYPE");
@@ -1157,7 +1547,7 @@ QString QVersitReaderPrivate::paramValue(const QByteArray& parameter, QTextCodec
         value = parameter.right(valueLength).trimmed();
     }
 
-    return codec->toUnicode(value);
+    return mStringTable.decode(value, codec);
 }
 
 /*
@@ -1257,6 +1647,8 @@ QStringList QVersitReaderPrivate::splitValue(const QString& string,
  */
 void QVersitReaderPrivate::removeBackSlashEscaping(QString* text)
 {
+    if (!text->contains(QLatin1Char('\\')))
+        return;
     if (!(text->startsWith(QLatin1Char('"')) && text->endsWith(QLatin1Char('"')))) {
         /* replaces \; with ;
                     \, with ,
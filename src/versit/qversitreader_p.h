@@ -61,10 +61,12 @@
 #include <QtCore/qscopedpointer.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qwaitcondition.h>
 
 #include <QtVersit/qversitreader.h>
 #include <QtVersit/qversitdocument.h>
 #include <QtVersit/qversitproperty.h>
+#include <QtVersit/private/qversitstringtable_p.h>
 
 QT_FORWARD_DECLARE_CLASS(QBuffer)
 QT_FORWARD_DECLARE_CLASS(QIODevice)
@@ -176,6 +178,9 @@ public:
     LByteArray readLine();
 
 private:
+    void initDelimiters();
+    void normalizeNewlines(QByteArray* data, int from) const;
+    int removeFolds(QByteArray* data, int lineEnd);
     void readOneLine(LByteArray* cursor);
     bool tryReadLine(LByteArray* cursor, bool atEnd);
 
@@ -188,6 +193,59 @@ private:
     LByteArray mBuffer;
     int mOdometer;
     int mSearchFrom;
+    QList<int> mFolds; // Offsets of the folds in the current line that are yet to be removed
+
+    // Delimiters encoded with mCodec, computed once rather than for every line
+    QByteArray mCr;
+    QByteArray mLf;
+    QByteArray mCrLf;
+    QByteArray mTab;
+    QByteArray mSpace;
+    QByteArray mColon;
+    QByteArray mEquals;
+    QByteArray mEndVCard;
+    QByteArray mEndVCardLf;
+    QByteArray mEndVCardBeginVCard;
+};
+
+/*
+ * Finds the boundaries of the top-level documents in versit input, by looking for BEGIN and END
+ * lines (in upper or lower case) without parsing the input.  The input may be scanned as it
+ * arrives: scanLine() only reports complete lines, and discard() tells the scanner when the
+ * caller drops the input which has been dealt with.
+ */
+class Q_VERSIT_EXPORT DocumentBoundaryScanner
+{
+public:
+    enum LineType {
+        OtherLine,
+        DocumentBegin, // The BEGIN line of a top-level document
+        DocumentEnd    // The END line of a top-level document
+    };
+
+    explicit DocumentBoundaryScanner(QTextCodec* codec);
+
+    bool scanLine(const QByteArray& data, bool atEnd);
+    void discard(int count);
+
+    LineType lineType() const { return mLineType; }
+    int lineStart() const { return mLineStart; }
+    int nextLineStart() const { return mNextLineStart; }
+    int depth() const { return mDepth; }
+
+private:
+    QByteArray mCr;
+    QByteArray mLf;
+    QByteArray mBegin;
+    QByteArray mEnd;
+    QByteArray mLowerBegin;
+    QByteArray mLowerEnd;
+    int mUnit; // The size of a code unit in the input
+    int mLineStart;
+    int mNextLineStart;
+    int mScanPosition; // The first code unit which hasn't been checked for newlines
+    int mDepth;
+    LineType mLineType;
 };
 
 class Q_VERSIT_EXPORT QVersitReaderPrivate : public QThread
@@ -211,6 +269,8 @@ protected: // From QThread
 
 public: // New functions
     void read();
+    bool readConcurrently(int threadCount, bool ordered);
+    bool addDocument(const QVersitDocument& document);
 
     // mutexed getters and setters.
     void setState(QVersitReader::State);
@@ -254,6 +314,7 @@ public: // New functions
         QTextCodec** codec) const;
 
     void decodeQuotedPrintable(QByteArray* text) const;
+    QTextCodec* codecForCharset(const QString& charset) const;
 
 
     /* These functions operate on a cursor describing a single line */
@@ -290,7 +351,15 @@ public:
     QVersitReader::State mState;
     QVersitReader::Error mError;
     bool mIsCanceling;
+    int mResultsLimit; // 0 means the results are never throttled
+    int mMaxThreadCount; // Documents are parsed on the reader thread alone if this is 1
+    bool mResultsOrdered;
     mutable QMutex mMutex;
+    QWaitCondition mResultsTaken; // Signalled when results are taken or reading is canceled
+    // Shares the names and parameters of the properties read in this session
+    mutable QVersitStringTable mStringTable;
+    // The codecs named by the CHARSET parameters read in this session (0 for unknown names)
+    mutable QHash<QString, QTextCodec*> mCharsetCodecs;
 
 private:
     /* key is the document type and property name, value is the type of property it is.
@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtVersit module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qversitstringtable_p.h"
+
+#include <QtCore/qlist.h>
+
+#include <QTextCodec>
+
+QT_BEGIN_NAMESPACE_VERSIT
+
+// Only short strings are worth interning: names, parameters and enumerated values
+#define MAX_INTERNED_STRING_LENGTH 64
+// Bounds the memory used by the strings of a session which aren't well-known
+#define MAX_INTERNED_STRING_COUNT 4096
+
+/*!
+  \class QVersitStringTable
+  \internal
+  \brief The QVersitStringTable class interns the property names, parameter names and parameter
+  values of versit documents.
+
+  A vCard file with thousands of contacts repeats the same few dozen strings ("TEL", "TYPE",
+  "HOME", ...) on almost every line.  The reader passes these through a string table, so that all
+  of the occurrences share the data of a single QString instead of each holding a copy.
+
+  The well-known vCard and iCalendar strings are shared by every table.  Other strings are
+  interned for the session of the table, which lasts until clear() is called.
+ */
+
+static const char* const wellKnownStrings[] = {
+    // Document structure
+    "BEGIN", "END", "VERSION", "VCARD", "VCALENDAR", "VEVENT", "VTODO", "VJOURNAL", "VTIMEZONE",
+    "VALARM", "STANDARD", "DAYLIGHT",
+    // vCard properties
+    "N", "FN", "TEL", "EMAIL", "ADR", "LABEL", "ORG", "TITLE", "ROLE", "NOTE", "URL", "UID", "REV",
+    "BDAY", "PHOTO", "LOGO", "SOUND", "GEO", "TZ", "NICKNAME", "CATEGORIES", "AGENT", "KEY",
+    "MAILER", "SORT-STRING", "PRODID", "CLASS", "IMPP", "NAME", "SOURCE", "KIND", "GENDER",
+    "X-NICKNAME", "X-IMPP", "X-AIM", "X-ICQ", "X-JABBER", "X-MSN", "X-YAHOO", "X-SKYPE",
+    "X-SKYPE-USERNAME", "X-SIP", "X-ASSISTANT", "X-ASSISTANT-TEL", "X-ANNIVERSARY", "X-CHILDREN",
+    "X-SPOUSE", "X-GENDER", "X-EVOLUTION-FILE-AS", "X-FOLKS-FAVOURITE", "X-QTPROJECT-EXTENDED-DETAIL",
+    "X-QTPROJECT-FAVORITE", "X-QTPROJECT-VERSION",
+    // iCalendar properties
+    "DTSTART", "DTEND", "DUE", "DURATION", "SUMMARY", "DESCRIPTION", "LOCATION", "RRULE",
+    "EXRULE", "RDATE", "EXDATE", "RECURRENCE-ID", "PRIORITY", "STATUS", "COMPLETED",
+    "PERCENT-COMPLETE", "CREATED", "LAST-MODIFIED", "DTSTAMP", "COMMENT", "ATTENDEE", "ORGANIZER",
+    "ACTION", "TRIGGER", "REPEAT", "ATTACH", "TZID", "TZOFFSETFROM", "TZOFFSETTO", "TZNAME",
+    "SEQUENCE", "TRANSP", "CONTACT", "RELATED-TO", "METHOD", "CALSCALE",
+    // Parameter names
+    "TYPE", "ENCODING", "CHARSET", "VALUE", "LANGUAGE", "PREF", "CN", "PARTSTAT", "RSVP", "CUTYPE",
+    "MEMBER", "DELEGATED-TO", "DELEGATED-FROM", "SENT-BY", "DIR", "RANGE", "RELATED", "ALTREP",
+    "FMTTYPE",
+    // Parameter values
+    "HOME", "WORK", "CELL", "VOICE", "FAX", "PAGER", "MSG", "BBS", "MODEM", "CAR", "ISDN", "VIDEO",
+    "INTERNET", "X400", "DOM", "INTL", "POSTAL", "PARCEL", "OTHER", "MOBILE", "MAIN", "IPHONE",
+    "home", "work", "cell", "voice", "fax", "pager", "internet", "pref", "other",
+    "QUOTED-PRINTABLE", "BASE64", "B", "b", "8BIT", "7BIT", "UTF-8", "URI", "DATE", "DATE-TIME",
+    "TEXT", "BINARY", "JPEG", "GIF", "PNG", "START", "REQ-PARTICIPANT", "OPT-PARTICIPANT",
+    "NON-PARTICIPANT", "CHAIR", "NEEDS-ACTION", "ACCEPTED", "DECLINED", "TENTATIVE", "DELEGATED",
+    "INDIVIDUAL", "GROUP", "RESOURCE", "ROOM", "UNKNOWN", "TRUE", "FALSE"
+};
+
+/*!
+  Returns the well-known strings.  Each is allocated once for the
+  process and shared by every table.
+ */
+static const QList<QString>& wellKnownStringList()
+{
+    static const QList<QString> strings = [] {
+        QList<QString> list;
+        const int count = int(sizeof(wellKnownStrings) / sizeof(wellKnownStrings[0]));
+        list.reserve(count);
+        for (int i = 0; i < count; i++)
+            list.append(QString::fromLatin1(wellKnownStrings[i]));
+        return list;
+    }();
+    return strings;
+}
+
+/*!
+  Returns the indexes of the well-known strings in wellKnownStringList().
+ */
+static const QHash<QString, int>& wellKnownIds()
+{
+    static const QHash<QString, int> ids = [] {
+        QHash<QString, int> hash;
+        const QList<QString>& strings = wellKnownStringList();
+        for (int i = 0; i < strings.size(); i++) {
+            if (!hash.contains(strings.at(i)))
+                hash.insert(strings.at(i), i);
+        }
+        return hash;
+    }();
+    return ids;
+}
+
+/*! Constructs an empty table. */
+QVersitStringTable::QVersitStringTable()
+    : mCodec(0)
+{
+}
+
+/*!
+  Returns a string equal to \a string whose data is shared with the previous strings interned in
+  this table (or with the well-known string) of the same value.
+ */
+QString QVersitStringTable::intern(const QString& string)
+{
+    if (string.isEmpty() || string.length() > MAX_INTERNED_STRING_LENGTH)
+        return string;
+
+    const QHash<QString, int>& ids = wellKnownIds();
+    QHash<QString, int>::const_iterator id = ids.constFind(string);
+    if (id != ids.constEnd())
+        return wellKnownStringList().at(id.value());
+
+    QHash<QString, QString>::const_iterator it = mStrings.constFind(string);
+    if (it != mStrings.constEnd())
+        return it.value();
+    if (mStrings.size() < MAX_INTERNED_STRING_COUNT)
+        mStrings.insert(string, string);
+    return string;
+}
+
+/*!
+  Decodes \a encoded with \a codec and returns the interned result.  Short byte sequences which
+  have been decoded before with the same codec are looked up without being decoded again.
+ */
+QString QVersitStringTable::decode(const QByteArray& encoded, QTextCodec* codec)
+{
+    if (encoded.isEmpty() || encoded.size() > MAX_INTERNED_STRING_LENGTH)
+        return codec->toUnicode(encoded);
+
+    if (codec != mCodec) {
+        mDecoded.clear();
+        mCodec = codec;
+    }
+    QHash<QByteArray, QString>::const_iterator it = mDecoded.constFind(encoded);
+    if (it != mDecoded.constEnd())
+        return it.value();
+
+    QString decoded = intern(codec->toUnicode(encoded));
+    if (mDecoded.size() < MAX_INTERNED_STRING_COUNT)
+        mDecoded.insert(encoded, decoded);
+    return decoded;
+}
+
+/*!
+  Forgets the strings interned in this table's session.  The well-known strings are not affected.
+ */
+void QVersitStringTable::clear()
+{
+    mStrings.clear();
+    mDecoded.clear();
+    mCodec = 0;
+}
+
+QT_END_NAMESPACE_VERSIT
@@ -132,6 +132,9 @@ QVersitProperty VersitUtils::takeProperty(const QVersitDocument& document,
  * Returns true iff \a bytes is a valid UTF-8 sequence.
  */
 bool VersitUtils::isValidUtf8(const QByteArray& bytes) {
+    if (isAscii(bytes))
+        return true;
+
     int sequenceLength = 1; // number of bytes in total for a sequence
     int continuation = 0;   // number of bytes left in a continuation
     quint32 codePoint = 0;
@@ -203,6 +206,44 @@ bool VersitUtils::isValidUtf8(const QByteArray& bytes) {
     return continuation == 0;
 }
 
+/*!
+ * Returns true iff every byte of \a bytes is a 7-bit ASCII character.
+ */
+bool VersitUtils::isAscii(const QByteArray& bytes)
+{
+    const char* data = bytes.constData();
+    const int size = bytes.size();
+    int i = 0;
+    // Test a word at a time: no byte may have its high bit set
+    for (; i + int(sizeof(quint64)) <= size; i += sizeof(quint64)) {
+        quint64 word;
+        memcpy(&word, data + i, sizeof(word));
+        if (word & Q_UINT64_C(0x8080808080808080))
+            return false;
+    }
+    for (; i < size; i++) {
+        if (data[i] & 0x80)
+            return false;
+    }
+    return true;
+}
+
+/*!
+ * Returns true iff \a codec decodes every 7-bit ASCII byte to the same character as ASCII does.
+ * Text which isAscii() can then be decoded without the codec.
+ */
+bool VersitUtils::isAsciiCompatible(QTextCodec* codec)
+{
+    if (!codec)
+        return false;
+    const int mib = codec->mibEnum();
+    return mib == 3 // US-ASCII
+        || (mib >= 4 && mib <= 13) // ISO-8859-1 to ISO-8859-10
+        || mib == 106 // UTF-8
+        || (mib >= 109 && mib <= 112) // ISO-8859-13 to ISO-8859-16
+        || (mib >= 2250 && mib <= 2258); // windows-1250 to windows-1258
+}
+
 /*!
  * Convert variant \a data to string \a json in JSON format.
  *
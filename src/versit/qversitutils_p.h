@@ -77,6 +77,8 @@ public:
                                         const QString& propertyName,
                                         QList<QVersitProperty>* toBeRemoved);
     static bool isValidUtf8(const QByteArray& bytes);
+    static bool isAscii(const QByteArray& bytes);
+    static bool isAsciiCompatible(QTextCodec* codec);
     static bool convertToJson(const QVariant &data, QString *json);
     static bool convertFromJson(const QString &json, QVariant *data);
 
@@ -40,6 +40,7 @@
 #include "qversitwriter.h"
 #include "qversitwriter_p.h"
 #include "qversitutils_p.h"
+#include "qversitdocumentwriter_p.h"
 
 #include <QtCore/qbuffer.h>
 
@@ -295,6 +296,97 @@ bool QVersitWriter::waitForFinished(int msec)
     }
 }
 
+/*!
+ * Starts writing \a document to device() synchronously, without closing it, using the
+ * serialization format specified by \a type.  If \a type is QVersitDocument::InvalidType, the
+ * format will be determined based on the contents of \a document.
+ *
+ * The "BEGIN:" line, the properties and the existing subdocuments of \a document are written
+ * immediately.  Further subdocuments can then be appended with writeSubDocuments() and the document
+ * is closed with endDocument().  This allows a large document (eg. an iCalendar VCALENDAR holding
+ * many events) to be written without the whole of it being held in memory.
+ *
+ * Returns false if the output device has not been set or opened or if another write operation is
+ * in progress.  The writer is in the ActiveState until endDocument() is called.  If writing the
+ * start of the document to the device fails, false is returned and the writer moves to the
+ * FinishedState, so that it can be used again.
+ *
+ * \sa writeSubDocuments(), endDocument()
+ */
+bool QVersitWriter::beginDocument(const QVersitDocument& document, QVersitDocument::VersitType type)
+{
+    if (d->state() == ActiveState || d->isRunning()) {
+        d->setError(QVersitWriter::NotReadyError);
+        return false;
+    } else if (!d->mIoDevice || !d->mIoDevice->isWritable()) {
+        d->setError(QVersitWriter::IOError);
+        return false;
+    }
+
+    if (type == QVersitDocument::InvalidType)
+        type = document.type();
+    d->setState(ActiveState);
+    d->setError(NoError);
+    d->setDocumentType(type);
+    d->mStreamDocument = document;
+    d->mStreamWriter.reset(d->documentWriter(type, document));
+    if (!d->mStreamWriter->encodeVersitDocumentStart(document)) {
+        d->mStreamWriter.reset();
+        d->mStreamDocument.clear();
+        d->setError(QVersitWriter::IOError);
+        d->setState(FinishedState);
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * Writes \a subDocuments to device() synchronously, nested inside the document started with
+ * beginDocument().
+ *
+ * Returns false if no document has been started or if writing to the device fails.
+ *
+ * \sa beginDocument(), endDocument()
+ */
+bool QVersitWriter::writeSubDocuments(const QList<QVersitDocument>& subDocuments)
+{
+    if (d->mStreamWriter.isNull()) {
+        d->setError(QVersitWriter::NotReadyError);
+        return false;
+    }
+
+    foreach (const QVersitDocument& subDocument, subDocuments) {
+        if (!d->mStreamWriter->encodeVersitDocument(subDocument, false)) {
+            d->setError(QVersitWriter::IOError);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * Closes the document started with beginDocument() and moves the writer to the FinishedState.
+ *
+ * Returns false if no document has been started or if writing to the device fails.
+ *
+ * \sa beginDocument(), writeSubDocuments()
+ */
+bool QVersitWriter::endDocument()
+{
+    if (d->mStreamWriter.isNull()) {
+        d->setError(QVersitWriter::NotReadyError);
+        return false;
+    }
+
+    bool successful = d->mStreamWriter->encodeVersitDocumentEnd(d->mStreamDocument);
+    d->mStreamWriter.reset();
+    d->mStreamDocument.clear();
+    if (!successful)
+        d->setError(QVersitWriter::IOError);
+    d->setState(FinishedState);
+    return successful;
+}
+
 QT_END_NAMESPACE_VERSIT
 
 #include "moc_qversitwriter.cpp"
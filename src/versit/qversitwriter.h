@@ -99,6 +99,12 @@ public Q_SLOTS:
 public:
     Q_INVOKABLE bool waitForFinished(int msec = -1);
 
+    // incremental writing:
+    bool beginDocument(const QVersitDocument& document,
+                       QVersitDocument::VersitType type = QVersitDocument::InvalidType);
+    bool writeSubDocuments(const QList<QVersitDocument>& subDocuments);
+    bool endDocument();
+
 Q_SIGNALS:
     void stateChanged(QVersitWriter::State state);
 
@@ -94,18 +94,7 @@ void QVersitWriterPrivate::write()
         if (type == QVersitDocument::InvalidType)
             type = document.type();
 
-        QScopedPointer<QVersitDocumentWriter> writer(writerForType(type, document));
-        QTextCodec* codec = mDefaultCodec;
-        if (codec == NULL) {
-            if (type == QVersitDocument::VCard21Type) {
-                codec = QTextCodec::codecForName("ISO-8859-1");
-                writer->setAsciiCodec();
-            } else {
-                codec = QTextCodec::codecForName("UTF-8");
-            }
-        }
-        writer->setCodec(codec);
-        writer->setDevice(mIoDevice);
+        QScopedPointer<QVersitDocumentWriter> writer(documentWriter(type, document));
         if (!writer->encodeVersitDocument(document)) {
             setError(QVersitWriter::IOError);
             break;
@@ -117,6 +106,27 @@ void QVersitWriterPrivate::write()
         setState(QVersitWriter::FinishedState);
 }
 
+/*!
+ * Returns a QVersitDocumentWriter that encodes \a document as \a type with the default codec to the
+ * output device.  The caller is responsible for deleting the object.
+ */
+QVersitDocumentWriter* QVersitWriterPrivate::documentWriter(QVersitDocument::VersitType type, const QVersitDocument& document) const
+{
+    QVersitDocumentWriter* writer = writerForType(type, document);
+    QTextCodec* codec = mDefaultCodec;
+    if (codec == NULL) {
+        if (type == QVersitDocument::VCard21Type) {
+            codec = QTextCodec::codecForName("ISO-8859-1");
+            writer->setAsciiCodec();
+        } else {
+            codec = QTextCodec::codecForName("UTF-8");
+        }
+    }
+    writer->setCodec(codec);
+    writer->setDevice(mIoDevice);
+    return writer;
+}
+
 /*!
  * Inherited from QThread, called by QThread when the thread has been started.
  */
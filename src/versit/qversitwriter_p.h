@@ -90,6 +90,7 @@ public:
     void run() override;
 
     static QVersitDocumentWriter* writerForType(QVersitDocument::VersitType type, const QVersitDocument& document);
+    QVersitDocumentWriter* documentWriter(QVersitDocument::VersitType type, const QVersitDocument& document) const;
 
     QIODevice* mIoDevice;
     QScopedPointer<QBuffer> mOutputBytes; // Holds the data set by setData()
@@ -100,6 +101,9 @@ public:
     mutable QMutex mMutex;
     QTextCodec* mDefaultCodec;
     QVersitDocument::VersitType mType;
+    // Set between QVersitWriter::beginDocument() and QVersitWriter::endDocument()
+    QScopedPointer<QVersitDocumentWriter> mStreamWriter;
+    QVersitDocument mStreamDocument;
 };
 
 QT_END_NAMESPACE_VERSIT
@@ -14,6 +14,7 @@ PUBLIC_HEADERS += \
     qversitwriter.h \
     qversitcontactexporter.h \
     qversitcontactimporter.h \
+    qversitcontactingester.h \
     qversitcontacthandler.h \
     qversitresourcehandler.h
 
@@ -28,10 +29,12 @@ PRIVATE_HEADERS += \
     qvcardrestorehandler_p.h \
     qversitcontactexporter_p.h \
     qversitcontactimporter_p.h \
+    qversitcontactingester_p.h \
     qversitdefs_p.h \
     qversitcontactsdefs_p.h \
     qversitcontactpluginloader_p.h \
     qversitutils_p.h \
+    qversitstringtable_p.h \
     qversitpluginsearch_p.h
 
 SOURCES += \
@@ -50,10 +53,13 @@ SOURCES += \
     qversitcontactexporter_p.cpp \
     qversitcontactimporter.cpp \
     qversitcontactimporter_p.cpp \
+    qversitcontactingester.cpp \
+    qversitcontactingester_p.cpp \
     qversitresourcehandler.cpp \
     qversitcontacthandler.cpp \
     qversitcontactpluginloader_p.cpp \
-    qversitutils.cpp
+    qversitutils.cpp \
+    qversitstringtable.cpp
 
 HEADERS += $$PUBLIC_HEADERS $$PRIVATE_HEADERS
 
@@ -39,34 +39,78 @@
 
 #include "qtimezones_p.h"
 
-#include <QtOrganizer/qorganizer.h>
+#include <QtOrganizer/qorganizermanagerengine.h>
+
+#include <algorithm>
 
 QTORGANIZER_USE_NAMESPACE
 
 QT_BEGIN_NAMESPACE_VERSITORGANIZER
 
-QOrganizerManager* TimeZone::getManager()
+// How many years past the requested one the transitions are computed for, so that converting
+// dates in increasing order doesn't recompute them for every new year
+#define TIMEZONE_TRANSITION_MARGIN_YEARS 10
+
+/*
+ * Returns the sorted start times, in UTC, of every occurrence of \a phase until the end of
+ * \a lastYear, in the same way that the occurrences of an event with the phase's start time,
+ * recurrence rule and recurrence dates would be generated.
+ */
+QList<QDateTime> TimeZone::phaseStarts(const TimeZonePhase& phase, int lastYear)
+{
+    const QDateTime initialDateTime(phase.startDateTime());
+    QList<QDateTime> starts;
+
+    const QSet<QDate> recurrenceDates(phase.recurrenceDates());
+    foreach (const QDate& rdate, recurrenceDates) {
+        QDateTime dt(initialDateTime.toLocalTime());
+        dt.setDate(rdate);
+        starts.append(dt.toUTC());
+    }
+    if (!recurrenceDates.isEmpty())
+        starts.append(initialDateTime.toUTC());
+
+    const QOrganizerRecurrenceRule rrule(phase.recurrenceRule());
+    if (rrule.frequency() != QOrganizerRecurrenceRule::Invalid) {
+        const QDateTime periodEnd(QDate(lastYear, 12, 31), QTime(23, 59, 59, 999));
+        starts.append(QOrganizerManagerEngine::generateDateTimes(
+                initialDateTime, rrule, initialDateTime, periodEnd, 0));
+    }
+
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+    return starts;
+}
+
+/*
+ * Returns the transitions of this time zone, computed at least until the end of \a year.
+ */
+const TimeZoneTransitions& TimeZone::transitions(int year) const
 {
-    // We use the memory engine to do time zone recurrence calculations
-    static QOrganizerManager* manager(new QOrganizerManager(QString::fromLatin1("memory")));
-    return manager;
+    if (mTransitions.isNull() || mTransitions->lastYear < year) {
+        QSharedPointer<TimeZoneTransitions> transitions(new TimeZoneTransitions);
+        transitions->lastYear = year + TIMEZONE_TRANSITION_MARGIN_YEARS;
+        foreach (const TimeZonePhase& phase, mPhases)
+            transitions->phaseStarts.append(phaseStarts(phase, transitions->lastYear));
+        mTransitions = transitions;
+    }
+    return *mTransitions;
 }
 
 QDateTime TimeZone::convert(const QDateTime& dateTime) const
 {
     Q_ASSERT(isValid());
-    QOrganizerManager* manager = getManager();
+    const TimeZoneTransitions& table = transitions(dateTime.date().year());
     int offset = 100000; // impossible value
     QDateTime latestPhase;
-    foreach(const TimeZonePhase& phase, mPhases) {
-        QOrganizerEvent event;
-        event.setStartDateTime(phase.startDateTime());
-        event.setRecurrenceRules(QSet<QOrganizerRecurrenceRule>() << phase.recurrenceRule());
-        event.setRecurrenceDates(phase.recurrenceDates());
-        QList<QOrganizerItem> occurrences =
-            manager->itemOccurrences(event, phase.startDateTime(), dateTime, 500);
-        if (!occurrences.isEmpty()) {
-            QDateTime phaseStart(static_cast<const QOrganizerEventOccurrence &>(occurrences.last()).startDateTime());
+    for (int i = 0; i < mPhases.size(); i++) {
+        const TimeZonePhase& phase = mPhases.at(i);
+        const QList<QDateTime>& starts = table.phaseStarts.at(i);
+        // Find the latest start of the phase between its first start and dateTime
+        QList<QDateTime>::const_iterator it =
+            std::upper_bound(starts.constBegin(), starts.constEnd(), dateTime);
+        if (it != starts.constBegin() && *(it - 1) >= phase.startDateTime()) {
+            const QDateTime& phaseStart = *(it - 1);
             if (phaseStart > latestPhase) {
                 latestPhase = phaseStart;
                 offset = phase.utcOffset();
@@ -86,12 +130,12 @@ QDateTime TimeZone::convert(const QDateTime& dateTime) const
 
 QDateTime TimeZones::convert(const QDateTime& dateTime, const QString& tzid) const
 {
-    if (!mTimeZones.contains(tzid))
-        return QDateTime();
-    TimeZone tz = mTimeZones.value(tzid);
-    if (!tz.isValid())
+    // Use the stored time zone rather than a copy of it, so that its transitions are only
+    // computed once
+    QHash<QString, TimeZone>::const_iterator tz = mTimeZones.constFind(tzid);
+    if (tz == mTimeZones.constEnd() || !tz->isValid())
         return QDateTime();
-    return tz.convert(dateTime);
+    return tz->convert(dateTime);
 }
 
 QT_END_NAMESPACE_VERSITORGANIZER
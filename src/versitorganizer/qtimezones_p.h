@@ -54,15 +54,12 @@
 #include <QtCore/qdatetime.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qsharedpointer.h>
 
 #include <QtOrganizer/qorganizerrecurrencerule.h>
 
 #include <QtVersitOrganizer/qversitorganizerglobal.h>
 
-QT_BEGIN_NAMESPACE_ORGANIZER
-class QOrganizerManager;
-QT_END_NAMESPACE_ORGANIZER
-
 QTORGANIZER_USE_NAMESPACE
 
 QT_BEGIN_NAMESPACE_VERSITORGANIZER
@@ -92,12 +89,19 @@ class TimeZonePhase {
         QSet<QDate> mRecurrenceDates;
 };
 
+// The start times (in UTC) of each phase of a time zone up to the end of a given year
+struct TimeZoneTransitions {
+    TimeZoneTransitions() : lastYear(0) {}
+    int lastYear;
+    QList<QList<QDateTime> > phaseStarts; // sorted, one list per phase
+};
+
 class TimeZone {
     public:
         QDateTime convert(const QDateTime& dateTime) const;
         void setTzid(const QString& tzid) { mTzid = tzid; }
         QString tzid() const { return mTzid; }
-        void addPhase(const TimeZonePhase& phase) { mPhases.append(phase); }
+        void addPhase(const TimeZonePhase& phase) { mPhases.append(phase); mTransitions.reset(); }
         bool isValid() const {
             foreach (const TimeZonePhase& phase, mPhases) {
                 if (!phase.isValid()) return false;
@@ -106,9 +110,12 @@ class TimeZone {
         }
 
     private:
-        static QOrganizerManager* getManager();
+        static QList<QDateTime> phaseStarts(const TimeZonePhase& phase, int lastYear);
+        const TimeZoneTransitions& transitions(int year) const;
         QString mTzid;
         QList<TimeZonePhase> mPhases;
+        // Computed lazily and extended as later dates are converted; shared between copies
+        mutable QSharedPointer<TimeZoneTransitions> mTransitions;
 };
 
 class TimeZones {
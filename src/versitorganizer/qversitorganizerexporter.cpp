@@ -43,6 +43,7 @@
 #include <QtOrganizer/qorganizer.h>
 
 #include <QtVersit/qversitproperty.h>
+#include <QtVersit/qversitwriter.h>
 
 QTORGANIZER_USE_NAMESPACE
 QTVERSIT_USE_NAMESPACE
@@ -126,6 +127,7 @@ QT_BEGIN_NAMESPACE_VERSITORGANIZER
   \value EmptyOrganizerError One of the organizer items was empty
   \value UnknownComponentTypeError One of the components in the iCalendar file is not supported
   \value UnderspecifiedOccurrenceError An event or todo exception was found which did not specify both its parent and a specifier for which instance to override
+  \value UnspecifiedError The export could not be started, for example because no manager or writer was given
   */
 
 /*! Constructs a new exporter */
@@ -164,28 +166,71 @@ bool QVersitOrganizerExporter::exportItems(
     const QList<QOrganizerItem>& items,
     QVersitDocument::VersitType versitType)
 {
-    int itemIndex = 0;
     d->mErrors.clear();
     d->mResult.clear();
     d->mResult.setType(versitType);
     d->mResult.setComponentType(QStringLiteral("VCALENDAR"));
-    bool ok = true;
     QList<QTVERSIT_PREPEND_NAMESPACE(QVersitDocument)> results;
-    foreach (const QOrganizerItem& item, items) {
-        QTVERSIT_PREPEND_NAMESPACE(QVersitDocument) document;
-        document.setType(versitType);
-        QVersitOrganizerExporter::Error error;
-        if (d->exportItem(item, &document, &error)) {
-            results.append(document);
-        } else {
-            d->mErrors.insert(itemIndex, error);
+    bool ok = d->exportItems(items, 0, versitType, &results);
+    d->mResult.setSubDocuments(results);
+
+    return ok;
+}
+
+/*!
+ * Exports the items in \a manager which match \a filter to \a writer as the components of a single
+ * VCALENDAR, using the format given by \a versitType.
+ *
+ * Unlike the overload taking a list of items, the items are fetched from \a manager \a pageSize at a
+ * time, and each page is converted and written to the device of \a writer before the next page is
+ * fetched, so the memory used is bounded by the page size rather than by the size of the calendar.
+ * The items are fetched with the semantics of QOrganizerItemFetchForExportRequest: persisted items
+ * are exported, and occurrences of recurring items are not generated.
+ *
+ * Returns true on success.  If any of the items could not be exported, false is returned and
+ * errorMap() will return a list describing the errors that occurred, keyed by the index of the item
+ * in the export.  False is also returned if \a writer fails to write to its device, in which case
+ * QVersitWriter::error() describes the failure.  If \a manager or \a writer is null, false is
+ * returned and errorMap() maps -1 to UnspecifiedError.  As the components are not held in memory,
+ * the document() afterwards contains only the VCALENDAR itself.
+ *
+ * \sa errorMap(), QVersitWriter::beginDocument()
+ */
+bool QVersitOrganizerExporter::exportItems(
+    QOrganizerManager* manager,
+    QVersitWriter* writer,
+    const QOrganizerItemFilter& filter,
+    int pageSize,
+    QVersitDocument::VersitType versitType)
+{
+    d->mErrors.clear();
+    d->mResult.clear();
+    d->mResult.setType(versitType);
+    d->mResult.setComponentType(QStringLiteral("VCALENDAR"));
+    if (!manager || !writer) {
+        d->mErrors.insert(-1, UnspecifiedError);
+        return false;
+    }
+    if (pageSize <= 0)
+        pageSize = 1;
+
+    const QList<QOrganizerItemId> itemIds = manager->itemIds(QDateTime(), QDateTime(), filter);
+    if (!writer->beginDocument(d->mResult, versitType))
+        return false;
+
+    bool ok = true;
+    for (int pageStart = 0; pageStart < itemIds.size(); pageStart += pageSize) {
+        const QList<QOrganizerItem> items = manager->items(itemIds.mid(pageStart, pageSize));
+        QList<QTVERSIT_PREPEND_NAMESPACE(QVersitDocument)> results;
+        if (!d->exportItems(items, pageStart, versitType, &results))
             ok = false;
+        if (!writer->writeSubDocuments(results)) {
+            writer->endDocument();
+            return false;
         }
-        itemIndex++;
     }
-    d->mResult.setSubDocuments(results);
 
-    return ok;
+    return writer->endDocument() && ok;
 }
 
 /*!
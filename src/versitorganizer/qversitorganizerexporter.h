@@ -45,6 +45,7 @@
 #include <QtCore/qset.h>
 
 #include <QtOrganizer/qorganizeritem.h>
+#include <QtOrganizer/qorganizeritemfilter.h>
 
 #include <QtVersit/qversitdocument.h>
 #include <QtVersit/qversitproperty.h>
@@ -53,8 +54,13 @@
 
 QT_BEGIN_NAMESPACE_ORGANIZER
 class QOrganizerItemDetail;
+class QOrganizerManager;
 QT_END_NAMESPACE_ORGANIZER
 
+QT_BEGIN_NAMESPACE_VERSIT
+class QVersitWriter;
+QT_END_NAMESPACE_VERSIT
+
 QTORGANIZER_USE_NAMESPACE
 QTVERSIT_USE_NAMESPACE
 
@@ -83,7 +89,8 @@ public:
         NoError = 0,
         EmptyOrganizerError,
         UnknownComponentTypeError,
-        UnderspecifiedOccurrenceError
+        UnderspecifiedOccurrenceError,
+        UnspecifiedError
     };
 
     QVersitOrganizerExporter();
@@ -92,6 +99,9 @@ public:
 
     bool exportItems(const QList<QOrganizerItem>& items,
             QVersitDocument::VersitType versitType = QVersitDocument::ICalendar20Type);
+    bool exportItems(QOrganizerManager* manager, QVersitWriter* writer,
+            const QOrganizerItemFilter& filter = QOrganizerItemFilter(), int pageSize = 100,
+            QVersitDocument::VersitType versitType = QVersitDocument::ICalendar20Type);
     QVersitDocument document() const;
     QMap<int, Error> errorMap() const;
 
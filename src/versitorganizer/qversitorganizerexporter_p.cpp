@@ -81,6 +81,34 @@ QVersitOrganizerExporterPrivate::~QVersitOrganizerExporterPrivate()
     }
 }
 
+/*!
+ * Exports each of the \a items, the first of which has the index \a firstIndex in the export, to a
+ * document of the given \a versitType appended to \a documents.  Returns false if any of the items
+ * could not be exported, in which case the errors are added to mErrors.
+ */
+bool QVersitOrganizerExporterPrivate::exportItems(
+    const QList<QOrganizerItem>& items,
+    int firstIndex,
+    QVersitDocument::VersitType versitType,
+    QList<QVersitDocument>* documents)
+{
+    bool ok = true;
+    int itemIndex = firstIndex;
+    foreach (const QOrganizerItem& item, items) {
+        QVersitDocument document;
+        document.setType(versitType);
+        QVersitOrganizerExporter::Error error;
+        if (exportItem(item, &document, &error)) {
+            documents->append(document);
+        } else {
+            mErrors.insert(itemIndex, error);
+            ok = false;
+        }
+        itemIndex++;
+    }
+    return ok;
+}
+
 bool QVersitOrganizerExporterPrivate::exportItem(
     const QOrganizerItem& item,
     QVersitDocument* document,
@@ -82,6 +82,10 @@ public:
     bool exportItem(const QOrganizerItem& item,
                     QVersitDocument* document,
                     QVersitOrganizerExporter::Error* error);
+    bool exportItems(const QList<QOrganizerItem>& items,
+                     int firstIndex,
+                     QVersitDocument::VersitType versitType,
+                     QList<QVersitDocument>* documents);
 
     QVersitDocument mResult;
     QMap<int, QVersitOrganizerExporter::Error> mErrors;
@@ -50,6 +50,7 @@ public:
 
 private slots:
     void details();
+    void detailsByType();
     void preferences();
     void relationships();
     void type();
@@ -367,6 +368,57 @@ void tst_QContact::details()
     QCOMPARE(c.id(), oldId); // id shouldn't change.
 }
 
+void tst_QContact::detailsByType()
+{
+    // details of different types interleaved, so that removals shift the others
+    QContact c;
+    QContactPhoneNumber p1;
+    p1.setNumber("1");
+    QContactEmailAddress e1;
+    e1.setEmailAddress("one@example.com");
+    QContactPhoneNumber p2;
+    p2.setNumber("2");
+    QContactEmailAddress e2;
+    e2.setEmailAddress("two@example.com");
+    QContactPhoneNumber p3;
+    p3.setNumber("3");
+    QVERIFY(c.saveDetail(&p1));
+    QVERIFY(c.saveDetail(&e1));
+    QVERIFY(c.saveDetail(&p2));
+    QVERIFY(c.appendDetail(e2));
+    QVERIFY(c.saveDetail(&p3));
+
+    QCOMPARE(c.details<QContactPhoneNumber>().size(), 3);
+    QCOMPARE(c.details<QContactEmailAddress>().size(), 2);
+    QCOMPARE(c.detail<QContactEmailAddress>().emailAddress(), QString("one@example.com"));
+
+    // updating a detail keeps its position
+    p2.setNumber("22");
+    QVERIFY(c.saveDetail(&p2));
+    QCOMPARE(c.details<QContactPhoneNumber>().size(), 3);
+    QCOMPARE(c.details<QContactPhoneNumber>().at(1).number(), QString("22"));
+
+    // removing a detail leaves the others in order
+    QVERIFY(c.removeDetail(&e1));
+    QCOMPARE(c.detail<QContactEmailAddress>().emailAddress(), QString("two@example.com"));
+    QVERIFY(c.removeDetail(&p1));
+    QList<QContactPhoneNumber> numbers = c.details<QContactPhoneNumber>();
+    QCOMPARE(numbers.size(), 2);
+    QCOMPARE(numbers.at(0).number(), QString("22"));
+    QCOMPARE(numbers.at(1).number(), QString("3"));
+
+    // a copy is indexed independently of the original
+    QContact copy(c);
+    QVERIFY(copy.removeDetail(&p2));
+    QCOMPARE(copy.details<QContactPhoneNumber>().size(), 1);
+    QCOMPARE(c.details<QContactPhoneNumber>().size(), 2);
+
+    c.clearDetails();
+    QVERIFY(c.details<QContactPhoneNumber>().isEmpty());
+    QVERIFY(c.detail<QContactEmailAddress>().isEmpty());
+    QCOMPARE(c.details<QContactType>().size(), 1);
+}
+
 void tst_QContact::preferences()
 {
     QContact c;
@@ -238,6 +238,8 @@ private slots:
 
     void threadDelivery();
     void threadDelivery_data() { addManagers(QStringList(QString("maliciousplugin"))); }
+
+    void memoryWorkerThreads(); // uses it's own custom data (manager)
 protected slots:
     void resultsAvailableReceived();
 
@@ -2984,6 +2986,88 @@ void tst_QContactAsync::threadDelivery()
     delete req;
 }
 
+void tst_QContactAsync::memoryWorkerThreads()
+{
+    QMap<QString, QString> params;
+    params.insert("id", "memoryWorkerThreads");
+    params.insert("workerThreads", "2");
+    QScopedPointer<QContactManager> cm(QContactManager::fromUri(QContactManager::buildUri("memory", params)));
+
+    QList<QContact> contacts;
+    for (int i = 0; i < 2500; ++i) {
+        QContact c;
+        QContactName name;
+        name.setFirstName(QString::number(i));
+        c.saveDetail(&name);
+        contacts.append(c);
+    }
+    QVERIFY(cm->saveContacts(&contacts));
+
+    // the fetch is executed by the worker threads, and waiting for it waits for the results.
+    QContactFetchRequest fetch;
+    fetch.setManager(cm.data());
+    QVERIFY(fetch.start());
+    QVERIFY(fetch.waitForFinished());
+    QCOMPARE(fetch.state(), QContactAbstractRequest::FinishedState);
+    QCOMPARE(fetch.error(), QContactManager::NoError);
+    QCOMPARE(fetch.contacts().size(), contacts.size());
+
+    QContactDetailFilter filter;
+    filter.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+    filter.setValue("1");
+    filter.setMatchFlags(QContactFilter::MatchStartsWith);
+    QContactSortOrder sortOrder;
+    sortOrder.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+    QContactIdFetchRequest idFetch;
+    idFetch.setManager(cm.data());
+    idFetch.setFilter(filter);
+    idFetch.setSorting(QList<QContactSortOrder>() << sortOrder);
+    QVERIFY(idFetch.start());
+    QVERIFY(idFetch.waitForFinished());
+    QCOMPARE(idFetch.state(), QContactAbstractRequest::FinishedState);
+    QCOMPARE(idFetch.ids(), cm->contactIds(filter, QList<QContactSortOrder>() << sortOrder));
+
+    QContactFetchByIdRequest fetchById;
+    fetchById.setManager(cm.data());
+    fetchById.setIds(QList<QContactId>() << contacts.at(1).id() << contacts.at(0).id());
+    QVERIFY(fetchById.start());
+    QVERIFY(fetchById.waitForFinished());
+    QCOMPARE(fetchById.contacts().size(), 2);
+    QCOMPARE(fetchById.contacts().at(0).id(), contacts.at(1).id());
+
+    // unfinished requests can be canceled, and their results are never delivered.  A worker
+    // only finishes a request through the event loop of this thread, which isn't run before
+    // the request is canceled, so the cancellation always wins.  With a single worker thread
+    // sharing the store, the request started after it is executed after it, so once that one
+    // is finished, everything the canceled request's worker queued has been delivered.
+    params.insert("workerThreads", "1");
+    QScopedPointer<QContactManager> single(QContactManager::fromUri(QContactManager::buildUri("memory", params)));
+    QContactFetchRequest canceled;
+    canceled.setManager(single.data());
+    QSignalSpy canceledResultsSpy(&canceled, SIGNAL(resultsAvailable()));
+    QVERIFY(canceled.start());
+    QVERIFY(canceled.cancel());
+    QCOMPARE(canceled.state(), QContactAbstractRequest::CanceledState);
+
+    QContactIdFetchRequest following;
+    following.setManager(single.data());
+    QVERIFY(following.start());
+    QVERIFY(following.waitForFinished());
+    QCOMPARE(following.ids().size(), contacts.size());
+    QCoreApplication::processEvents();
+    QCOMPARE(canceled.state(), QContactAbstractRequest::CanceledState);
+    QVERIFY(canceled.contacts().isEmpty());
+    QCOMPARE(canceledResultsSpy.count(), 0);
+
+    // requests which modify the store are still completed immediately.
+    QContactRemoveRequest remove;
+    remove.setManager(cm.data());
+    remove.setContactId(contacts.at(0).id());
+    QVERIFY(remove.start());
+    QCOMPARE(remove.state(), QContactAbstractRequest::FinishedState);
+    QCOMPARE(cm->contactIds().size(), contacts.size() - 1);
+}
+
 void tst_QContactAsync::resultsAvailableReceived()
 {
     QContactFetchRequest *req = qobject_cast<QContactFetchRequest *>(QObject::sender());
@@ -53,6 +53,7 @@ private slots:
     void templates();
     void contexts();
     void values();
+    void extraFields();
     void hash();
     void datastream();
     void traits();
@@ -300,6 +301,7 @@ void tst_QContactDetail::values()
     QContactDetail p;
     QMap<int, QVariant> emptyValues;
     QCOMPARE(p.values(), emptyValues);
+    QCOMPARE(p.nextField(), -1);
 
     QDateTime dt = QDateTime::currentDateTime();
     QTime t = dt.time();
@@ -492,6 +494,67 @@ void tst_QContactDetail::values()
     QVERIFY(p.removeValue(QContactAddress::FieldPostOfficeBox));
 }
 
+void tst_QContactDetail::extraFields()
+{
+    // fields without a typed member are kept sorted, whatever the insertion order
+    QContactDetail d;
+    QVERIFY(d.setValue(300, QString("three")));
+    QVERIFY(d.setValue(100, QString("one")));
+    QVERIFY(d.setValue(200, QString("two")));
+    QVERIFY(d.setValue(QContactDetail::FieldMaximumUserVisible + 1, QString("hidden")));
+    d.setContexts(QContactDetail::ContextHome);
+
+    QCOMPARE(d.values().keys(), QList<int>() << 100 << 200 << 300 << QContactDetail::FieldContext);
+    QCOMPARE(d.nextField(), 100);
+    QCOMPARE(d.nextField(100), 200);
+    QCOMPARE(d.nextField(250), 300);
+    QCOMPARE(d.nextField(300), int(QContactDetail::FieldContext));
+    QCOMPARE(d.nextField(QContactDetail::FieldContext), -1);
+
+    // the typed fields are visited in the same order as values() reports them
+    QContactName name;
+    name.setLastName(QString("Last"));
+    name.setFirstName(QString("First"));
+    name.setValue(150, QString("extra"));
+    name.setContexts(QContactDetail::ContextWork);
+    QList<int> fields;
+    for (int field = name.nextField(); field != -1; field = name.nextField(field))
+        fields.append(field);
+    QCOMPARE(fields, name.values().keys());
+    QVERIFY(d.hasValue(200));
+    QVERIFY(!d.hasValue(150));
+    QVERIFY(d.hasValue(QContactDetail::FieldMaximumUserVisible + 1));
+    QCOMPARE(d.value(QContactDetail::FieldMaximumUserVisible + 1).toString(), QString("hidden"));
+
+    QVERIFY(d.setValue(200, QString("deux")));
+    QCOMPARE(d.value(200).toString(), QString("deux"));
+    QVERIFY(d.removeValue(200));
+    QVERIFY(!d.hasValue(200));
+    QVERIFY(!d.removeValue(200));
+    QCOMPARE(d.values().keys(), QList<int>() << 100 << 300 << QContactDetail::FieldContext);
+
+    // comparison does not depend on the insertion order
+    QContactDetail d2;
+    d2.setContexts(QContactDetail::ContextHome);
+    QVERIFY(d2.setValue(QContactDetail::FieldMaximumUserVisible + 1, QString("hidden")));
+    QVERIFY(d2.setValue(300, QString("three")));
+    QVERIFY(d2 != d);
+    QVERIFY(d2.setValue(100, QString("one")));
+    QCOMPARE(d2, d);
+    QCOMPARE(qHash(d2), qHash(d));
+    QVERIFY(d2.setValue(100, QString("uno")));
+    QVERIFY(d2 != d);
+
+    // QList<int> values compare by value
+    QContactDetail d3;
+    QContactDetail d4;
+    QVERIFY(d3.setValue(100, QVariant::fromValue(QList<int>() << 1 << 2)));
+    QVERIFY(d4.setValue(100, QVariant::fromValue(QList<int>() << 1 << 2)));
+    QCOMPARE(d3, d4);
+    QVERIFY(d4.setValue(100, QVariant::fromValue(QList<int>() << 2 << 1)));
+    QVERIFY(d3 != d4);
+}
+
 void tst_QContactDetail::hash()
 {
     QContactExtendedDetail detail1;
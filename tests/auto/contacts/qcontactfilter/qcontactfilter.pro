@@ -1,6 +1,6 @@
 include(../../auto.pri)
 
-QT += contacts
+QT += contacts contacts-private
 
 SOURCES  += tst_qcontactfilter.cpp
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -29,6 +29,7 @@
 #include <QMetaType>
 
 #include <QtContacts/qcontacts.h>
+#include <QtContacts/private/qcontactfilterprogram_p.h>
 
 //TESTED_COMPONENT=src/contacts
 
@@ -75,6 +76,8 @@ private slots:
     void canonicalizedFilter_data();
     void testFilter();
     void testFilter_data();
+    void filterProgram();
+    void filterProgram_data();
     void collectionFilter();
 
     void datastream();
@@ -1207,6 +1210,301 @@ void tst_QContactFilter::testFilter_data()
     }
 }
 
+static QList<QContact> filterProgramContacts()
+{
+    QList<QContact> contacts;
+    contacts.append(QContact());
+
+    {
+        QContact contact;
+        contact.setId(makeId(QStringLiteral("a"), 1));
+        contact.setCollectionId(makeCollectionId(1));
+        QContactName name;
+        name.setFirstName(QStringLiteral("Alice"));
+        name.setLastName(QStringLiteral("Smith"));
+        contact.saveDetail(&name);
+        QContactPhoneNumber phone;
+        phone.setNumber(QStringLiteral("+358 (40) 123-4567"));
+        contact.saveDetail(&phone);
+        QContactEmailAddress email;
+        email.setEmailAddress(QStringLiteral("alice@example.com"));
+        contact.saveDetail(&email);
+        QContactBirthday birthday;
+        birthday.setDateTime(QDateTime(QDate(1980, 5, 17), QTime(0, 0)));
+        contact.saveDetail(&birthday);
+        QContactTimestamp timestamp;
+        timestamp.setCreated(QDateTime(QDate(2020, 1, 1), QTime(12, 0)));
+        timestamp.setLastModified(QDateTime(QDate(2021, 1, 1), QTime(12, 0)));
+        contact.saveDetail(&timestamp);
+        QContactOrganization org;
+        org.setDepartment(QStringList(QStringLiteral("one")));
+        contact.saveDetail(&org);
+        QContactRelationship spouse;
+        spouse.setFirst(contact.id());
+        spouse.setSecond(makeId(QStringLiteral("a"), 2));
+        spouse.setRelationshipType(QContactRelationship::HasSpouse());
+        QContactManagerEngine::setContactRelationships(&contact, QList<QContactRelationship>() << spouse);
+        contacts.append(contact);
+    }
+
+    {
+        QContact contact;
+        contact.setId(makeId(QStringLiteral("a"), 2));
+        contact.setCollectionId(makeCollectionId(2));
+        QContactName name;
+        name.setFirstName(QStringLiteral("bob"));
+        name.setLastName(QStringLiteral("smith"));
+        contact.saveDetail(&name);
+        QContactPhoneNumber phone;
+        phone.setNumber(QStringLiteral("555"));
+        contact.saveDetail(&phone);
+        QContactPhoneNumber mobile;
+        mobile.setNumber(QStringLiteral("0401234567"));
+        contact.saveDetail(&mobile);
+        QContactNickname nickname;
+        nickname.setNickname(QStringLiteral("BOBBY"));
+        contact.saveDetail(&nickname);
+        QContactBirthday birthday;
+        birthday.setDateTime(QDateTime(QDate(1990, 1, 2), QTime(0, 0)));
+        contact.saveDetail(&birthday);
+        QContactTimestamp timestamp;
+        timestamp.setCreated(QDateTime(QDate(2020, 8, 1), QTime(12, 0)));
+        contact.saveDetail(&timestamp);
+        QContactRelationship spouse;
+        spouse.setFirst(makeId(QStringLiteral("a"), 1));
+        spouse.setSecond(contact.id());
+        spouse.setRelationshipType(QContactRelationship::HasSpouse());
+        QContactManagerEngine::setContactRelationships(&contact, QList<QContactRelationship>() << spouse);
+        contacts.append(contact);
+    }
+
+    {
+        QContact contact;
+        contact.setId(makeId(QStringLiteral("a"), 3));
+        QContactName name;
+        name.setLastName(QStringLiteral("Carter"));
+        contact.saveDetail(&name);
+        QContactName emptyName;
+        contact.saveDetail(&emptyName);
+        contacts.append(contact);
+    }
+
+    return contacts;
+}
+
+void tst_QContactFilter::filterProgram()
+{
+    QFETCH(QContactFilter, filter);
+    QFETCH(bool, matchesAll);
+    QFETCH(bool, matchesNone);
+
+    const QContactFilterProgram program(filter);
+    QCOMPARE(program.matchesAll(), matchesAll);
+    QCOMPARE(program.matchesNone(), matchesNone);
+
+    // the program has to give the same result as testFilter() for every contact
+    foreach (const QContact &contact, filterProgramContacts()) {
+        const bool expected = QContactManagerEngine::testFilter(filter, contact);
+        QCOMPARE(program.matches(contact), expected);
+        if (matchesAll)
+            QVERIFY(expected);
+        if (matchesNone)
+            QVERIFY(!expected);
+    }
+}
+
+void tst_QContactFilter::filterProgram_data()
+{
+    QTest::addColumn<QContactFilter>("filter");
+    QTest::addColumn<bool>("matchesAll");
+    QTest::addColumn<bool>("matchesNone");
+
+    QTest::newRow("default") << QContactFilter() << true << false;
+    QTest::newRow("invalid") << QContactFilter(QContactInvalidFilter()) << false << true;
+
+    {
+        QContactIdFilter idf;
+        QTest::newRow("id empty") << QContactFilter(idf) << false << true;
+        idf.setIds(QList<QContactId>() << makeId(QStringLiteral("a"), 1) << makeId(QStringLiteral("a"), 3));
+        QTest::newRow("id") << QContactFilter(idf) << false << false;
+    }
+
+    {
+        QContactCollectionFilter cf;
+        QTest::newRow("collection empty") << QContactFilter(cf) << false << true;
+        cf.setCollectionId(makeCollectionId(2));
+        QTest::newRow("collection") << QContactFilter(cf) << false << false;
+    }
+
+    {
+        QContactDetailFilter df;
+        QTest::newRow("detail undefined type") << QContactFilter(df) << false << true;
+        df.setDetailType(QContactName::Type);
+        QTest::newRow("detail presence") << QContactFilter(df) << false << false;
+        df.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+        QTest::newRow("detail field presence") << QContactFilter(df) << false << false;
+    }
+
+    // string and variant matching with every match type and case sensitivity
+    const QList<QPair<QByteArray, QContactFilter::MatchFlags> > stringFlags = QList<QPair<QByteArray, QContactFilter::MatchFlags> >()
+            << qMakePair(QByteArray("exactly"), QContactFilter::MatchFlags(QContactFilter::MatchExactly))
+            << qMakePair(QByteArray("exactly case sensitive"), QContactFilter::MatchExactly | QContactFilter::MatchCaseSensitive)
+            << qMakePair(QByteArray("fixed string"), QContactFilter::MatchFlags(QContactFilter::MatchFixedString))
+            << qMakePair(QByteArray("fixed string case sensitive"), QContactFilter::MatchFixedString | QContactFilter::MatchCaseSensitive)
+            << qMakePair(QByteArray("contains"), QContactFilter::MatchFlags(QContactFilter::MatchContains))
+            << qMakePair(QByteArray("starts with"), QContactFilter::MatchFlags(QContactFilter::MatchStartsWith))
+            << qMakePair(QByteArray("starts with case sensitive"), QContactFilter::MatchStartsWith | QContactFilter::MatchCaseSensitive)
+            << qMakePair(QByteArray("ends with"), QContactFilter::MatchFlags(QContactFilter::MatchEndsWith));
+    const QStringList needles = QStringList() << QStringLiteral("alice") << QStringLiteral("Al")
+                                              << QStringLiteral("ITH") << QStringLiteral("b");
+    for (int i = 0; i < stringFlags.size(); ++i) {
+        foreach (const QString &needle, needles) {
+            QContactDetailFilter df;
+            df.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+            df.setMatchFlags(stringFlags.at(i).second);
+            df.setValue(needle);
+            QTest::newRow(QByteArray("name " + stringFlags.at(i).first + " " + needle.toUtf8()).constData())
+                    << QContactFilter(df) << false << false;
+            df.setDetailType(QContactName::Type, QContactName::FieldLastName);
+            QTest::newRow(QByteArray("last name " + stringFlags.at(i).first + " " + needle.toUtf8()).constData())
+                    << QContactFilter(df) << false << false;
+        }
+    }
+
+    {
+        QContactDetailFilter df;
+        df.setDetailType(QContactOrganization::Type, QContactOrganization::FieldDepartment);
+        df.setValue(QStringList(QStringLiteral("ONE")));
+        QTest::newRow("stringlist case insensitive") << QContactFilter(df) << false << false;
+        df.setMatchFlags(QContactFilter::MatchCaseSensitive);
+        QTest::newRow("stringlist case sensitive") << QContactFilter(df) << false << false;
+        df.setDetailType(QContactBirthday::Type, QContactBirthday::FieldBirthday);
+        df.setValue(QDateTime(QDate(1980, 5, 17), QTime(0, 0)));
+        QTest::newRow("variant date") << QContactFilter(df) << false << false;
+    }
+
+    // phone number matching, including the fallback to the rightmost seven digits
+    const QList<QPair<QByteArray, QContactFilter::MatchFlags> > phoneFlags = QList<QPair<QByteArray, QContactFilter::MatchFlags> >()
+            << qMakePair(QByteArray("phone"), QContactFilter::MatchFlags(QContactFilter::MatchPhoneNumber))
+            << qMakePair(QByteArray("phone exactly"), QContactFilter::MatchPhoneNumber | QContactFilter::MatchExactly)
+            << qMakePair(QByteArray("phone contains"), QContactFilter::MatchPhoneNumber | QContactFilter::MatchContains)
+            << qMakePair(QByteArray("phone starts with"), QContactFilter::MatchPhoneNumber | QContactFilter::MatchStartsWith)
+            << qMakePair(QByteArray("phone ends with"), QContactFilter::MatchPhoneNumber | QContactFilter::MatchEndsWith);
+    const QStringList numbers = QStringList() << QStringLiteral("1234567") << QStringLiteral("+358-40-123 4567")
+                                              << QStringLiteral("358") << QStringLiteral("55") << QStringLiteral("999");
+    for (int i = 0; i < phoneFlags.size(); ++i) {
+        foreach (const QString &number, numbers) {
+            QContactDetailFilter df;
+            df.setDetailType(QContactPhoneNumber::Type, QContactPhoneNumber::FieldNumber);
+            df.setMatchFlags(phoneFlags.at(i).second);
+            df.setValue(number);
+            QTest::newRow(QByteArray(phoneFlags.at(i).first + " " + number.toUtf8()).constData())
+                    << QContactFilter(df) << false << false;
+        }
+    }
+
+    {
+        QContactDetailFilter df;
+        df.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+        df.setMatchFlags(QContactFilter::MatchKeypadCollation | QContactFilter::MatchStartsWith);
+        df.setValue(QStringLiteral("254"));
+        QTest::newRow("keypad starts with") << QContactFilter(df) << false << false;
+        df.setMatchFlags(QContactFilter::MatchKeypadCollation | QContactFilter::MatchExactly);
+        df.setValue(QStringLiteral("262"));
+        QTest::newRow("keypad exactly") << QContactFilter(df) << false << false;
+        df.setMatchFlags(QContactFilter::MatchKeypadCollation | QContactFilter::MatchContains);
+        df.setValue(QStringLiteral("42"));
+        QTest::newRow("keypad contains") << QContactFilter(df) << false << false;
+    }
+
+    {
+        QContactDetailRangeFilter rf;
+        QTest::newRow("range undefined type") << QContactFilter(rf) << false << true;
+        rf.setDetailType(QContactName::Type);
+        QTest::newRow("range detail presence") << QContactFilter(rf) << false << false;
+        rf.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+        QTest::newRow("range field presence") << QContactFilter(rf) << false << false;
+
+        rf.setMatchFlags(QContactFilter::MatchFixedString);
+        rf.setRange(QStringLiteral("a"), QStringLiteral("bob"));
+        QTest::newRow("range string") << QContactFilter(rf) << false << false;
+        rf.setRange(QStringLiteral("a"), QStringLiteral("bob"), QContactDetailRangeFilter::ExcludeLower | QContactDetailRangeFilter::IncludeUpper);
+        QTest::newRow("range string exclude lower include upper") << QContactFilter(rf) << false << false;
+        rf.setMatchFlags(QContactFilter::MatchFixedString | QContactFilter::MatchCaseSensitive);
+        rf.setRange(QStringLiteral("B"), QVariant());
+        QTest::newRow("range string case sensitive minimum") << QContactFilter(rf) << false << false;
+
+        rf.setMatchFlags(QContactFilter::MatchExactly);
+        rf.setDetailType(QContactBirthday::Type, QContactBirthday::FieldBirthday);
+        rf.setRange(QDateTime(QDate(1970, 1, 1), QTime(0, 0)), QDateTime(QDate(1985, 1, 1), QTime(0, 0)));
+        QTest::newRow("range variant") << QContactFilter(rf) << false << false;
+        rf.setRange(QVariant(), QDateTime(QDate(1990, 1, 2), QTime(0, 0)), QContactDetailRangeFilter::IncludeUpper);
+        QTest::newRow("range variant maximum include upper") << QContactFilter(rf) << false << false;
+    }
+
+    {
+        QContactChangeLogFilter cf;
+        cf.setSince(QDateTime(QDate(2020, 6, 1), QTime(0, 0)));
+        cf.setEventType(QContactChangeLogFilter::EventAdded);
+        QTest::newRow("change log added") << QContactFilter(cf) << false << false;
+        cf.setEventType(QContactChangeLogFilter::EventChanged);
+        QTest::newRow("change log changed") << QContactFilter(cf) << false << false;
+        cf.setEventType(QContactChangeLogFilter::EventRemoved);
+        QTest::newRow("change log removed") << QContactFilter(cf) << false << true;
+    }
+
+    {
+        QContactRelationshipFilter rf;
+        rf.setRelationshipType(QContactRelationship::HasSpouse());
+        QTest::newRow("relationship either") << QContactFilter(rf) << false << false;
+        rf.setRelatedContactId(makeId(QStringLiteral("a"), 2));
+        rf.setRelatedContactRole(QContactRelationship::Second);
+        QTest::newRow("relationship second") << QContactFilter(rf) << false << false;
+        rf.setRelatedContactId(makeId(QStringLiteral("a"), 1));
+        rf.setRelatedContactRole(QContactRelationship::First);
+        QTest::newRow("relationship first") << QContactFilter(rf) << false << false;
+    }
+
+    {
+        QContactActionFilter af;
+        af.setActionName(QStringLiteral("NoSuchAction"));
+        QTest::newRow("action without descriptors") << QContactFilter(af) << false << true;
+    }
+
+    {
+        QContactDetailFilter alice;
+        alice.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+        alice.setValue(QStringLiteral("Alice"));
+        QContactDetailFilter smith;
+        smith.setDetailType(QContactName::Type, QContactName::FieldLastName);
+        smith.setMatchFlags(QContactFilter::MatchFixedString);
+        smith.setValue(QStringLiteral("SMITH"));
+        QContactDetailFilter phone;
+        phone.setDetailType(QContactPhoneNumber::Type, QContactPhoneNumber::FieldNumber);
+        phone.setMatchFlags(QContactFilter::MatchPhoneNumber);
+        phone.setValue(QStringLiteral("555"));
+        QContactCollectionFilter collection;
+        collection.setCollectionId(makeCollectionId(2));
+
+        QTest::newRow("intersection empty") << QContactFilter(QContactIntersectionFilter()) << false << true;
+        QTest::newRow("union empty") << QContactFilter(QContactUnionFilter()) << false << true;
+        QTest::newRow("intersection") << QContactFilter(smith & phone) << false << false;
+        QTest::newRow("union") << QContactFilter(alice | phone) << false << false;
+        QTest::newRow("intersection of unions") << QContactFilter((alice | phone) & (smith | collection)) << false << false;
+        QTest::newRow("union of intersections") << QContactFilter((alice & smith) | (phone & collection)) << false << false;
+        QTest::newRow("nested intersections") << QContactFilter(smith & (phone & (collection & smith))) << false << false;
+        QTest::newRow("nested unions") << QContactFilter(alice | (phone | (collection | alice))) << false << false;
+        QTest::newRow("intersection with default") << QContactFilter(QContactFilter() & smith) << false << false;
+        QTest::newRow("intersection of defaults") << QContactFilter(QContactFilter() & QContactFilter()) << true << false;
+        QTest::newRow("intersection with invalid") << QContactFilter(QContactInvalidFilter() & smith) << false << true;
+        QTest::newRow("union with default") << QContactFilter(alice | QContactFilter()) << true << false;
+        QTest::newRow("union with invalid") << QContactFilter(QContactInvalidFilter() | alice) << false << false;
+        QTest::newRow("union of invalids") << QContactFilter(QContactInvalidFilter() | QContactIdFilter()) << false << true;
+        QTest::newRow("union with nested default") << QContactFilter(alice | (phone | QContactFilter())) << true << false;
+        QTest::newRow("intersection with nested invalid") << QContactFilter(smith & (phone & QContactInvalidFilter())) << false << true;
+    }
+}
+
 void tst_QContactFilter::collectionFilter()
 {
     QContactCollectionFilter icf;
@@ -88,6 +88,7 @@ Q_DECLARE_METATYPE(UnsupportedMetatype)
 Q_DECLARE_METATYPE(QContact)
 Q_DECLARE_METATYPE(QContactManager::Error)
 Q_DECLARE_METATYPE(Qt::CaseSensitivity)
+Q_DECLARE_METATYPE(QList<QContactSortOrder>)
 
 class tst_QContactManager : public QObject
 {
@@ -138,6 +139,7 @@ private slots:
     void contactType();
     void lateDeletion();
     void compareVariant();
+    void sortContactsInPlace();
     void createCollection();
     void modifyCollection();
     void removeCollection();
@@ -164,6 +166,7 @@ private slots:
     void uriParsing_data();
     void nameSynthesis_data();
     void compareVariant_data();
+    void sortContactsInPlace_data();
 
     /* Tests that are run on all managers */
     void metadata_data() {addManagers();}
@@ -1520,6 +1523,44 @@ void tst_QContactManager::memoryManager()
     QCOMPARE(m3.contactIds().count(), 0);
     QCOMPARE(m4.contactIds().count(), 0);
     QCOMPARE(m5.contactIds().count(), 0);
+
+    // removing contacts keeps the insertion order of the remaining ones,
+    // both before and after the removed slots are dropped.
+    QContactManager m6("memory");
+    QList<QContact> saved;
+    for (int i = 0; i < 10; ++i) {
+        QContact contact;
+        QContactName name;
+        name.setFirstName(QString::number(i));
+        contact.saveDetail(&name);
+        saved.append(contact);
+    }
+    QVERIFY(m6.saveContacts(&saved));
+    QList<QContactId> expected;
+    foreach (const QContact &contact, saved)
+        expected.append(contact.id());
+
+    foreach (int index, QList<int>() << 0 << 5 << 9 << 2 << 3 << 7 << 8) {
+        QVERIFY(m6.removeContact(saved.at(index).id()));
+        expected.removeOne(saved.at(index).id());
+        QCOMPARE(m6.contactIds(), expected);
+        QList<QContactId> fetched;
+        foreach (const QContact &contact, m6.contacts())
+            fetched.append(contact.id());
+        QCOMPARE(fetched, expected);
+        QContactDetailFilter filter;
+        filter.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+        QCOMPARE(m6.contactIds(filter), expected);
+    }
+
+    QContact added;
+    QContactName addedName;
+    addedName.setFirstName(QStringLiteral("10"));
+    added.saveDetail(&addedName);
+    QVERIFY(m6.saveContact(&added));
+    expected.append(added.id());
+    QCOMPARE(m6.contactIds(), expected);
+    QCOMPARE(m6.contact(saved.at(4).id()).id(), saved.at(4).id());
 }
 
 void tst_QContactManager::overrideManager()
@@ -3162,6 +3203,124 @@ void tst_QContactManager::compareVariant()
     QVERIFY((comparison + expected) == 0);
 }
 
+/* Contacts with case variants, blanks, missing details and ties in the sorted fields */
+static QList<QContact> sortingContacts()
+{
+    const QStringList firstNames = QStringList() << "bob" << "Aaron" << QString() << "aaron" << "Bob" << "carol"
+                                                 << "" << "Aaron" << QString::fromUtf8("\xc3\x89mile") << "emile" << "Zoe" << "bob";
+    const QStringList lastNames = QStringList() << "Smith" << "smith" << QString() << "Jones" << "" << "Smith"
+                                                << "Jones" << "jones" << QString() << "Smith" << "" << "Adams";
+    QList<QContact> contacts;
+    for (int i = 0; i < firstNames.size(); ++i) {
+        QContact contact;
+        if (!firstNames.at(i).isNull() || !lastNames.at(i).isNull()) {
+            QContactName name;
+            if (!firstNames.at(i).isNull())
+                name.setFirstName(firstNames.at(i));
+            if (!lastNames.at(i).isNull())
+                name.setLastName(lastNames.at(i));
+            contact.saveDetail(&name);
+        }
+        if (i % 3) {
+            QContactPresence presence;
+            presence.setPresenceState(static_cast<QContactPresence::PresenceState>(i % 4));
+            contact.saveDetail(&presence);
+        }
+        if (i % 4) {
+            QContactBirthday birthday;
+            birthday.setDate(QDate(1980 + i % 3, 1, 1));
+            contact.saveDetail(&birthday);
+        }
+        QContactTimestamp timestamp;
+        timestamp.setLastModified(QDateTime(QDate(2012, 1, 1 + i % 5), QTime(12, 0), Qt::UTC));
+        contact.saveDetail(&timestamp);
+        QContactGuid guid;
+        guid.setGuid(QString::number(i));
+        contact.saveDetail(&guid);
+        contacts.append(contact);
+    }
+    return contacts;
+}
+
+void tst_QContactManager::sortContactsInPlace()
+{
+    // bulk sorting must give the same order as inserting the contacts one by one
+    QFETCH(QList<QContactSortOrder>, sortOrders);
+
+    const QList<QContact> contacts = sortingContacts();
+    QList<QContact> expected;
+    foreach (const QContact &contact, contacts)
+        QContactManagerEngine::addSorted(&expected, contact, sortOrders);
+
+    QList<QContact> sorted = contacts;
+    QContactManagerEngine::sortContactsInPlace(&sorted, sortOrders);
+
+    QStringList sortedGuids;
+    foreach (const QContact &contact, sorted)
+        sortedGuids.append(contact.detail<QContactGuid>().guid());
+    QStringList expectedGuids;
+    foreach (const QContact &contact, expected)
+        expectedGuids.append(contact.detail<QContactGuid>().guid());
+    QCOMPARE(sortedGuids, expectedGuids);
+}
+
+void tst_QContactManager::sortContactsInPlace_data()
+{
+    QTest::addColumn<QList<QContactSortOrder> >("sortOrders");
+
+    QContactSortOrder firstName;
+    firstName.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+    QContactSortOrder lastName;
+    lastName.setDetailType(QContactName::Type, QContactName::FieldLastName);
+    QContactSortOrder presenceState;
+    presenceState.setDetailType(QContactPresence::Type, QContactPresence::FieldPresenceState);
+    QContactSortOrder presenceDetail;
+    presenceDetail.setDetailType(QContactPresence::Type, -1);
+    QContactSortOrder birthday;
+    birthday.setDetailType(QContactBirthday::Type, QContactBirthday::FieldBirthday);
+    QContactSortOrder lastModified;
+    lastModified.setDetailType(QContactTimestamp::Type, QContactTimestamp::FieldModificationTimestamp);
+
+    QContactSortOrder firstNameSensitive(firstName);
+    firstNameSensitive.setCaseSensitivity(Qt::CaseSensitive);
+    QContactSortOrder firstNameBlanksFirst(firstName);
+    firstNameBlanksFirst.setBlankPolicy(QContactSortOrder::BlanksFirst);
+    QContactSortOrder firstNameDescending(firstName);
+    firstNameDescending.setDirection(Qt::DescendingOrder);
+    QContactSortOrder firstNameSensitiveDescendingBlanksFirst(firstNameSensitive);
+    firstNameSensitiveDescendingBlanksFirst.setDirection(Qt::DescendingOrder);
+    firstNameSensitiveDescendingBlanksFirst.setBlankPolicy(QContactSortOrder::BlanksFirst);
+    QContactSortOrder lastNameSensitiveDescending(lastName);
+    lastNameSensitiveDescending.setCaseSensitivity(Qt::CaseSensitive);
+    lastNameSensitiveDescending.setDirection(Qt::DescendingOrder);
+    QContactSortOrder presenceDetailBlanksFirst(presenceDetail);
+    presenceDetailBlanksFirst.setBlankPolicy(QContactSortOrder::BlanksFirst);
+    QContactSortOrder lastModifiedDescending(lastModified);
+    lastModifiedDescending.setDirection(Qt::DescendingOrder);
+
+    QTest::newRow("first name") << (QList<QContactSortOrder>() << firstName);
+    QTest::newRow("first name, case sensitive") << (QList<QContactSortOrder>() << firstNameSensitive);
+    QTest::newRow("first name, blanks first") << (QList<QContactSortOrder>() << firstNameBlanksFirst);
+    QTest::newRow("first name, descending") << (QList<QContactSortOrder>() << firstNameDescending);
+    QTest::newRow("first name, case sensitive, descending, blanks first")
+            << (QList<QContactSortOrder>() << firstNameSensitiveDescendingBlanksFirst);
+    QTest::newRow("last name, first name") << (QList<QContactSortOrder>() << lastName << firstName);
+    QTest::newRow("last name case sensitive descending, first name blanks first")
+            << (QList<QContactSortOrder>() << lastNameSensitiveDescending << firstNameBlanksFirst);
+    QTest::newRow("presence state, last name, first name")
+            << (QList<QContactSortOrder>() << presenceState << lastName << firstNameSensitive);
+    QTest::newRow("presence detail, first name descending")
+            << (QList<QContactSortOrder>() << presenceDetail << firstNameDescending);
+    QTest::newRow("presence detail blanks first, first name case sensitive")
+            << (QList<QContactSortOrder>() << presenceDetailBlanksFirst << firstNameSensitive);
+    QTest::newRow("birthday, first name") << (QList<QContactSortOrder>() << birthday << firstName);
+    QTest::newRow("last modified descending, last name")
+            << (QList<QContactSortOrder>() << lastModifiedDescending << lastName);
+    QTest::newRow("invalid sort order ends the list")
+            << (QList<QContactSortOrder>() << lastName << QContactSortOrder() << firstName);
+    QTest::newRow("no sort orders") << QList<QContactSortOrder>();
+}
+
 void tst_QContactManager::createCollection()
 {
     QFETCH(QString, uri);
@@ -242,6 +242,20 @@ void tst_QContactManagerFiltering::initTestCase()
             cm = QContactManager::fromUri(mgrUri);
             cm->setObjectName("memory[params]");
             managers.append(cm);
+
+            // the same tests, answered through the field indexes where possible
+            QStringList indexedFields;
+            indexedFields << QString::fromLatin1("%1:%2").arg(QContactName::Type).arg(QContactName::FieldFirstName)
+                          << QString::fromLatin1("%1:%2").arg(QContactName::Type).arg(QContactName::FieldLastName)
+                          << QString::fromLatin1("%1:%2").arg(QContactEmailAddress::Type).arg(QContactEmailAddress::FieldEmailAddress)
+                          << QString::fromLatin1("%1:%2").arg(QContactPhoneNumber::Type).arg(QContactPhoneNumber::FieldNumber)
+                          << QString::fromLatin1("%1:%2").arg(QContactPresence::Type).arg(QContactPresence::FieldPresenceState);
+            params.insert("id", "tst_QContactManagerIndexed");
+            params.insert("fieldIndexes", indexedFields.join(QLatin1Char(',')));
+            mgrUri = QContactManager::buildUri(mgr, params);
+            cm = QContactManager::fromUri(mgrUri);
+            cm->setObjectName("memory[indexed]");
+            managers.append(cm);
         }
     }
 
@@ -20,6 +20,7 @@ OTHER_FILES += \
     testcases/tst_contactdetail.qml \
     testcases/tst_contact_emails.qml \
     testcases/tst_contact_extendeddetails.qml \
+    testcases/tst_contactmodel_paging.qml \
     testcases/tst_contactmodel_signals.qml \
     testcases/tst_contact_modification.qml \
     testcases/tst_contact_organizations.qml \
@@ -0,0 +1,208 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPim module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtContacts 5.0
+
+ContactsSavingTestCase {
+    id: pagedModelTests
+    name: "ContactsPagedModelE2ETests"
+
+    // Qt.UserRole + 500
+    property int contactRole: 756
+
+    ContactModel {
+        id: model
+        manager: getManagerUnderTest()
+        autoUpdate: true
+    }
+
+    ContactModel {
+        id: pagedModel
+        manager: getManagerUnderTest()
+        autoUpdate: true
+        pageSize: 2
+        sortOrders: [
+            SortOrder {
+                detail: ContactDetail.Name
+                field: Name.FirstName
+                direction: Qt.AscendingOrder
+            }
+        ]
+    }
+
+    SignalSpy {
+        id: pagedDataChangedSpy
+        target: pagedModel
+        signalName: "dataChanged"
+    }
+
+    Component {
+        id: pagedViewComponent
+        ListView {
+            width: 100
+            height: 500
+            model: pagedModel
+            delegate: Text {
+                height: 20
+                text: contact ? contact.name.firstName : ""
+            }
+        }
+    }
+
+    Component {
+        id: namedContactComponent
+        Contact {
+            Name {
+                id: contactName
+            }
+            property alias firstName: contactName.firstName
+        }
+    }
+
+    function init() {
+        initTestForModel(model);
+        emptyContacts(model);
+        var names = ["E", "C", "A", "D", "B"];
+        for (var i = 0; i < names.length; i++) {
+            var contact = namedContactComponent.createObject(null, {"firstName": names[i]});
+            model.saveContact(contact);
+            waitForContactsChanged();
+        }
+    }
+
+    function cleanup() {
+        emptyContacts(model);
+    }
+
+    function pagedContactAt(row) {
+        return pagedModel.data(pagedModel.index(row, 0), contactRole);
+    }
+
+    function test_rowsBeforeContacts() {
+        tryCompare(pagedModel, "pageSize", 2);
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+        compare(pagedModel.contacts.length, 0, "contacts.length");
+    }
+
+    function test_contactsFetchedOnDemand() {
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+        var expectedNames = ["A", "B", "C", "D", "E"];
+        for (var row = 0; row < expectedNames.length; row++) {
+            tryVerify(function() { return pagedContactAt(row); }, 5000, "row " + row + " fetched");
+            compare(pagedContactAt(row).name.firstName, expectedNames[row]);
+        }
+    }
+
+    function test_autoUpdate() {
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+        tryVerify(function() { return pagedContactAt(0); });
+        var firstId = pagedContactAt(0).contactId;
+
+        model.removeContact(firstId);
+        tryVerify(function() { return pagedModel.rowCount() === 4; });
+        tryVerify(function() { return pagedContactAt(0); });
+        compare(pagedContactAt(0).name.firstName, "B");
+
+        var contact = namedContactComponent.createObject(null, {"firstName": "AA"});
+        model.saveContact(contact);
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+        tryVerify(function() { return pagedContactAt(0); });
+        compare(pagedContactAt(0).name.firstName, "AA");
+    }
+
+    function rowNotified(spy, row) {
+        for (var i = 0; i < spy.count; i++) {
+            if (spy.signalArguments[i][0].row <= row && spy.signalArguments[i][1].row >= row)
+                return true;
+        }
+        return false;
+    }
+
+    // with a page of one row, only four rows are kept, and the forgotten rows are notified
+    function test_forgottenRowsNotified() {
+        pagedModel.pageSize = 1;
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+        tryVerify(function() { return pagedContactAt(0); }, 5000, "row 0 fetched");
+        pagedDataChangedSpy.clear();
+        for (var row = 1; row < 5; row++)
+            tryVerify(function() { return pagedContactAt(row); }, 5000, "row " + row + " fetched");
+        tryVerify(function() { return rowNotified(pagedDataChangedSpy, 0); }, 5000, "row 0 forgotten");
+
+        // a forgotten row is fetched again when it is needed
+        tryVerify(function() { return pagedContactAt(0); }, 5000, "row 0 fetched again");
+        compare(pagedContactAt(0).name.firstName, "A");
+        pagedModel.pageSize = 2;
+    }
+
+    // a view showing more rows than are kept gets them all, without fetching them again and again
+    function test_moreVisibleRowsThanCached() {
+        pagedModel.pageSize = 1;
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+        var view = pagedViewComponent.createObject(pagedModelTests);
+        tryVerify(function() {
+            for (var row = 0; row < 5; row++) {
+                if (!pagedContactAt(row))
+                    return false;
+            }
+            return true;
+        }, 5000, "all rows fetched");
+        wait(100);
+        pagedDataChangedSpy.clear();
+        wait(500);
+        compare(pagedDataChangedSpy.count, 0, "rows fetched again");
+        view.destroy();
+        pagedModel.pageSize = 2;
+    }
+
+    function test_exportPagedContacts() {
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+        var signalSpy = initTestForTargetListeningToSignal(pagedModel, "exportCompleted");
+        var vcardFilePath = Qt.resolvedUrl("tst_contactmodel_paging_export.vcard");
+        pagedModel.exportContacts(vcardFilePath, ["Sync"]);
+        waitForTargetSignal(signalSpy);
+        compare(signalSpy.signalArguments[0][0], ContactModel.ExportNoError, "exportError");
+
+        emptyContacts(model);
+        listenToContactsChanged();
+        model.importContacts(vcardFilePath, ["Sync"]);
+        waitForContactsChanged();
+        compare(model.contacts.length, 5, "import count");
+    }
+
+    function test_switchingModes() {
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+        pagedModel.pageSize = 0;
+        tryVerify(function() { return pagedModel.contacts.length === 5; });
+        compare(pagedModel.rowCount(), 5);
+        pagedModel.pageSize = 2;
+        compare(pagedModel.contacts.length, 0, "contacts.length");
+        tryVerify(function() { return pagedModel.rowCount() === 5; });
+    }
+}
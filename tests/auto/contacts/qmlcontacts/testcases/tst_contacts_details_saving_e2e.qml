@@ -674,6 +674,24 @@ ContactsSavingTestCase {
         verify(detail.sequenceNumber != undefined)
     }
 
+    EmailAddress {
+        id: emailaddressModified
+        emailAddress: "old@qt.nokia.com"
+    }
+
+    function test_modifyFetchedContact() {
+        contact.addDetail(emailaddressModified)
+        saveAndRefreshContact()
+        var detail = contact.detail(ContactDetail.Email)
+        detail.emailAddress = "new@qt.nokia.com"
+        detail.contexts = [ContactDetail.ContextWork]
+        saveAndRefreshContact()
+        detail = contact.detail(ContactDetail.Email)
+        compare(detail.emailAddress, "new@qt.nokia.com")
+        compare(detail.contexts.length, 1, "contexts length")
+        compare(detail.contexts[0], ContactDetail.ContextWork, "contexts")
+    }
+
     // Init & teardown
 
     function initTestCase() {
@@ -287,6 +287,66 @@ ContactsSavingTestCase {
                                               contactInDescendingOrder2]);
     }
 
+    Contact {
+        id: contactUpdatedInOrder1
+        Name {
+            firstName: "B"
+        }
+    }
+
+    Contact {
+        id: contactUpdatedInOrder2
+        Name {
+            firstName: "D"
+        }
+    }
+
+    Contact {
+        id: contactUpdatedInOrder3
+        Name {
+            firstName: "A"
+        }
+    }
+
+    Contact {
+        id: contactUpdatedInOrder4
+        Name {
+            firstName: "C"
+        }
+    }
+
+    function test_sortOrderKeptOnUpdates()
+    {
+        model.sortOrders = [sortOrderByFirstName];
+        waitUntilContactsChanged();
+
+        model.saveContact(contactUpdatedInOrder1);
+        waitForContactsChanged();
+        model.saveContact(contactUpdatedInOrder2);
+        waitForContactsChanged();
+        model.saveContact(contactUpdatedInOrder3);
+        waitForContactsChanged();
+        model.saveContact(contactUpdatedInOrder4);
+        waitForContactsChanged();
+        compareFirstNames(model.contacts, ["A", "B", "C", "D"]);
+
+        var contact = model.contacts[0];
+        contact.name.firstName = "E";
+        model.saveContact(contact);
+        waitForContactsChanged();
+        compareFirstNames(model.contacts, ["B", "C", "D", "E"]);
+
+        contact = model.contacts[2];
+        contact.name.firstName = "BB";
+        model.saveContact(contact);
+        waitForContactsChanged();
+        compareFirstNames(model.contacts, ["B", "BB", "C", "E"]);
+
+        model.removeContact(model.contacts[1].contactId);
+        waitForContactsChanged();
+        compareFirstNames(model.contacts, ["B", "C", "E"]);
+    }
+
     // Init & teardown
 
     function initTestCase() {
@@ -324,6 +384,13 @@ ContactsSavingTestCase {
         }
     }
 
+    function compareFirstNames(actual, expected) {
+        compare(actual.length, expected.length, "length");
+        for (var i = 0; i < expected.length; i++) {
+            compare(actual[i].name.firstName, expected[i], "index " + i + ": name.firstName");
+        }
+    }
+
     function compareContacts(actual, expected, message) {
         if (expected.name) {
             compare(actual.name.firstName, expected.name.firstName, message + ': name.firstName');
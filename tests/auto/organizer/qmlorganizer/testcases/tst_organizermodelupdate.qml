@@ -1018,8 +1018,233 @@ TestCase {
 
 
 
+    function test_itemsKeptOnUpdate_data() {
+        return [{
+                managers: utility.getManagerList(),
+                definitions: [
+                {
+                    event :
+                    {
+                        "displayLabel" : "recevent1",
+                        "start" : localDateTime('2012-01-01T14:00:00'),
+                        "end" : localDateTime('2012-01-01T15:00:00'),
+                        "recurrenceDates": [],
+                        "exceptionDates": []
+                    },
+                    rrule: {
+                        "frequency": RecurrenceRule.Daily,
+                        "limit": localDate('2012-01-03'),
+                        "interval": 1,
+                        "daysOfWeek": [],
+                        "daysOfMonth": [],
+                        "daysOfYear": [],
+                        "monthsOfYear": [],
+                        "positions": [],
+                        "firstDayOfWeek": Qt.Monday
+                    }
+                },
+                {
+                    event :
+                    {
+                        "displayLabel" : "event1",
+                        "start" : localDateTime('2012-01-02T15:00:00'),
+                        "end" : localDateTime('2012-01-02T16:00:00'),
+                        "recurrenceDates": [],
+                        "exceptionDates": []
+                    }
+                }
+                ],
+                added:
+                {
+                    event :
+                    {
+                        "displayLabel" : "event2",
+                        "start" : localDateTime('2012-01-01T10:00:00'),
+                        "end" : localDateTime('2012-01-01T11:00:00'),
+                        "recurrenceDates": [],
+                        "exceptionDates": []
+                    }
+                }
+        }]
+    }
+
+    // items which are still in the model after an update should keep
+    // their item objects, also generated occurrences
+    function test_itemsKeptOnUpdate(data) {
+        var j = 0;
+        for (var i in data.managers) {
+            console.log("Testing "+data.managers[i]+" backend")
+            model.manager = data.managers[i];
+            model.startPeriod = localDate('2011-12-01');
+            model.endPeriod = localDate('2012-04-30');
+            model.autoUpdate = true;
+            spyManagerChanged.wait(spyWaitDelay)
+            cleanDatabase();
+            compare(model.itemCount, 0, "Model not empty")
+            for (j = 0; j < data.definitions.length; j++) {
+                model.saveItem(createTestItemFromData(data.definitions[j]));
+                modelChangedSpy.wait(spyWaitDelay)
+            }
+            compare(model.itemCount, 4, "Item count is wrong.")
+            var oldItems = [];
+            for (j = 0; j < model.itemCount; j++)
+                oldItems.push(model.items[j]);
+
+            // new item is inserted in front of the old ones
+            model.saveItem(createTestItemFromData(data.added));
+            modelChangedSpy.wait(spyWaitDelay)
+            compare(model.itemCount, 5, "Item count is wrong.")
+            compare(model.items[0].displayLabel, "event2");
+            for (j = 0; j < oldItems.length; j++)
+                verify(model.items[j + 1] === oldItems[j], "Item object not kept at " + (j + 1));
+
+            // modified item keeps its object and gets the new data
+            var modified = model.items[3];
+            compare(modified.displayLabel, "event1");
+            modified.displayLabel = "modifiedevent1";
+            model.saveItem(modified);
+            modelChangedSpy.wait(spyWaitDelay)
+            verify(model.items[3] === oldItems[2], "Modified item object not kept");
+            compare(model.items[3].displayLabel, "modifiedevent1");
+            verify(model.items[2] === oldItems[1], "Occurrence object not kept");
+
+            cleanDatabase();
+            compare(model.itemCount, 0, "Model not empty")
+        }
+    }
+
+    function test_movePeriod_data() {
+        return [
+            {tag: "no prefetch", prefetchPeriods: 0},
+            {tag: "prefetch", prefetchPeriods: 1}
+        ]
+    }
+
+    // move the model period a week at a time back and forth, also after adding
+    // an item to the prefetched period and an exception occurrence spanning two
+    // weeks, and check the correct items are in model
+    function test_movePeriod(data) {
+        var managers = utility.getManagerList();
+        for (var i in managers) {
+            console.log("Testing "+managers[i]+" backend")
+            model.manager = managers[i];
+            model.prefetchPeriods = 0;
+            model.startPeriod = localDate('2012-01-01');
+            model.endPeriod = localDate('2012-01-08');
+            model.autoUpdate = true;
+            spyManagerChanged.wait(spyWaitDelay)
+            cleanDatabase();
+            compare(model.itemCount, 0, "Model not empty")
+
+            model.saveItem(createTestItemFromData({
+                event: {
+                    "displayLabel" : "recevent1",
+                    "start" : localDateTime('2012-01-01T14:00:00'),
+                    "end" : localDateTime('2012-01-01T15:00:00'),
+                    "recurrenceDates": [],
+                    "exceptionDates": []
+                },
+                rrule: {
+                    "frequency": RecurrenceRule.Daily,
+                    "limit": localDate('2012-01-20'),
+                    "interval": 1,
+                    "daysOfWeek": [],
+                    "daysOfMonth": [],
+                    "daysOfYear": [],
+                    "monthsOfYear": [],
+                    "positions": [],
+                    "firstDayOfWeek": Qt.Monday
+                }
+            }));
+            modelChangedSpy.wait(spyWaitDelay)
+            model.saveItem(createTestEventOnDay("event1", 5));
+            modelChangedSpy.wait(spyWaitDelay)
+            model.saveItem(createTestEventOnDay("event2", 12));
+            wait(spyWaitDelay)
+            compareResultDatesToModel(periodResults(1, 7, 4, "event1", 5), model);
+
+            model.prefetchPeriods = data.prefetchPeriods;
+            wait(spyWaitDelay)
+            compareResultDatesToModel(periodResults(1, 7, 4, "event1", 5), model);
+
+            modelChangedSpy.clear();
+            model.startPeriod = localDate('2012-01-08');
+            model.endPeriod = localDate('2012-01-15');
+            modelChangedSpy.wait(spyWaitDelay)
+            compareResultDatesToModel(periodResults(8, 7, 4, "event2", 12), model);
+
+            modelChangedSpy.clear();
+            model.startPeriod = localDate('2012-01-01');
+            model.endPeriod = localDate('2012-01-08');
+            modelChangedSpy.wait(spyWaitDelay)
+            compareResultDatesToModel(periodResults(1, 7, 4, "event1", 5), model);
+
+            // the item added after the week is prefetched must be in model after moving there
+            model.startPeriod = localDate('2012-01-08');
+            model.endPeriod = localDate('2012-01-15');
+            modelChangedSpy.wait(spyWaitDelay)
+            model.saveItem(createTestEventOnDay("event3", 20));
+            wait(spyWaitDelay)
+            compareResultDatesToModel(periodResults(8, 7, 4, "event2", 12), model);
+
+            // an exception occurrence straddling the end of the week is in both weeks
+            var xoccurrence = model.items[7];
+            xoccurrence.startDateTime = localDateTime('2012-01-14T23:30:00');
+            xoccurrence.endDateTime = localDateTime('2012-01-15T00:30:00');
+            modelChangedSpy.clear();
+            model.saveItem(xoccurrence);
+            modelChangedSpy.wait(spyWaitDelay)
+            var exception = {label: "recevent1", start: localDateTime('2012-01-14T23:30:00')};
+            var secondWeek = periodResults(8, 7, 4, "event2", 12);
+            secondWeek[7] = exception;
+            compareResultDatesToModel(secondWeek, model);
+
+            modelChangedSpy.clear();
+            model.startPeriod = localDate('2012-01-15');
+            model.endPeriod = localDate('2012-01-22');
+            modelChangedSpy.wait(spyWaitDelay)
+            var thirdWeek = periodResults(15, 6, 5, "event3", 20);
+            thirdWeek.unshift(exception);
+            compareResultDatesToModel(thirdWeek, model);
+
+            modelChangedSpy.clear();
+            model.startPeriod = localDate('2012-01-08');
+            model.endPeriod = localDate('2012-01-15');
+            modelChangedSpy.wait(spyWaitDelay)
+            compareResultDatesToModel(secondWeek, model);
+
+            model.prefetchPeriods = 0;
+            model.startPeriod = localDate('2011-12-01');
+            model.endPeriod = localDate('2012-01-31');
+            wait(spyWaitDelay)
+            cleanDatabase();
+            compare(model.itemCount, 0, "Model not empty")
+        }
+    }
+
     // Helper functions
 
+    function createTestEventOnDay(label, day) {
+        var testEvent = Qt.createQmlObject("import QtOrganizer 5.0; Event { }", test);
+        testEvent.displayLabel = label;
+        testEvent.startDateTime = localDateTime(januaryDay(day) + 'T10:00:00');
+        testEvent.endDateTime = localDateTime(januaryDay(day) + 'T11:00:00');
+        return testEvent;
+    }
+
+    function januaryDay(day) {
+        return '2012-01-' + (day < 10 ? '0' : '') + day;
+    }
+
+    // daily occurrences of recevent1 from the first day on, with a single event at the given index
+    function periodResults(firstDay, days, eventIndex, eventLabel, eventDay) {
+        var results = [];
+        for (var day = firstDay; day < firstDay + days; day++)
+            results.push({label: "recevent1", start: localDateTime(januaryDay(day) + 'T14:00:00')});
+        results.splice(eventIndex, 0, {label: eventLabel, start: localDateTime(januaryDay(eventDay) + 'T10:00:00')});
+        return results;
+    }
+
     function cleanDatabase() {
         var ids = [];
         var removeIds = [];
@@ -1,6 +1,6 @@
 include(../../auto.pri)
 
-QT += organizer
+QT += organizer organizer-private
 
 SOURCES  += tst_qorganizeritemfilter.cpp
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
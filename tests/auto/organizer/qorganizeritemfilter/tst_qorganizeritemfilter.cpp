@@ -29,6 +29,7 @@
 #include <QtCore/QMetaType>
 
 #include <QtOrganizer/qorganizer.h>
+#include <QtOrganizer/private/qorganizeritemfilterprogram_p.h>
 
 //TESTED_COMPONENT=src/organizer
 
@@ -76,6 +77,8 @@ private slots:
     void canonicalizedFilter_data();
     void testFilter();
     void testFilter_data();
+    void filterProgram();
+    void filterProgram_data();
 
     void datastream();
     void datastream_data();
@@ -1078,6 +1081,195 @@ void tst_QOrganizerItemFilter::testFilter_data()
     }
 }
 
+static QList<QOrganizerItem> filterProgramItems()
+{
+    QList<QOrganizerItem> items;
+    items.append(QOrganizerItem());
+
+    {
+        QOrganizerEvent event;
+        event.setId(makeItemId(1));
+        event.setCollectionId(makeCollectionId(1));
+        event.setDisplayLabel(QStringLiteral("Team Meeting"));
+        event.setDescription(QStringLiteral("weekly sync"));
+        event.setLocation(QStringLiteral("Room 101"));
+        event.setPriority(QOrganizerItemPriority::HighPriority);
+        event.setStartDateTime(QDateTime(QDate(2020, 3, 2), QTime(10, 0)));
+        event.setEndDateTime(QDateTime(QDate(2020, 3, 2), QTime(11, 0)));
+        items.append(event);
+    }
+
+    {
+        QOrganizerTodo todo;
+        todo.setId(makeItemId(2));
+        todo.setCollectionId(makeCollectionId(2));
+        todo.setDisplayLabel(QStringLiteral("meeting notes"));
+        todo.setPriority(QOrganizerItemPriority::LowPriority);
+        todo.setDueDateTime(QDateTime(QDate(2020, 3, 9), QTime(9, 0)));
+        items.append(todo);
+    }
+
+    {
+        QOrganizerNote note;
+        note.setId(makeItemId(3));
+        note.setDescription(QString());
+        items.append(note);
+    }
+
+    return items;
+}
+
+void tst_QOrganizerItemFilter::filterProgram()
+{
+    QFETCH(QOrganizerItemFilter, filter);
+    QFETCH(bool, matchesAll);
+    QFETCH(bool, matchesNone);
+
+    const QOrganizerItemFilterProgram program(filter);
+    QCOMPARE(program.matchesAll(), matchesAll);
+    QCOMPARE(program.matchesNone(), matchesNone);
+
+    // the program has to give the same result as testFilter() for every item
+    foreach (const QOrganizerItem &item, filterProgramItems()) {
+        const bool expected = QOrganizerManagerEngine::testFilter(filter, item);
+        QCOMPARE(program.matches(item), expected);
+        if (matchesAll)
+            QVERIFY(expected);
+        if (matchesNone)
+            QVERIFY(!expected);
+    }
+}
+
+void tst_QOrganizerItemFilter::filterProgram_data()
+{
+    QTest::addColumn<QOrganizerItemFilter>("filter");
+    QTest::addColumn<bool>("matchesAll");
+    QTest::addColumn<bool>("matchesNone");
+
+    QTest::newRow("default") << QOrganizerItemFilter() << true << false;
+    QTest::newRow("invalid") << QOrganizerItemFilter(QOrganizerItemInvalidFilter()) << false << true;
+
+    {
+        QOrganizerItemIdFilter idf;
+        QTest::newRow("id empty") << QOrganizerItemFilter(idf) << false << true;
+        idf.setIds(QList<QOrganizerItemId>() << makeItemId(1) << makeItemId(3));
+        QTest::newRow("id") << QOrganizerItemFilter(idf) << false << false;
+    }
+
+    {
+        QOrganizerItemCollectionFilter cf;
+        QTest::newRow("collection empty") << QOrganizerItemFilter(cf) << false << true;
+        cf.setCollectionId(makeCollectionId(2));
+        QTest::newRow("collection") << QOrganizerItemFilter(cf) << false << false;
+    }
+
+    {
+        QOrganizerItemDetailFilter df;
+        QTest::newRow("detail empty") << QOrganizerItemFilter(df) << false << true;
+        QOrganizerItemLocation location;
+        location.setLabel(QStringLiteral("Room 101"));
+        df.setDetail(location);
+        QTest::newRow("detail") << QOrganizerItemFilter(df) << false << false;
+        location.setLabel(QStringLiteral("room 101"));
+        df.setDetail(location);
+        QTest::newRow("detail case differs") << QOrganizerItemFilter(df) << false << false;
+    }
+
+    {
+        QOrganizerItemDetailFieldFilter df;
+        QTest::newRow("field undefined type") << QOrganizerItemFilter(df) << false << true;
+        df.setDetail(QOrganizerItemDetail::TypeDescription);
+        QTest::newRow("field detail presence") << QOrganizerItemFilter(df) << false << false;
+        df.setDetail(QOrganizerItemDetail::TypeDescription, QOrganizerItemDescription::FieldDescription);
+        QTest::newRow("field presence") << QOrganizerItemFilter(df) << false << false;
+        df.setDetail(QOrganizerItemDetail::TypePriority, QOrganizerItemPriority::FieldPriority);
+        df.setValue(QOrganizerItemPriority::HighPriority);
+        QTest::newRow("field variant") << QOrganizerItemFilter(df) << false << false;
+    }
+
+    // string matching with every match type and case sensitivity
+    const QList<QPair<QByteArray, QOrganizerItemFilter::MatchFlags> > stringFlags = QList<QPair<QByteArray, QOrganizerItemFilter::MatchFlags> >()
+            << qMakePair(QByteArray("exactly"), QOrganizerItemFilter::MatchFlags(QOrganizerItemFilter::MatchExactly))
+            << qMakePair(QByteArray("fixed string"), QOrganizerItemFilter::MatchFlags(QOrganizerItemFilter::MatchFixedString))
+            << qMakePair(QByteArray("fixed string case sensitive"), QOrganizerItemFilter::MatchFixedString | QOrganizerItemFilter::MatchCaseSensitive)
+            << qMakePair(QByteArray("contains"), QOrganizerItemFilter::MatchFlags(QOrganizerItemFilter::MatchContains))
+            << qMakePair(QByteArray("contains case sensitive"), QOrganizerItemFilter::MatchContains | QOrganizerItemFilter::MatchCaseSensitive)
+            << qMakePair(QByteArray("starts with"), QOrganizerItemFilter::MatchFlags(QOrganizerItemFilter::MatchStartsWith))
+            << qMakePair(QByteArray("ends with"), QOrganizerItemFilter::MatchFlags(QOrganizerItemFilter::MatchEndsWith))
+            << qMakePair(QByteArray("ends with case sensitive"), QOrganizerItemFilter::MatchEndsWith | QOrganizerItemFilter::MatchCaseSensitive);
+    const QStringList needles = QStringList() << QStringLiteral("team meeting") << QStringLiteral("Meeting")
+                                              << QStringLiteral("meet") << QStringLiteral("NOTES");
+    for (int i = 0; i < stringFlags.size(); ++i) {
+        foreach (const QString &needle, needles) {
+            QOrganizerItemDetailFieldFilter df;
+            df.setDetail(QOrganizerItemDetail::TypeDisplayLabel, QOrganizerItemDisplayLabel::FieldLabel);
+            df.setMatchFlags(stringFlags.at(i).second);
+            df.setValue(needle);
+            QTest::newRow(QByteArray("label " + stringFlags.at(i).first + " " + needle.toUtf8()).constData())
+                    << QOrganizerItemFilter(df) << false << false;
+        }
+    }
+
+    {
+        QOrganizerItemDetailRangeFilter rf;
+        QTest::newRow("range undefined type") << QOrganizerItemFilter(rf) << false << true;
+        rf.setDetail(QOrganizerItemDetail::TypeEventTime);
+        QTest::newRow("range detail presence") << QOrganizerItemFilter(rf) << false << false;
+        rf.setDetail(QOrganizerItemDetail::TypeEventTime, QOrganizerEventTime::FieldStartDateTime);
+        QTest::newRow("range field presence") << QOrganizerItemFilter(rf) << false << false;
+
+        rf.setRange(QDateTime(QDate(2020, 3, 1), QTime(0, 0)), QDateTime(QDate(2020, 3, 2), QTime(10, 0)));
+        QTest::newRow("range variant") << QOrganizerItemFilter(rf) << false << false;
+        rf.setRange(QDateTime(QDate(2020, 3, 1), QTime(0, 0)), QDateTime(QDate(2020, 3, 2), QTime(10, 0)),
+                    QOrganizerItemDetailRangeFilter::ExcludeLower | QOrganizerItemDetailRangeFilter::IncludeUpper);
+        QTest::newRow("range variant include upper") << QOrganizerItemFilter(rf) << false << false;
+        rf.setRange(QDateTime(QDate(2020, 3, 2), QTime(10, 0)), QVariant(), QOrganizerItemDetailRangeFilter::ExcludeLower);
+        QTest::newRow("range variant exclude lower minimum") << QOrganizerItemFilter(rf) << false << false;
+
+        rf.setDetail(QOrganizerItemDetail::TypeDisplayLabel, QOrganizerItemDisplayLabel::FieldLabel);
+        rf.setMatchFlags(QOrganizerItemFilter::MatchFixedString);
+        rf.setRange(QStringLiteral("a"), QStringLiteral("n"));
+        QTest::newRow("range string") << QOrganizerItemFilter(rf) << false << false;
+        rf.setMatchFlags(QOrganizerItemFilter::MatchFixedString | QOrganizerItemFilter::MatchCaseSensitive);
+        rf.setRange(QVariant(), QStringLiteral("n"), QOrganizerItemDetailRangeFilter::IncludeUpper);
+        QTest::newRow("range string case sensitive maximum") << QOrganizerItemFilter(rf) << false << false;
+        rf.setMatchFlags(QOrganizerItemFilter::MatchContains);
+        rf.setRange(QStringLiteral("a"), QStringLiteral("n"));
+        QTest::newRow("range string contains") << QOrganizerItemFilter(rf) << false << true;
+    }
+
+    {
+        QOrganizerItemDetailFieldFilter meeting;
+        meeting.setDetail(QOrganizerItemDetail::TypeDisplayLabel, QOrganizerItemDisplayLabel::FieldLabel);
+        meeting.setMatchFlags(QOrganizerItemFilter::MatchContains);
+        meeting.setValue(QStringLiteral("meeting"));
+        QOrganizerItemDetailFieldFilter high;
+        high.setDetail(QOrganizerItemDetail::TypePriority, QOrganizerItemPriority::FieldPriority);
+        high.setValue(QOrganizerItemPriority::HighPriority);
+        QOrganizerItemCollectionFilter collection;
+        collection.setCollectionId(makeCollectionId(2));
+        QOrganizerItemIdFilter ids;
+        ids.setIds(QList<QOrganizerItemId>() << makeItemId(3));
+
+        QTest::newRow("intersection empty") << QOrganizerItemFilter(QOrganizerItemIntersectionFilter()) << false << true;
+        QTest::newRow("union empty") << QOrganizerItemFilter(QOrganizerItemUnionFilter()) << false << true;
+        QTest::newRow("intersection") << QOrganizerItemFilter(meeting & high) << false << false;
+        QTest::newRow("union") << QOrganizerItemFilter(high | ids) << false << false;
+        QTest::newRow("intersection of unions") << QOrganizerItemFilter((high | collection) & (meeting | ids)) << false << false;
+        QTest::newRow("union of intersections") << QOrganizerItemFilter((meeting & high) | (meeting & collection)) << false << false;
+        QTest::newRow("nested intersections") << QOrganizerItemFilter(meeting & (collection & (meeting & collection))) << false << false;
+        QTest::newRow("nested unions") << QOrganizerItemFilter(ids | (high | (collection | ids))) << false << false;
+        QTest::newRow("intersection with default") << QOrganizerItemFilter(QOrganizerItemFilter() & meeting) << false << false;
+        QTest::newRow("intersection of defaults") << QOrganizerItemFilter(QOrganizerItemFilter() & QOrganizerItemFilter()) << true << false;
+        QTest::newRow("intersection with invalid") << QOrganizerItemFilter(QOrganizerItemInvalidFilter() & meeting) << false << true;
+        QTest::newRow("union with default") << QOrganizerItemFilter(ids | QOrganizerItemFilter()) << true << false;
+        QTest::newRow("union with invalid") << QOrganizerItemFilter(QOrganizerItemInvalidFilter() | ids) << false << false;
+        QTest::newRow("union of invalids") << QOrganizerItemFilter(QOrganizerItemInvalidFilter() | QOrganizerItemIdFilter()) << false << true;
+        QTest::newRow("union with nested default") << QOrganizerItemFilter(ids | (high | QOrganizerItemFilter())) << true << false;
+        QTest::newRow("intersection with nested invalid") << QOrganizerItemFilter(meeting & (high & QOrganizerItemInvalidFilter())) << false << true;
+    }
+}
+
 void tst_QOrganizerItemFilter::datastream()
 {
     QFETCH(QOrganizerItemFilter, filterIn);
@@ -55,6 +55,7 @@ Q_DECLARE_METATYPE(QOrganizerItem)
 Q_DECLARE_METATYPE(QOrganizerManager::Error)
 Q_DECLARE_METATYPE(QList<QDate>)
 Q_DECLARE_METATYPE(QList<QOrganizerItemDetail::DetailType>);
+Q_DECLARE_METATYPE(QList<QOrganizerItemSortOrder>)
 
 static inline QOrganizerItemId makeItemId(uint id)
 {
@@ -128,6 +129,7 @@ private slots:
     void itemFetchV2();
     void itemFilterFetch();
     void spanOverDays();
+    void dateRangeAfterChanges();
     void incompleteTodoTime();
     void recurrence();
     void idComparison();
@@ -147,12 +149,14 @@ private slots:
     void testNestCompoundFilter();
     void testUnionFilter();
     void testItemOccurrences();
+    void sortItemsInPlace();
 
     /* Special test with special data */
     void uriParsing_data();
     void recurrenceWithGenerator_data();
     void todoRecurrenceWithGenerator_data();
     void dateRange_data();
+    void sortItemsInPlace_data();
     /* Tests that are run on all managers */
     void metadata_data() {addManagers();}
     void nullIdOperations_data() {addManagers();}
@@ -175,6 +179,7 @@ private slots:
     void itemFetchV2_data() {addManagers();}
     void itemFilterFetch_data() {addManagers();}
     void spanOverDays_data() {addManagers();}
+    void dateRangeAfterChanges_data() {addManagers();}
     void incompleteTodoTime_data() {addManagers();}
     void recurrence_data() {addManagers();}
     void idComparison_data() {addManagers();}
@@ -1169,6 +1174,106 @@ void tst_QOrganizerManager::testItemOccurrences()
     QCOMPARE (items6.size (), 0);
 }
 
+/* Items with case variants, blanks, missing details and ties in the sorted fields */
+static QList<QOrganizerItem> sortingItems()
+{
+    const QStringList labels = QStringList() << "bob" << "Aaron" << QString() << "aaron" << "Bob" << "carol"
+                                             << "" << "Aaron" << QString::fromUtf8("\xc3\x89mile") << "emile" << "Zoe" << "bob";
+    const QStringList descriptions = QStringList() << "Smith" << "smith" << QString() << "Jones" << "" << "Smith"
+                                                   << "Jones" << "jones" << QString() << "Smith" << "" << "Adams";
+    QList<QOrganizerItem> items;
+    for (int i = 0; i < labels.size(); ++i) {
+        QOrganizerEvent event;
+        if (!labels.at(i).isNull())
+            event.setDisplayLabel(labels.at(i));
+        if (!descriptions.at(i).isNull())
+            event.setDescription(descriptions.at(i));
+        if (i % 3)
+            event.setPriority(static_cast<QOrganizerItemPriority::Priority>(i % 4));
+        if (i % 4)
+            event.setStartDateTime(QDateTime(QDate(2012, 1, 1 + i % 3), QTime(12, 0), Qt::UTC));
+        event.setGuid(QString::number(i));
+        items.append(event);
+    }
+    return items;
+}
+
+void tst_QOrganizerManager::sortItemsInPlace()
+{
+    // bulk sorting must give the same order as inserting the items one by one
+    QFETCH(QList<QOrganizerItemSortOrder>, sortOrders);
+
+    const QList<QOrganizerItem> items = sortingItems();
+    QList<QOrganizerItem> expected;
+    foreach (const QOrganizerItem &item, items)
+        QOrganizerManagerEngine::addSorted(&expected, item, sortOrders);
+
+    QList<QOrganizerItem> sorted = items;
+    QOrganizerManagerEngine::sortItemsInPlace(&sorted, sortOrders);
+
+    QStringList sortedGuids;
+    foreach (const QOrganizerItem &item, sorted)
+        sortedGuids.append(item.guid());
+    QStringList expectedGuids;
+    foreach (const QOrganizerItem &item, expected)
+        expectedGuids.append(item.guid());
+    QCOMPARE(sortedGuids, expectedGuids);
+}
+
+void tst_QOrganizerManager::sortItemsInPlace_data()
+{
+    QTest::addColumn<QList<QOrganizerItemSortOrder> >("sortOrders");
+
+    QOrganizerItemSortOrder label;
+    label.setDetail(QOrganizerItemDetail::TypeDisplayLabel, QOrganizerItemDisplayLabel::FieldLabel);
+    QOrganizerItemSortOrder description;
+    description.setDetail(QOrganizerItemDetail::TypeDescription, QOrganizerItemDescription::FieldDescription);
+    QOrganizerItemSortOrder priority;
+    priority.setDetail(QOrganizerItemDetail::TypePriority, QOrganizerItemPriority::FieldPriority);
+    QOrganizerItemSortOrder priorityDetail;
+    priorityDetail.setDetail(QOrganizerItemDetail::TypePriority, -1);
+    QOrganizerItemSortOrder startTime;
+    startTime.setDetail(QOrganizerItemDetail::TypeEventTime, QOrganizerEventTime::FieldStartDateTime);
+
+    QOrganizerItemSortOrder labelSensitive(label);
+    labelSensitive.setCaseSensitivity(Qt::CaseSensitive);
+    QOrganizerItemSortOrder labelBlanksFirst(label);
+    labelBlanksFirst.setBlankPolicy(QOrganizerItemSortOrder::BlanksFirst);
+    QOrganizerItemSortOrder labelDescending(label);
+    labelDescending.setDirection(Qt::DescendingOrder);
+    QOrganizerItemSortOrder labelSensitiveDescendingBlanksFirst(labelSensitive);
+    labelSensitiveDescendingBlanksFirst.setDirection(Qt::DescendingOrder);
+    labelSensitiveDescendingBlanksFirst.setBlankPolicy(QOrganizerItemSortOrder::BlanksFirst);
+    QOrganizerItemSortOrder descriptionSensitiveDescending(description);
+    descriptionSensitiveDescending.setCaseSensitivity(Qt::CaseSensitive);
+    descriptionSensitiveDescending.setDirection(Qt::DescendingOrder);
+    QOrganizerItemSortOrder priorityDetailBlanksFirst(priorityDetail);
+    priorityDetailBlanksFirst.setBlankPolicy(QOrganizerItemSortOrder::BlanksFirst);
+    QOrganizerItemSortOrder startTimeDescending(startTime);
+    startTimeDescending.setDirection(Qt::DescendingOrder);
+
+    QTest::newRow("label") << (QList<QOrganizerItemSortOrder>() << label);
+    QTest::newRow("label, case sensitive") << (QList<QOrganizerItemSortOrder>() << labelSensitive);
+    QTest::newRow("label, blanks first") << (QList<QOrganizerItemSortOrder>() << labelBlanksFirst);
+    QTest::newRow("label, descending") << (QList<QOrganizerItemSortOrder>() << labelDescending);
+    QTest::newRow("label, case sensitive, descending, blanks first")
+            << (QList<QOrganizerItemSortOrder>() << labelSensitiveDescendingBlanksFirst);
+    QTest::newRow("description, label") << (QList<QOrganizerItemSortOrder>() << description << label);
+    QTest::newRow("description case sensitive descending, label blanks first")
+            << (QList<QOrganizerItemSortOrder>() << descriptionSensitiveDescending << labelBlanksFirst);
+    QTest::newRow("priority, description, label")
+            << (QList<QOrganizerItemSortOrder>() << priority << description << labelSensitive);
+    QTest::newRow("priority detail, label descending")
+            << (QList<QOrganizerItemSortOrder>() << priorityDetail << labelDescending);
+    QTest::newRow("priority detail blanks first, label case sensitive")
+            << (QList<QOrganizerItemSortOrder>() << priorityDetailBlanksFirst << labelSensitive);
+    QTest::newRow("start time descending, description")
+            << (QList<QOrganizerItemSortOrder>() << startTimeDescending << description);
+    QTest::newRow("invalid sort order ends the list")
+            << (QList<QOrganizerItemSortOrder>() << description << QOrganizerItemSortOrder() << label);
+    QTest::newRow("no sort orders") << QList<QOrganizerItemSortOrder>();
+}
+
 void tst_QOrganizerManager::addExceptionsWithGuid()
 {
     // It should be possible to save an exception that has at least an originalDate and either a
@@ -3576,6 +3681,65 @@ void tst_QOrganizerManager::spanOverDays()
 }
 
 
+void tst_QOrganizerManager::dateRangeAfterChanges()
+{
+    QFETCH(QString, uri);
+    QScopedPointer<QOrganizerManager> cm(QOrganizerManager::fromUri(uri));
+
+    cm->removeItems(cm->itemIds()); // empty the calendar to prevent the previous test from interfering this one
+
+    QOrganizerEvent shortEvent;
+    shortEvent.setDisplayLabel("short event");
+    shortEvent.setStartDateTime(QDateTime(QDate(2011, 1, 10), QTime(10, 0, 0)));
+    shortEvent.setEndDateTime(QDateTime(QDate(2011, 1, 10), QTime(11, 0, 0)));
+    QVERIFY(cm->saveItem(&shortEvent));
+
+    QOrganizerEvent longEvent;
+    longEvent.setDisplayLabel("long event");
+    longEvent.setStartDateTime(QDateTime(QDate(2011, 1, 1), QTime(10, 0, 0)));
+    longEvent.setEndDateTime(QDateTime(QDate(2011, 1, 21), QTime(10, 0, 0)));
+    QVERIFY(cm->saveItem(&longEvent));
+
+    QOrganizerEvent recurringEvent;
+    QOrganizerRecurrenceRule rrule;
+    recurringEvent.setDisplayLabel("weekly event");
+    recurringEvent.setStartDateTime(QDateTime(QDate(2010, 12, 6), QTime(12, 0, 0)));
+    recurringEvent.setEndDateTime(QDateTime(QDate(2010, 12, 6), QTime(13, 0, 0)));
+    rrule.setFrequency(QOrganizerRecurrenceRule::Weekly);
+    recurringEvent.setRecurrenceRule(rrule);
+    QVERIFY(cm->saveItem(&recurringEvent));
+
+    // the long event spans the whole period, the others happen on Mondays
+    QList<QOrganizerItem> items = cm->items(QDate(2011, 1, 15).startOfDay(), QDate(2011, 1, 15).endOfDay());
+    QCOMPARE(items.count(), 1);
+    QCOMPARE(items.first().id(), longEvent.id());
+
+    items = cm->items(QDate(2011, 1, 10).startOfDay(), QDate(2011, 1, 10).endOfDay());
+    QCOMPARE(items.count(), 3);
+
+    // moving an item moves it out of the queried periods
+    shortEvent.setStartDateTime(QDateTime(QDate(2011, 2, 1), QTime(10, 0, 0)));
+    shortEvent.setEndDateTime(QDateTime(QDate(2011, 2, 1), QTime(11, 0, 0)));
+    QVERIFY(cm->saveItem(&shortEvent));
+    items = cm->items(QDate(2011, 1, 10).startOfDay(), QDate(2011, 1, 10).endOfDay());
+    QCOMPARE(items.count(), 2);
+    items = cm->items(QDate(2011, 2, 1).startOfDay(), QDate(2011, 2, 1).endOfDay());
+    QCOMPARE(items.count(), 1);
+    QCOMPARE(items.first().id(), shortEvent.id());
+    QCOMPARE(cm->itemIds(QDate(2011, 2, 1).startOfDay(), QDate(2011, 2, 1).endOfDay()), QList<QOrganizerItemId>() << shortEvent.id());
+
+    // and removed items are not found any more
+    QVERIFY(cm->removeItem(longEvent.id()));
+    items = cm->items(QDate(2011, 1, 15).startOfDay(), QDate(2011, 1, 15).endOfDay());
+    QCOMPARE(items.count(), 0);
+
+    // an unbounded recurrence is found however far in the future the period is
+    items = cm->items(QDate(2031, 1, 6).startOfDay(), QDate(2031, 1, 6).endOfDay());
+    QCOMPARE(items.count(), 1);
+
+    cm->removeItems(cm->itemIds());
+}
+
 void tst_QOrganizerManager::incompleteTodoTime()
 {
     QFETCH(QString, uri);
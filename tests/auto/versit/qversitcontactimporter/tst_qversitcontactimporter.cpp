@@ -1812,6 +1812,46 @@ void tst_QVersitContactImporter::testInvalidDocument()
 
 }
 
+void tst_QVersitContactImporter::testConcurrentImport()
+{
+    QList<QVersitDocument> documents;
+    for (int i = 0; i < 1000; i++) {
+        QVersitDocument document(i % 97 == 0 ? QVersitDocument::InvalidType
+                                             : QVersitDocument::VCard30Type);
+        if (i % 89 != 0) {
+            QVersitProperty nameProperty;
+            nameProperty.setName(QStringLiteral("FN"));
+            nameProperty.setValue(QStringLiteral("John ") + QString::number(i));
+            document.addProperty(nameProperty);
+            QVersitProperty telProperty;
+            telProperty.setName(QStringLiteral("TEL"));
+            telProperty.setValue(QString::number(i));
+            document.addProperty(telProperty);
+        }
+        documents.append(document);
+    }
+
+    QVersitContactImporter serialImporter;
+    QCOMPARE(serialImporter.maxThreadCount(), 1);
+    QVERIFY(!serialImporter.importDocuments(documents));
+
+    QVersitContactImporter concurrentImporter;
+    concurrentImporter.setMaxThreadCount(4);
+    QCOMPARE(concurrentImporter.maxThreadCount(), 4);
+    QVERIFY(!concurrentImporter.importDocuments(documents));
+
+    QCOMPARE(concurrentImporter.errorMap(), serialImporter.errorMap());
+    QList<QContact> expected = serialImporter.contacts();
+    QList<QContact> contacts = concurrentImporter.contacts();
+    QCOMPARE(contacts.size(), expected.size());
+    for (int i = 0; i < contacts.size(); i++) {
+        QCOMPARE(contacts.at(i).detail<QContactDisplayLabel>().label(),
+                 expected.at(i).detail<QContactDisplayLabel>().label());
+        QCOMPARE(contacts.at(i).detail<QContactPhoneNumber>().number(),
+                 expected.at(i).detail<QContactPhoneNumber>().number());
+    }
+}
+
 void tst_QVersitContactImporter::testEmailWithContextOther()
 {
     QVersitProperty property;
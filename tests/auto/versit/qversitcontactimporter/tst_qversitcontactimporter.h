@@ -93,6 +93,7 @@ private slots: // Tests
     void testPref();
     void testPropertyHandler();
     void testInvalidDocument();
+    void testConcurrentImport();
     void testEmailWithContextOther();
 
 private: // Utilities
@@ -0,0 +1,6 @@
+include(../../auto.pri)
+
+QT += contacts versit versit-private
+
+HEADERS += tst_qversitcontactingester.h
+SOURCES += tst_qversitcontactingester.cpp
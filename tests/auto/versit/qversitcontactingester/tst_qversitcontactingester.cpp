@@ -0,0 +1,204 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "tst_qversitcontactingester.h"
+#include <QtVersit/qversitcontactingester.h>
+#include <QtContacts/qcontacts.h>
+#include <QtTest/QtTest>
+#include <QBuffer>
+
+QTCONTACTS_USE_NAMESPACE
+QTVERSIT_USE_NAMESPACE
+
+QByteArray tst_QVersitContactIngester::createVCards(int count, int firstIndex)
+{
+    QByteArray input;
+    for (int i = firstIndex; i < firstIndex + count; i++) {
+        input.append("BEGIN:VCARD\r\nVERSION:3.0\r\n");
+        input.append("FN:Contact " + QByteArray::number(i) + "\r\n");
+        input.append("N:" + QByteArray::number(i) + ";Contact;;;\r\n");
+        input.append("END:VCARD\r\n");
+    }
+    return input;
+}
+
+void tst_QVersitContactIngester::testIngest_data()
+{
+    QTest::addColumn<int>("contactCount");
+    QTest::addColumn<int>("batchSize");
+    QTest::addColumn<int>("maxQueuedBatches");
+
+    QTest::newRow("one batch") << 5 << 100 << 2;
+    QTest::newRow("uneven batches") << 23 << 4 << 2;
+    QTest::newRow("single document batches") << 10 << 1 << 1;
+    QTest::newRow("empty input") << 0 << 10 << 2;
+}
+
+void tst_QVersitContactIngester::testIngest()
+{
+    QFETCH(int, contactCount);
+    QFETCH(int, batchSize);
+    QFETCH(int, maxQueuedBatches);
+
+    QByteArray input(createVCards(contactCount));
+    QBuffer buffer(&input);
+    buffer.open(QIODevice::ReadOnly);
+    QContactManager manager(QStringLiteral("memory"));
+
+    QVersitContactIngester ingester(&buffer, &manager);
+    ingester.setBatchSize(batchSize);
+    ingester.setMaxQueuedBatches(maxQueuedBatches);
+    QSignalSpy progressSpy(&ingester, SIGNAL(progress(qint64,int)));
+    QVERIFY(ingester.start());
+    QVERIFY(ingester.waitForFinished());
+    QCOMPARE(ingester.state(), QVersitContactIngester::FinishedState);
+    QCOMPARE(ingester.error(), QVersitContactIngester::NoError);
+    QCOMPARE(ingester.savedCount(), contactCount);
+    QCOMPARE(ingester.checkpoint(), qint64(input.size()));
+    QCOMPARE(manager.contactIds().size(), contactCount);
+
+    // One signal per batch, with the checkpoint only ever moving forward
+    QCOMPARE(progressSpy.count(), (contactCount + batchSize - 1) / batchSize);
+    qint64 lastCheckpoint = 0;
+    for (int i = 0; i < progressSpy.count(); i++) {
+        qint64 checkpoint = progressSpy.at(i).at(0).toLongLong();
+        QVERIFY(checkpoint > lastCheckpoint);
+        QCOMPARE(progressSpy.at(i).at(1).toInt(), qMin(contactCount, (i + 1) * batchSize));
+        lastCheckpoint = checkpoint;
+    }
+
+    QStringList labels;
+    foreach (const QContact& contact, manager.contacts())
+        labels.append(contact.detail<QContactDisplayLabel>().label());
+    for (int i = 0; i < contactCount; i++)
+        QVERIFY(labels.contains(QStringLiteral("Contact %1").arg(i)));
+}
+
+void tst_QVersitContactIngester::testResume()
+{
+    // Resuming from a checkpoint picks up exactly the contacts after it
+    QByteArray head(createVCards(6));
+    QByteArray input(head + createVCards(5, 6));
+    QBuffer buffer(&input);
+    buffer.open(QIODevice::ReadOnly);
+    QContactManager manager(QStringLiteral("memory"));
+
+    QVersitContactIngester ingester(&buffer, &manager);
+    ingester.setBatchSize(3);
+    ingester.setStartOffset(head.size());
+    QVERIFY(ingester.start());
+    QVERIFY(ingester.waitForFinished());
+    QCOMPARE(ingester.state(), QVersitContactIngester::FinishedState);
+    QCOMPARE(ingester.savedCount(), 5);
+    QCOMPARE(ingester.checkpoint(), qint64(input.size()));
+
+    QStringList labels;
+    foreach (const QContact& contact, manager.contacts())
+        labels.append(contact.detail<QContactDisplayLabel>().label());
+    labels.sort();
+    QCOMPARE(labels, QStringList() << QStringLiteral("Contact 10") << QStringLiteral("Contact 6")
+             << QStringLiteral("Contact 7") << QStringLiteral("Contact 8")
+             << QStringLiteral("Contact 9"));
+}
+
+void tst_QVersitContactIngester::testInvalidSetup()
+{
+    QContactManager manager(QStringLiteral("memory"));
+    QVersitContactIngester ingester;
+    QCOMPARE(ingester.state(), QVersitContactIngester::InactiveState);
+    QVERIFY(!ingester.waitForFinished());
+
+    // No device
+    ingester.setManager(&manager);
+    QVERIFY(!ingester.start());
+    QCOMPARE(ingester.error(), QVersitContactIngester::IOError);
+
+    // Unopened device
+    QBuffer buffer;
+    ingester.setDevice(&buffer);
+    QVERIFY(!ingester.start());
+    QCOMPARE(ingester.error(), QVersitContactIngester::IOError);
+
+    // No manager
+    buffer.open(QIODevice::ReadOnly);
+    ingester.setManager(0);
+    QVERIFY(!ingester.start());
+    QCOMPARE(ingester.error(), QVersitContactIngester::UnspecifiedError);
+
+    // Offset past the end of a random access device
+    ingester.setManager(&manager);
+    ingester.setStartOffset(10);
+    QVERIFY(ingester.start());
+    QVERIFY(ingester.waitForFinished());
+    QCOMPARE(ingester.error(), QVersitContactIngester::IOError);
+    QCOMPARE(ingester.savedCount(), 0);
+}
+
+void tst_QVersitContactIngester::testCancel()
+{
+    QByteArray input(createVCards(2000));
+    QBuffer buffer(&input);
+    buffer.open(QIODevice::ReadOnly);
+    QContactManager manager(QStringLiteral("memory"));
+
+    QVersitContactIngester ingester(&buffer, &manager);
+    ingester.setBatchSize(10);
+    QVERIFY(ingester.start());
+    ingester.cancel();
+    QVERIFY(ingester.waitForFinished());
+    QCOMPARE(ingester.state(), QVersitContactIngester::CanceledState);
+
+    // Whatever was saved before the cancellation is accounted for by the checkpoint
+    QCOMPARE(manager.contactIds().size(), ingester.savedCount());
+    QVERIFY(ingester.checkpoint() <= input.size());
+    QCOMPARE(ingester.savedCount() % 10, 0);
+}
+
+void tst_QVersitContactIngester::testSaveError()
+{
+    // A batch which fails to save ends the ingestion as if it had been canceled
+    QByteArray input(createVCards(5));
+    QBuffer buffer(&input);
+    buffer.open(QIODevice::ReadOnly);
+    QContactManager manager(QStringLiteral("invalid"));
+
+    QVersitContactIngester ingester(&buffer, &manager);
+    ingester.setBatchSize(2);
+    QSignalSpy stateSpy(&ingester, SIGNAL(stateChanged(QVersitContactIngester::State)));
+    QVERIFY(ingester.start());
+    QVERIFY(ingester.waitForFinished());
+    QCOMPARE(ingester.state(), QVersitContactIngester::CanceledState);
+    QCOMPARE(ingester.error(), QVersitContactIngester::SaveError);
+    QCOMPARE(ingester.savedCount(), 0);
+    QCOMPARE(ingester.checkpoint(), qint64(0));
+    QCOMPARE(stateSpy.count(), 2);
+    QCOMPARE(stateSpy.at(1).at(0).value<QVersitContactIngester::State>(),
+             QVersitContactIngester::CanceledState);
+}
+
+QTEST_MAIN(tst_QVersitContactIngester)
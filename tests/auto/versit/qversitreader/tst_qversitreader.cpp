@@ -159,6 +159,12 @@ void tst_QVersitReader::testValidateUtf8_data()
     QTest::newRow("16") << QByteArray("\xef\xbf\xbd") << true;
     QTest::newRow("17") << QByteArray("\xf4\x8f\xbf\xbf") << true;
     QTest::newRow("18") << QByteArray("\xf4\x90\x80\x80") << false; // outside the range
+    // Long enough to be tested a word at a time
+    QTest::newRow("ascii words") << QByteArray("Plain ASCII text, several words long") << true;
+    QTest::newRow("utf-8 after ascii words")
+            << QByteArray("Plain ASCII text, then \xce\xba\xe1\xbd\xb9\xcf\x83\xce\xbc\xce\xb5") << true;
+    QTest::newRow("invalid after ascii words")
+            << QByteArray("Plain ASCII text, then \xf8\x88\x80\x80\x80") << false;
 
     // The rest are marked as "invalid" according to the above page
     QTest::newRow("19") << QByteArray("\x80") << false;
@@ -658,6 +664,101 @@ void tst_QVersitReader::testResult()
     QCOMPARE(mReader->results().count(),0);
 }
 
+void tst_QVersitReader::testTakeResults()
+{
+    QByteArray input;
+    for (int i = 0; i < 5; i++)
+        input.append("BEGIN:VCARD\r\nVERSION:2.1\r\nFN:John " + QByteArray::number(i) + "\r\nEND:VCARD\r\n");
+    QCOMPARE(mReader->resultsLimit(), 0);
+
+    // Without a limit, all the documents are available and can be taken once
+    mReader->setData(input);
+    QVERIFY(mReader->startReading());
+    QVERIFY(mReader->waitForFinished());
+    QCOMPARE(mReader->takeResults().count(), 5);
+    QCOMPARE(mReader->results().count(), 0);
+    QCOMPARE(mReader->takeResults().count(), 0);
+
+    // With a limit, the reader waits for the results to be taken
+    mReader->setResultsLimit(2);
+    QCOMPARE(mReader->resultsLimit(), 2);
+    mReader->setData(input);
+    QVERIFY(mReader->startReading());
+    QList<QVersitDocument> taken;
+    while (!mReader->waitForFinished(10)) {
+        QVERIFY(mReader->results().count() <= 2);
+        taken.append(mReader->takeResults());
+    }
+    taken.append(mReader->takeResults());
+    QCOMPARE(mReader->state(), QVersitReader::FinishedState);
+    QCOMPARE(mReader->error(), QVersitReader::NoError);
+    QCOMPARE(taken.count(), 5);
+    for (int i = 0; i < taken.count(); i++) {
+        QCOMPARE(taken.at(i).properties().last().value(),
+                 QStringLiteral("John ") + QString::number(i));
+    }
+
+    // Canceling releases a reader that is waiting for its results to be taken
+    mReader->setResultsLimit(1);
+    mReader->setData(input);
+    QVERIFY(mReader->startReading());
+    mReader->cancel();
+    QVERIFY(mReader->waitForFinished());
+    QCOMPARE(mReader->state(), QVersitReader::CanceledState);
+    QVERIFY(mReader->takeResults().count() <= 1);
+}
+
+void tst_QVersitReader::testConcurrentReading()
+{
+    // Enough documents to be split between several threads, some with nested documents
+    QByteArray input;
+    for (int i = 0; i < 3000; i++) {
+        input.append("BEGIN:VCARD\r\nVERSION:2.1\r\nFN:John " + QByteArray::number(i) + "\r\n");
+        if (i % 7 == 0)
+            input.append("AGENT:\r\nBEGIN:VCARD\r\nFN:Agent\r\nEND:VCARD\r\n");
+        input.append("NOTE:Some text to make the document a bit longer\r\nEND:VCARD\r\n");
+    }
+
+    QCOMPARE(mReader->maxThreadCount(), 1);
+    QVERIFY(mReader->resultsOrdered());
+    mReader->setData(input);
+    QVERIFY(mReader->startReading());
+    QVERIFY(mReader->waitForFinished());
+    QList<QVersitDocument> expected(mReader->takeResults());
+    QCOMPARE(expected.count(), 3000);
+
+    // In order
+    mReader->setMaxThreadCount(4);
+    QCOMPARE(mReader->maxThreadCount(), 4);
+    mReader->setData(input);
+    QVERIFY(mReader->startReading());
+    QVERIFY(mReader->waitForFinished());
+    QCOMPARE(mReader->state(), QVersitReader::FinishedState);
+    QCOMPARE(mReader->error(), QVersitReader::NoError);
+    QCOMPARE(mReader->takeResults(), expected);
+
+    // Unordered, the same documents come back
+    mReader->setResultsOrdered(false);
+    mReader->setData(input);
+    QVERIFY(mReader->startReading());
+    QVERIFY(mReader->waitForFinished());
+    QList<QVersitDocument> results(mReader->takeResults());
+    QCOMPARE(results.count(), expected.count());
+    foreach (const QVersitDocument& document, expected)
+        QVERIFY(results.contains(document));
+
+    // Together with a results limit
+    mReader->setResultsOrdered(true);
+    mReader->setResultsLimit(100);
+    mReader->setData(input);
+    QVERIFY(mReader->startReading());
+    results.clear();
+    while (!mReader->waitForFinished(10))
+        results.append(mReader->takeResults());
+    results.append(mReader->takeResults());
+    QCOMPARE(results, expected);
+}
+
 void tst_QVersitReader::testParseNextVersitProperty()
 {
 #ifndef QT_BUILD_INTERNAL
@@ -1339,6 +1440,10 @@ void tst_QVersitReader::testDecodeQuotedPrintable_data()
             << QByteArray("This=\r\n is =\r\none line.")
             << QByteArray("This is one line.");
 
+    QTest::newRow("Soft line break before an encoded character")
+            << QByteArray("Line=\r\n=3Dbreak")
+            << QByteArray("Line=break");
+
     QTest::newRow("Characters recommended to be encoded according to RFC 1521")
             << QByteArray("To be decoded: =0A=0D=21=22=23=24=3D=40=5B=5C=5D=5E=60=7B=7C=7D=7E")
             << QByteArray("To be decoded: \n\r!\"#$=@[\\]^`{|}~");
@@ -1990,6 +2095,17 @@ void tst_QVersitReader::testReadLine_data()
                 << "one:\rtwo:\rthree:\r"
                 << (QList<QString>() << QStringLiteral("one:") << QStringLiteral("two:") << QStringLiteral("three:"));
 
+        QTest::newRow("mixed line endings " + codecName)
+                << codecName
+                << "one:\r\ntwo:\rthree:\nfour:\r\n"
+                << (QList<QString>() << QStringLiteral("one:") << QStringLiteral("two:")
+                                     << QStringLiteral("three:") << QStringLiteral("four:"));
+
+        QTest::newRow("line folded across chunks " + codecName)
+                << codecName
+                << "photo:abc\r\n def\r\n ghi\r\n\tjkl\r\n mno\r\nnext:\r\n"
+                << (QList<QString>() << QStringLiteral("photo:abcdefghijklmno") << QStringLiteral("next:"));
+
         // Tests a workaround to parse a certain malformed vCard
         QTest::newRow("badly wrapped lines " + codecName)
                 << codecName
@@ -2021,6 +2137,138 @@ void tst_QVersitReader::testByteArrayInput()
     QCOMPARE(properties.first().value(), QStringLiteral("John"));
 }
 
+void tst_QVersitReader::testInternedStrings()
+{
+    delete mReader;
+    const QByteArray twoDocuments =
+        "BEGIN:VCARD\r\nVERSION:3.0\r\nitem1.tel;type=HOME:123\r\nX-ORIGIN;X-SOURCE=sim:1\r\nEND:VCARD\r\n"
+        "BEGIN:VCARD\r\nVERSION:3.0\r\nitem1.TEL;TYPE=HOME:456\r\nX-ORIGIN;X-SOURCE=sim:2\r\nEND:VCARD\r\n";
+
+    mReader = new QVersitReader(twoDocuments);
+    QVERIFY2(mReader->startReading(), QString::number(mReader->error()).toLatin1().data());
+    QVERIFY2(mReader->waitForFinished(), QString::number(mReader->error()).toLatin1().data());
+    QList<QVersitDocument> results = mReader->results();
+    QCOMPARE(results.count(), 2);
+    QCOMPARE(results.at(0).properties().count(), 2);
+    QCOMPARE(results.at(1).properties().count(), 2);
+
+    // The names, groups and parameters of both documents share their data
+    for (int i = 0; i < 2; i++) {
+        QVersitProperty first = results.at(0).properties().at(i);
+        QVersitProperty second = results.at(1).properties().at(i);
+        QCOMPARE(first.name(), second.name());
+        QVERIFY(first.name().constData() == second.name().constData());
+        QCOMPARE(first.groups(), second.groups());
+        for (int j = 0; j < first.groups().count(); j++)
+            QVERIFY(first.groups().at(j).constData() == second.groups().at(j).constData());
+        QCOMPARE(first.parameters(), second.parameters());
+        QString key = first.parameters().constBegin().key();
+        QVERIFY(key.constData() == second.parameters().constBegin().key().constData());
+        QVERIFY(first.parameters().value(key).constData()
+                == second.parameters().value(key).constData());
+    }
+    QCOMPARE(results.at(0).properties().at(0).name(), QStringLiteral("TEL"));
+    QCOMPARE(results.at(0).properties().at(1).parameters().value(QStringLiteral("X-SOURCE")),
+             QStringLiteral("sim"));
+
+    // The strings which aren't well-known are only shared within a read
+    const QString origin = results.at(0).properties().at(1).name();
+    mReader->setData(twoDocuments);
+    QVERIFY2(mReader->startReading(), QString::number(mReader->error()).toLatin1().data());
+    QVERIFY2(mReader->waitForFinished(), QString::number(mReader->error()).toLatin1().data());
+    QList<QVersitDocument> rereadResults = mReader->results();
+    QCOMPARE(rereadResults.count(), 2);
+    QCOMPARE(rereadResults.at(0).properties().at(1).name(), origin);
+    QVERIFY(rereadResults.at(0).properties().at(1).name().constData() != origin.constData());
+
+#ifdef QT_BUILD_INTERNAL
+    QVersitStringTable table;
+    QVersitStringTable otherTable;
+    QVERIFY(table.intern(QString::fromLatin1("TEL")).constData()
+            == otherTable.intern(QString::fromLatin1("TEL")).constData());
+    QString origin = table.intern(QString::fromLatin1("X-ORIGIN"));
+    QVERIFY(table.intern(QString::fromLatin1("X-ORIGIN")).constData() == origin.constData());
+    QVERIFY(otherTable.intern(QString::fromLatin1("X-ORIGIN")).constData() != origin.constData());
+    QCOMPARE(table.decode(QByteArray("X-ORIGIN"), mAsciiCodec), origin);
+    QVERIFY(table.decode(QByteArray("X-ORIGIN"), mAsciiCodec).constData() == origin.constData());
+
+    // Clearing the table ends its session
+    table.clear();
+    QString newOrigin = QString::fromLatin1("X-ORIGIN");
+    QVERIFY(table.intern(newOrigin).constData() == newOrigin.constData());
+    QVERIFY(table.decode(QByteArray("X-ORIGIN"), mAsciiCodec).constData() == newOrigin.constData());
+#endif
+}
+
+void tst_QVersitReader::testDocumentBoundaryScanner()
+{
+#ifndef QT_BUILD_INTERNAL
+    QSKIP("Testing private API");
+#else
+    QFETCH(QByteArray, codecName);
+
+    // The top-level BEGIN lines start at 0, 30 and 77 and the END lines at 19, 67 and 89
+    const QString data(QStringLiteral(
+            "BEGIN:VCARD\r\nFN:A\r\nEND:VCARD\r\n"
+            "begin:vcard\r\nBEGIN:VCARD\r\nEND:VCARD\r\nend:vcard\n"
+            "BEGIN:VCARD\rEND:VCARD\r\n"));
+    QTextCodec* codec = QTextCodec::codecForName(codecName);
+    const QByteArray bytes(VersitUtils::encode(data.toLatin1(), codec));
+    const int unit = VersitUtils::encode('\r', codec).size();
+    const QStringList expected = QStringList()
+            << QStringLiteral("begin 0") << QStringLiteral("end 19")
+            << QStringLiteral("begin 30") << QStringLiteral("end 67")
+            << QStringLiteral("begin 77") << QStringLiteral("end 89");
+
+    // Scanning the whole input at once
+    QStringList boundaries;
+    DocumentBoundaryScanner scanner(codec);
+    while (scanner.scanLine(bytes, true)) {
+        if (scanner.lineType() == DocumentBoundaryScanner::DocumentBegin)
+            boundaries.append(QStringLiteral("begin %1").arg(scanner.lineStart() / unit));
+        else if (scanner.lineType() == DocumentBoundaryScanner::DocumentEnd)
+            boundaries.append(QStringLiteral("end %1").arg(scanner.lineStart() / unit));
+    }
+    QCOMPARE(boundaries, expected);
+    QCOMPARE(scanner.nextLineStart(), bytes.size());
+    QCOMPARE(scanner.depth(), 0);
+
+    // Scanning the input as it arrives one code unit at a time, dropping each document once it
+    // has been scanned
+    boundaries.clear();
+    DocumentBoundaryScanner incrementalScanner(codec);
+    QByteArray pending;
+    int discarded = 0;
+    for (int i = 0; i < bytes.size(); i += unit) {
+        pending.append(bytes.mid(i, unit));
+        const bool atEnd = i + unit == bytes.size();
+        while (incrementalScanner.scanLine(pending, atEnd)) {
+            const int lineStart = (discarded + incrementalScanner.lineStart()) / unit;
+            if (incrementalScanner.lineType() == DocumentBoundaryScanner::DocumentBegin) {
+                boundaries.append(QStringLiteral("begin %1").arg(lineStart));
+            } else if (incrementalScanner.lineType() == DocumentBoundaryScanner::DocumentEnd) {
+                boundaries.append(QStringLiteral("end %1").arg(lineStart));
+                const int documentEnd = incrementalScanner.nextLineStart();
+                pending.remove(0, documentEnd);
+                incrementalScanner.discard(documentEnd);
+                discarded += documentEnd;
+            }
+        }
+    }
+    QCOMPARE(boundaries, expected);
+    QVERIFY(pending.isEmpty());
+#endif
+}
+
+void tst_QVersitReader::testDocumentBoundaryScanner_data()
+{
+    QTest::addColumn<QByteArray>("codecName");
+
+    QTest::newRow("UTF-8") << QByteArray("UTF-8");
+    QTest::newRow("UTF-16BE") << QByteArray("UTF-16BE");
+    QTest::newRow("UTF-32LE") << QByteArray("UTF-32LE");
+}
+
 void tst_QVersitReader::testRemoveBackSlashEscaping()
 {
 #ifndef QT_BUILD_INTERNAL
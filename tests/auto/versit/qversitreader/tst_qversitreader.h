@@ -76,6 +76,8 @@ private slots: // Tests
     void testDetectCodec_data();
     void testReading();
     void testResult();
+    void testTakeResults();
+    void testConcurrentReading();
     void testParseNextVersitProperty();
     void testParseNextVersitProperty_data();
     void testParseVersitDocument();
@@ -93,6 +95,9 @@ private slots: // Tests
     void testReadLine();
     void testReadLine_data();
     void testByteArrayInput();
+    void testInternedStrings();
+    void testDocumentBoundaryScanner();
+    void testDocumentBoundaryScanner_data();
     void testRemoveBackSlashEscaping();
 
 private: // Data
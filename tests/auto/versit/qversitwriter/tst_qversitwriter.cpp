@@ -261,6 +261,78 @@ void tst_QVersitWriter::testByteArrayOutput()
     QCOMPARE(output, vCard30);
 }
 
+void tst_QVersitWriter::testIncrementalWriting()
+{
+    const QByteArray iCalendar(
+        "BEGIN:VCALENDAR\r\n"
+        "VERSION:2.0\r\n"
+        "BEGIN:VEVENT\r\n"
+        "SUMMARY:first\r\n"
+        "END:VEVENT\r\n"
+        "BEGIN:VEVENT\r\n"
+        "SUMMARY:second\r\n"
+        "END:VEVENT\r\n"
+        "END:VCALENDAR\r\n");
+
+    // Not started
+    QVERIFY(!mWriter->writeSubDocuments(QList<QVersitDocument>()));
+    QCOMPARE(mWriter->error(), QVersitWriter::NotReadyError);
+    QVERIFY(!mWriter->endDocument());
+
+    mOutputDevice->open(QBuffer::ReadWrite);
+    mWriter->setDevice(mOutputDevice);
+    QVersitDocument calendar(QVersitDocument::ICalendar20Type);
+    calendar.setComponentType(QStringLiteral("VCALENDAR"));
+    QVERIFY(mWriter->beginDocument(calendar));
+    QCOMPARE(mWriter->state(), QVersitWriter::ActiveState);
+    QVERIFY(!mWriter->startWriting(calendar));
+    QCOMPARE(mWriter->error(), QVersitWriter::NotReadyError);
+
+    // The beginning of the document is available before the document is finished
+    QCOMPARE(mOutputDevice->data(), QByteArray("BEGIN:VCALENDAR\r\nVERSION:2.0\r\n"));
+
+    foreach (const QString& summary, QStringList() << QStringLiteral("first") << QStringLiteral("second")) {
+        QVersitDocument event(QVersitDocument::ICalendar20Type);
+        event.setComponentType(QStringLiteral("VEVENT"));
+        QVersitProperty property;
+        property.setName(QStringLiteral("SUMMARY"));
+        property.setValue(summary);
+        event.addProperty(property);
+        QVERIFY(mWriter->writeSubDocuments(QList<QVersitDocument>() << event));
+    }
+    QVERIFY(mWriter->endDocument());
+    QCOMPARE(mWriter->state(), QVersitWriter::FinishedState);
+    QCOMPARE(mWriter->error(), QVersitWriter::NoError);
+    QCOMPARE(mOutputDevice->data(), iCalendar);
+}
+
+void tst_QVersitWriter::testIncrementalWritingFailure()
+{
+    QVersitDocument calendar(QVersitDocument::ICalendar20Type);
+    calendar.setComponentType(QStringLiteral("VCALENDAR"));
+
+    // Writing the beginning of the document fails
+    FailingBuffer failingDevice;
+    failingDevice.open(QBuffer::ReadWrite);
+    mWriter->setDevice(&failingDevice);
+    QVERIFY(!mWriter->beginDocument(calendar));
+    QCOMPARE(mWriter->error(), QVersitWriter::IOError);
+    QCOMPARE(mWriter->state(), QVersitWriter::FinishedState);
+    QVERIFY(!mWriter->writeSubDocuments(QList<QVersitDocument>()));
+    QCOMPARE(mWriter->error(), QVersitWriter::NotReadyError);
+    QVERIFY(!mWriter->endDocument());
+
+    // The writer can be used again
+    mOutputDevice->open(QBuffer::ReadWrite);
+    mWriter->setDevice(mOutputDevice);
+    QVERIFY(mWriter->beginDocument(calendar));
+    QCOMPARE(mWriter->state(), QVersitWriter::ActiveState);
+    QCOMPARE(mWriter->error(), QVersitWriter::NoError);
+    QVERIFY(mWriter->endDocument());
+    QCOMPARE(mWriter->state(), QVersitWriter::FinishedState);
+    QCOMPARE(mOutputDevice->data(), QByteArray("BEGIN:VCALENDAR\r\nVERSION:2.0\r\nEND:VCALENDAR\r\n"));
+}
+
 void tst_QVersitWriter::testWritingDocument()
 {
     QFETCH(QVersitDocument, document);
@@ -438,4 +510,46 @@ void tst_QVersitWriter::testWritingDocument_data()
     }
 }
 
+void tst_QVersitWriter::testUtf8Folding()
+{
+    QFETCH(int, prefixLength);
+    QFETCH(QByteArray, expected);
+
+    // A character outside the BMP, written as a surrogate pair
+    const QString face(QString::fromUcs4(U"\U0001F600", 1));
+    QVersitDocument document(QVersitDocument::VCard30Type);
+    document.setComponentType(QStringLiteral("VCARD"));
+    QVersitProperty property;
+    property.setName(QStringLiteral("FN"));
+    property.setValue(QString(prefixLength, QLatin1Char('A')) + face + QLatin1Char('B'));
+    document.addProperty(property);
+
+    mOutputDevice->open(QBuffer::ReadWrite);
+    mWriter->setDevice(mOutputDevice);
+    mWriter->setDefaultCodec(QTextCodec::codecForName("UTF-8"));
+    QVERIFY2(mWriter->startWriting(document), QString::number(mWriter->error()).toLatin1().data());
+    QVERIFY2(mWriter->waitForFinished(), QString::number(mWriter->error()).toLatin1().data());
+    mOutputDevice->seek(0);
+    QByteArray result(mOutputDevice->readAll());
+    QCOMPARE(result, QByteArray("BEGIN:VCARD\r\nVERSION:3.0\r\n") + expected + "END:VCARD\r\n");
+}
+
+void tst_QVersitWriter::testUtf8Folding_data()
+{
+    QTest::addColumn<int>("prefixLength");
+    QTest::addColumn<QByteArray>("expected");
+
+    // "FN:" leaves room for 73 characters on the first line
+    const QByteArray utf8Face("\xF0\x9F\x98\x80");
+    QTest::newRow("pair before the fold") << 71 << QByteArray(
+            "FN:" + QByteArray(71, 'A') + utf8Face + "\r\n"
+            " B\r\n");
+    QTest::newRow("pair across the fold") << 72 << QByteArray(
+            "FN:" + QByteArray(72, 'A') + "\r\n"
+            " " + utf8Face + "B\r\n");
+    QTest::newRow("pair after the fold") << 73 << QByteArray(
+            "FN:" + QByteArray(73, 'A') + "\r\n"
+            " " + utf8Face + "B\r\n");
+}
+
 QTEST_MAIN(tst_QVersitWriter)
@@ -52,6 +52,17 @@ public:
     QList<QVersitWriter::State> mReceived;
 };
 
+// A device which accepts no data, as if the disk was full.
+class FailingBuffer : public QBuffer
+{
+protected:
+    qint64 writeData(const char *data, qint64 len) {
+        Q_UNUSED(data);
+        Q_UNUSED(len);
+        return -1;
+    }
+};
+
 class tst_QVersitWriter : public QObject
 {
      Q_OBJECT
@@ -67,8 +78,12 @@ private slots: // Tests
     void testWriting21();
     void testWriting30();
     void testByteArrayOutput();
+    void testIncrementalWriting();
+    void testIncrementalWritingFailure();
     void testWritingDocument();
     void testWritingDocument_data();
+    void testUtf8Folding();
+    void testUtf8Folding_data();
 
 private: // Data
     QVersitWriter* mWriter;
@@ -5,6 +5,7 @@ SUBDIRS += \
     qvcard30writer \
     qversitcontactexporter \
     qversitcontactimporter \
+    qversitcontactingester \
     qversitcontactplugins \
     qversitdocument \
     qversitproperty \
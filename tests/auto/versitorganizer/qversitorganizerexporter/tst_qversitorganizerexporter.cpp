@@ -188,6 +188,61 @@ void tst_QVersitOrganizerExporter::testExportError_data()
         << (int)QVersitOrganizerExporter::UnderspecifiedOccurrenceError;
 }
 
+void tst_QVersitOrganizerExporter::testExportFromManager()
+{
+    QOrganizerManager manager(QStringLiteral("memory"));
+    QList<QOrganizerItem> items;
+    for (int i = 0; i < 5; i++) {
+        QOrganizerEvent event;
+        event.setDisplayLabel(QStringLiteral("Event %1").arg(i));
+        event.setStartDateTime(QDateTime(QDate(2010, 12, 10 + i), QTime(9, 0), Qt::UTC));
+        event.setEndDateTime(QDateTime(QDate(2010, 12, 10 + i), QTime(10, 0), Qt::UTC));
+        items.append(event);
+    }
+    QOrganizerTodo todo;
+    todo.setDisplayLabel(QStringLiteral("Todo"));
+    items.append(todo);
+    QVERIFY(manager.saveItems(&items));
+
+    // A page size which does not divide the number of items
+    QByteArray output;
+    QVersitWriter writer(&output);
+    QVersitOrganizerExporter exporter;
+    QVERIFY(exporter.exportItems(&manager, &writer, QOrganizerItemFilter(), 4));
+    QVERIFY(exporter.errorMap().isEmpty());
+    QCOMPARE(writer.state(), QVersitWriter::FinishedState);
+    QVERIFY(exporter.document().subDocuments().isEmpty());
+
+    QVersitReader reader(output);
+    QVERIFY(reader.startReading());
+    QVERIFY(reader.waitForFinished());
+    QCOMPARE(reader.results().size(), 1);
+    QVersitDocument calendar = reader.results().first();
+    QCOMPARE(calendar.componentType(), QStringLiteral("VCALENDAR"));
+    QCOMPARE(calendar.subDocuments().size(), items.size());
+
+    QStringList summaries;
+    foreach (const QVersitDocument& component, calendar.subDocuments()) {
+        foreach (const QVersitProperty& property, component.properties()) {
+            if (property.name() == QStringLiteral("SUMMARY"))
+                summaries.append(property.value());
+        }
+    }
+    summaries.sort();
+    QStringList expectedSummaries;
+    foreach (const QOrganizerItem& item, items)
+        expectedSummaries.append(item.displayLabel());
+    expectedSummaries.sort();
+    QCOMPARE(summaries, expectedSummaries);
+
+    // Nothing to export from or to
+    QVERIFY(!exporter.exportItems(0, &writer));
+    QCOMPARE(exporter.errorMap().size(), 1);
+    QCOMPARE(exporter.errorMap().value(-1), QVersitOrganizerExporter::UnspecifiedError);
+    QVERIFY(!exporter.exportItems(&manager, 0));
+    QCOMPARE(exporter.errorMap().value(-1), QVersitOrganizerExporter::UnspecifiedError);
+}
+
 void tst_QVersitOrganizerExporter::testExportEventDetails()
 {
     QFETCH(QList<QOrganizerItemDetail>, details);
@@ -33,6 +33,8 @@
 #include <QtVersitOrganizer/qversitorganizerexporter.h>
 #include <QtVersit/qversitdocument.h>
 #include <QtVersit/qversitproperty.h>
+#include <QtVersit/qversitreader.h>
+#include <QtVersit/qversitwriter.h>
 #include <QtOrganizer/qorganizer.h>
 
 QTORGANIZER_USE_NAMESPACE
@@ -50,6 +52,8 @@ private slots:
     void testExportError();
     void testExportError_data();
 
+    void testExportFromManager();
+
     void testExportEventDetails();
     void testExportEventDetails_data();
 
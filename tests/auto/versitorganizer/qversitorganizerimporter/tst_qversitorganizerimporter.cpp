@@ -2044,6 +2044,14 @@ void tst_QVersitOrganizerImporter::testTimeZones_data()
         QTest::newRow("dst") << QString::fromLatin1("Australia/Sydney")
             << vtimezone << QString::fromLatin1("20100102T100405")
             << QDateTime(QDate(2010, 1, 1), QTime(23, 4, 5), Qt::UTC);
+
+        QTest::newRow("dst, far from the start of the phases") << QString::fromLatin1("Australia/Sydney")
+            << vtimezone << QString::fromLatin1("21100102T100405")
+            << QDateTime(QDate(2110, 1, 1), QTime(23, 4, 5), Qt::UTC);
+
+        QTest::newRow("before the start of the phases") << QString::fromLatin1("Australia/Sydney")
+            << vtimezone << QString::fromLatin1("19600102T100405")
+            << QDateTime(QDate(1960, 1, 1), QTime(23, 4, 5), Qt::UTC);
     }
 
     {
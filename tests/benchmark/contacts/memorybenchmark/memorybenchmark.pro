@@ -0,0 +1,5 @@
+TEMPLATE = app
+CONFIG += testcase release
+TARGET = tst_memorybenchmark
+QT += contacts testlib
+SOURCES  += tst_memorybenchmark.cpp
@@ -0,0 +1,247 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include <QtContacts/QContactManager>
+#include <QtContacts/qcontactdetails.h>
+#include <QtContacts/qcontactdetailfilter.h>
+
+//TESTED_COMPONENT=src/plugins/contacts/memory
+
+QTCONTACTS_USE_NAMESPACE
+
+namespace {
+    QList<QContact> generateContacts(int howMany)
+    {
+        QList<QContact> retn;
+        retn.reserve(howMany);
+        for (int i = 0; i < howMany; ++i) {
+            QContact c;
+            QContactName name;
+            name.setFirstName(QStringLiteral("First%1").arg(i));
+            name.setLastName(QStringLiteral("Last%1").arg(howMany - i));
+            c.saveDetail(&name);
+            QContactPhoneNumber phn;
+            phn.setNumber(QString::number(5550000 + i));
+            c.saveDetail(&phn);
+            retn.append(c);
+        }
+        return retn;
+    }
+
+    QContactManager *createPopulatedManager(int howMany, QList<QContact> *saved,
+                                            const QMap<QString, QString> &parameters = QMap<QString, QString>())
+    {
+        QContactManager *manager = new QContactManager(QStringLiteral("memory"), parameters);
+        *saved = generateContacts(howMany);
+        manager->saveContacts(saved);
+        return manager;
+    }
+}
+
+//---------------------------------------------
+
+class tst_memorybenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_memorybenchmark() {}
+    ~tst_memorybenchmark() {}
+
+private slots:
+    void fetchById_data();
+    void fetchById();
+    void updateContacts_data();
+    void updateContacts();
+    void removeContacts_data();
+    void removeContacts();
+    void phoneNumberFiltering_data();
+    void phoneNumberFiltering();
+    void sortedFetch_data();
+    void sortedFetch();
+
+private:
+    void addStoreSizes();
+};
+
+void tst_memorybenchmark::addStoreSizes()
+{
+    QTest::addColumn<int>("storeSize");
+
+    // the time per operation should stay flat as the store grows.
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("100000") << 100000;
+}
+
+void tst_memorybenchmark::fetchById_data()
+{
+    addStoreSizes();
+}
+
+void tst_memorybenchmark::fetchById()
+{
+    QFETCH(int, storeSize);
+    QList<QContact> saved;
+    QScopedPointer<QContactManager> manager(createPopulatedManager(storeSize, &saved));
+
+    // fetch a fixed number of contacts so that results are comparable between rows.
+    static const int lookups = 1000;
+    QBENCHMARK {
+        for (int i = 0; i < lookups; ++i)
+            manager->contact(saved.at((i * 7919) % storeSize).id());
+    }
+}
+
+void tst_memorybenchmark::updateContacts_data()
+{
+    addStoreSizes();
+}
+
+void tst_memorybenchmark::updateContacts()
+{
+    QFETCH(int, storeSize);
+    QList<QContact> saved;
+    QScopedPointer<QContactManager> manager(createPopulatedManager(storeSize, &saved));
+
+    // update the last tenth of the store in one batch.
+    QList<QContact> toUpdate = saved.mid(storeSize - storeSize / 10);
+    for (int i = 0; i < toUpdate.size(); ++i) {
+        QContactNickname nick;
+        nick.setNickname(QStringLiteral("Nick%1").arg(i));
+        toUpdate[i].saveDetail(&nick);
+    }
+
+    QBENCHMARK {
+        QVERIFY(manager->saveContacts(&toUpdate));
+    }
+}
+
+void tst_memorybenchmark::removeContacts_data()
+{
+    QTest::addColumn<int>("storeSize");
+    QTest::addColumn<bool>("randomOrder");
+
+    // the time per removal should stay flat as the store grows, wherever
+    // the removed contacts are.
+    QTest::newRow("1000, front") << 1000 << false;
+    QTest::newRow("1000, random") << 1000 << true;
+    QTest::newRow("10000, front") << 10000 << false;
+    QTest::newRow("10000, random") << 10000 << true;
+    QTest::newRow("100000, front") << 100000 << false;
+    QTest::newRow("100000, random") << 100000 << true;
+}
+
+void tst_memorybenchmark::removeContacts()
+{
+    QFETCH(int, storeSize);
+    QFETCH(bool, randomOrder);
+    QList<QContact> saved;
+    QScopedPointer<QContactManager> manager(createPopulatedManager(storeSize, &saved));
+
+    // remove a tenth of the store, either from the front or picked at random
+    // with a fixed seed; removal can't be repeated on the same data, so it is
+    // measured once.
+    QList<QContactId> ids;
+    for (int i = 0; i < storeSize; ++i)
+        ids.append(saved.at(i).id());
+    if (randomOrder)
+        std::shuffle(ids.begin(), ids.end(), QRandomGenerator(storeSize));
+    ids = ids.mid(0, storeSize / 10);
+
+    QBENCHMARK_ONCE {
+        QVERIFY(manager->removeContacts(ids));
+    }
+    QCOMPARE(manager->contactIds().size(), storeSize - ids.size());
+}
+
+void tst_memorybenchmark::phoneNumberFiltering_data()
+{
+    QTest::addColumn<int>("storeSize");
+    QTest::addColumn<bool>("indexed");
+
+    QTest::newRow("10000") << 10000 << false;
+    QTest::newRow("10000, indexed") << 10000 << true;
+    QTest::newRow("200000") << 200000 << false;
+    QTest::newRow("200000, indexed") << 200000 << true;
+}
+
+void tst_memorybenchmark::phoneNumberFiltering()
+{
+    QFETCH(int, storeSize);
+    QFETCH(bool, indexed);
+
+    QMap<QString, QString> parameters;
+    if (indexed) {
+        parameters.insert(QStringLiteral("fieldIndexes"), QString::fromLatin1("%1:%2")
+                .arg(QContactPhoneNumber::Type).arg(QContactPhoneNumber::FieldNumber));
+    }
+    QList<QContact> saved;
+    QScopedPointer<QContactManager> manager(createPopulatedManager(storeSize, &saved, parameters));
+
+    // a caller-id style lookup
+    QContactDetailFilter filter;
+    filter.setDetailType(QContactPhoneNumber::Type, QContactPhoneNumber::FieldNumber);
+    filter.setMatchFlags(QContactFilter::MatchPhoneNumber);
+    filter.setValue(QString::fromLatin1("+1 (555) %1").arg(5550000 + storeSize / 2));
+
+    QBENCHMARK {
+        QCOMPARE(manager->contactIds(filter).size(), 1);
+    }
+}
+
+void tst_memorybenchmark::sortedFetch_data()
+{
+    QTest::addColumn<int>("storeSize");
+
+    QTest::newRow("5000") << 5000;
+    QTest::newRow("50000") << 50000;
+}
+
+void tst_memorybenchmark::sortedFetch()
+{
+    QFETCH(int, storeSize);
+    QList<QContact> saved;
+    QScopedPointer<QContactManager> manager(createPopulatedManager(storeSize, &saved));
+
+    QList<QContactSortOrder> sortOrders;
+    QContactSortOrder sortOrder;
+    sortOrder.setDetailType(QContactName::Type, QContactName::FieldLastName);
+    sortOrders.append(sortOrder);
+    sortOrder.setDetailType(QContactName::Type, QContactName::FieldFirstName);
+    sortOrders.append(sortOrder);
+
+    QBENCHMARK {
+        QCOMPARE(manager->contacts(sortOrders).size(), storeSize);
+    }
+}
+
+QTEST_MAIN(tst_memorybenchmark)
+#include "tst_memorybenchmark.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = app
+CONFIG += testcase release
+TARGET = tst_recurrencebenchmark
+QT += organizer testlib
+SOURCES  += tst_recurrencebenchmark.cpp
@@ -0,0 +1,178 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtOrganizer/qorganizermanagerengine.h>
+#include <QtOrganizer/qorganizerrecurrencerule.h>
+
+//TESTED_COMPONENT=src/organizer
+
+QTORGANIZER_USE_NAMESPACE
+
+namespace {
+    // The implementation of QOrganizerManagerEngine::matchingDates() which tests every
+    // date of the period, as a reference for the results and the timings.
+    QList<QDate> dayByDayMatchingDates(const QDate &periodStart, const QDate &periodEnd, const QOrganizerRecurrenceRule &rrule)
+    {
+        QList<QDate> retn;
+
+        QSet<Qt::DayOfWeek> daysOfWeek = rrule.daysOfWeek();
+        QSet<int> daysOfMonth = rrule.daysOfMonth();
+        QSet<int> daysOfYear = rrule.daysOfYear();
+        QSet<int> weeksOfYear = rrule.weeksOfYear();
+        QSet<QOrganizerRecurrenceRule::Month> monthsOfYear = rrule.monthsOfYear();
+
+        QDate tempDate = periodStart;
+        while (tempDate <= periodEnd) {
+            if ((monthsOfYear.isEmpty() || monthsOfYear.contains(static_cast<QOrganizerRecurrenceRule::Month>(tempDate.month())))
+                    && (weeksOfYear.isEmpty() || weeksOfYear.contains(tempDate.weekNumber()))
+                    && (daysOfYear.isEmpty() || daysOfYear.contains(tempDate.dayOfYear()))
+                    && (daysOfMonth.isEmpty() || daysOfMonth.contains(tempDate.day()))
+                    && (daysOfWeek.isEmpty() || daysOfWeek.contains(static_cast<Qt::DayOfWeek>(tempDate.dayOfWeek())))) {
+                retn.append(tempDate);
+            }
+            tempDate = tempDate.addDays(1);
+        }
+        return retn;
+    }
+}
+
+//---------------------------------------------
+
+class tst_recurrencebenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_recurrencebenchmark() {}
+    ~tst_recurrencebenchmark() {}
+
+private slots:
+    void matchingDates_data();
+    void matchingDates();
+    void generateDateTimes_data();
+    void generateDateTimes();
+};
+
+void tst_recurrencebenchmark::matchingDates_data()
+{
+    QTest::addColumn<QOrganizerRecurrenceRule>("rule");
+    QTest::addColumn<bool>("dayByDay");
+
+    // yearly rules, matched over a ten year window.
+    QOrganizerRecurrenceRule birthday;
+    birthday.setFrequency(QOrganizerRecurrenceRule::Yearly);
+    birthday.setMonthsOfYear(QSet<QOrganizerRecurrenceRule::Month>() << QOrganizerRecurrenceRule::May);
+    birthday.setDaysOfMonth(QSet<int>() << 17);
+
+    QOrganizerRecurrenceRule lastWeekdays;
+    lastWeekdays.setFrequency(QOrganizerRecurrenceRule::Yearly);
+    lastWeekdays.setWeeksOfYear(QSet<int>() << 1 << 52 << 53);
+    lastWeekdays.setDaysOfWeek(QSet<Qt::DayOfWeek>() << Qt::Monday << Qt::Friday);
+
+    QOrganizerRecurrenceRule daysOfYear;
+    daysOfYear.setFrequency(QOrganizerRecurrenceRule::Yearly);
+    daysOfYear.setDaysOfYear(QSet<int>() << 1 << 100 << 200 << 366);
+
+    QOrganizerRecurrenceRule tuesdays;
+    tuesdays.setFrequency(QOrganizerRecurrenceRule::Yearly);
+    tuesdays.setMonthsOfYear(QSet<QOrganizerRecurrenceRule::Month>() << QOrganizerRecurrenceRule::March);
+    tuesdays.setDaysOfWeek(QSet<Qt::DayOfWeek>() << Qt::Tuesday);
+
+    QTest::newRow("month and day") << birthday << false;
+    QTest::newRow("month and day, day by day") << birthday << true;
+    QTest::newRow("weeks and days of week") << lastWeekdays << false;
+    QTest::newRow("weeks and days of week, day by day") << lastWeekdays << true;
+    QTest::newRow("days of year") << daysOfYear << false;
+    QTest::newRow("days of year, day by day") << daysOfYear << true;
+    QTest::newRow("month and days of week") << tuesdays << false;
+    QTest::newRow("month and days of week, day by day") << tuesdays << true;
+}
+
+void tst_recurrencebenchmark::matchingDates()
+{
+    QFETCH(QOrganizerRecurrenceRule, rule);
+    QFETCH(bool, dayByDay);
+
+    const QDate start(2020, 1, 1);
+    const QDate end(2029, 12, 31);
+
+    // the expansion has to match the reference exactly.
+    QCOMPARE(QOrganizerManagerEngine::matchingDates(start, end, rule), dayByDayMatchingDates(start, end, rule));
+
+    if (dayByDay) {
+        QBENCHMARK {
+            dayByDayMatchingDates(start, end, rule);
+        }
+    } else {
+        QBENCHMARK {
+            QOrganizerManagerEngine::matchingDates(start, end, rule);
+        }
+    }
+}
+
+void tst_recurrencebenchmark::generateDateTimes_data()
+{
+    QTest::addColumn<QOrganizerRecurrenceRule>("rule");
+    QTest::addColumn<int>("expectedCount");
+
+    // series started long before the requested month, which is what makes the difference.
+    QOrganizerRecurrenceRule biweekly;
+    biweekly.setFrequency(QOrganizerRecurrenceRule::Weekly);
+    biweekly.setInterval(2);
+
+    QOrganizerRecurrenceRule monthly;
+    monthly.setFrequency(QOrganizerRecurrenceRule::Monthly);
+
+    QOrganizerRecurrenceRule yearly;
+    yearly.setFrequency(QOrganizerRecurrenceRule::Yearly);
+
+    QTest::newRow("every other week") << biweekly << 2;
+    QTest::newRow("monthly") << monthly << 1;
+    QTest::newRow("yearly") << yearly << 1;
+}
+
+void tst_recurrencebenchmark::generateDateTimes()
+{
+    QFETCH(QOrganizerRecurrenceRule, rule);
+    QFETCH(int, expectedCount);
+
+    const QDateTime initial(QDate(2000, 3, 6), QTime(9, 0, 0));
+    const QDateTime monthStart(QDate(2030, 3, 1), QTime(0, 0, 0));
+    const QDateTime monthEnd(QDate(2030, 3, 31), QTime(23, 59, 59));
+
+    QList<QDateTime> dates;
+    QBENCHMARK {
+        dates = QOrganizerManagerEngine::generateDateTimes(initial, rule, monthStart, monthEnd, -1);
+    }
+    QCOMPARE(dates.size(), expectedCount);
+}
+
+QTEST_MAIN(tst_recurrencebenchmark)
+#include "tst_recurrencebenchmark.moc"
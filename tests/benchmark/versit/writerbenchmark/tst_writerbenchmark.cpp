@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+
+#include <QtTest/QtTest>
+#include <QtVersit/qversitdocument.h>
+#include <QtVersit/qversitproperty.h>
+#include <QtVersit/qversitwriter.h>
+#include <QTextCodec>
+
+//TESTED_COMPONENT=src/versit
+
+QTVERSIT_USE_NAMESPACE
+
+namespace {
+    QVersitProperty property(const QString &name, const QVariant &value,
+                             QVersitProperty::ValueType valueType = QVersitProperty::PlainType)
+    {
+        QVersitProperty property;
+        property.setName(name);
+        property.setValue(value);
+        property.setValueType(valueType);
+        return property;
+    }
+
+    // A contact with the kind of properties found in an address book export: a compound name,
+    // typed phone numbers and addresses, and a note long enough to be folded.
+    QVersitDocument contact(QVersitDocument::VersitType type, int i)
+    {
+        QVersitDocument document(type);
+        document.setComponentType(QStringLiteral("VCARD"));
+        document.addProperty(property(QStringLiteral("N"),
+                QStringList() << QStringLiteral("Contact%1").arg(i) << QStringLiteral("Jürgen")
+                              << QString() << QString() << QString(),
+                QVersitProperty::CompoundType));
+        document.addProperty(property(QStringLiteral("FN"), QStringLiteral("Jürgen Contact%1").arg(i)));
+        QVersitProperty tel = property(QStringLiteral("TEL"), QStringLiteral("+358 40 %1").arg(i, 7, 10, QLatin1Char('0')));
+        tel.insertParameter(QStringLiteral("TYPE"), QStringLiteral("CELL"));
+        document.addProperty(tel);
+        tel.setValue(QStringLiteral("+358 9 %1").arg(i, 7, 10, QLatin1Char('0')));
+        tel.insertParameter(QStringLiteral("TYPE"), QStringLiteral("HOME"));
+        document.addProperty(tel);
+        document.addProperty(property(QStringLiteral("EMAIL"), QStringLiteral("contact%1@example.com").arg(i)));
+        QVersitProperty adr = property(QStringLiteral("ADR"),
+                QStringList() << QString() << QString() << QStringLiteral("Street %1; Building B").arg(i)
+                              << QStringLiteral("Helsinki") << QString() << QStringLiteral("00100")
+                              << QStringLiteral("Finland"),
+                QVersitProperty::CompoundType);
+        adr.insertParameter(QStringLiteral("TYPE"), QStringLiteral("WORK"));
+        document.addProperty(adr);
+        document.addProperty(property(QStringLiteral("NOTE"),
+                QStringLiteral("Met at the conference, interested in the follow-up meeting, "
+                               "prefers e-mail over phone calls.\nSecond line, with a comma.")));
+        return document;
+    }
+}
+
+//---------------------------------------------
+
+class tst_writerbenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_writerbenchmark() {}
+    ~tst_writerbenchmark() {}
+
+private slots:
+    void writeContacts_data();
+    void writeContacts();
+};
+
+void tst_writerbenchmark::writeContacts_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QByteArray>("codec");
+
+    QTest::newRow("vCard 2.1") << int(QVersitDocument::VCard21Type) << QByteArray();
+    QTest::newRow("vCard 3.0") << int(QVersitDocument::VCard30Type) << QByteArray();
+    QTest::newRow("vCard 3.0, UTF-16") << int(QVersitDocument::VCard30Type) << QByteArray("UTF-16");
+}
+
+void tst_writerbenchmark::writeContacts()
+{
+    QFETCH(int, type);
+    QFETCH(QByteArray, codec);
+
+    const int contactCount = 100000;
+    QList<QVersitDocument> documents;
+    documents.reserve(contactCount);
+    for (int i = 0; i < contactCount; i++)
+        documents.append(contact(QVersitDocument::VersitType(type), i));
+
+    // Timed by hand to report the throughput, which QBENCHMARK can't measure
+    QByteArray output;
+    QBuffer buffer(&output);
+    buffer.open(QIODevice::WriteOnly);
+    QVersitWriter writer(&buffer);
+    if (!codec.isEmpty())
+        writer.setDefaultCodec(QTextCodec::codecForName(codec));
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(writer.startWriting(documents));
+    QVERIFY(writer.waitForFinished());
+    const qint64 elapsed = qMax(qint64(1), timer.nsecsElapsed());
+    QCOMPARE(writer.error(), QVersitWriter::NoError);
+
+    QVERIFY(!output.isEmpty());
+    QTest::setBenchmarkResult(output.size() * 1e9 / elapsed, QTest::BytesPerSecond);
+}
+
+QTEST_MAIN(tst_writerbenchmark)
+#include "tst_writerbenchmark.moc"
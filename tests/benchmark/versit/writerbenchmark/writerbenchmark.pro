@@ -0,0 +1,5 @@
+TEMPLATE = app
+CONFIG += testcase release
+TARGET = tst_writerbenchmark
+QT += versit core5compat testlib
+SOURCES  += tst_writerbenchmark.cpp